@@ -0,0 +1,181 @@
+#include "AccuracyHarness.h"
+#include "simulation/Circuit.h"
+#include "simulation/CircuitSimulator.h"
+#include "simulation/Node.h"
+#include "core/ElectricalComponent.h"
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <memory>
+#include <cmath>
+
+AccuracyHarness::AccuracyHarness()
+    : m_voltageTolerance(1e-6)
+    , m_currentTolerance(1e-9)
+    , m_relativeTolerance(1e-6)
+{
+}
+
+void AccuracyHarness::addCase(const AccuracyCase &accuracyCase)
+{
+    m_cases.append(accuracyCase);
+}
+
+bool AccuracyHarness::run()
+{
+    QTextStream out(stdout);
+    m_results.clear();
+    bool allPassed = true;
+
+    for (const AccuracyCase &accuracyCase : m_cases) {
+        if (!m_filter.isEmpty() && !accuracyCase.name.contains(m_filter)) {
+            continue;
+        }
+
+        AccuracyResult result = runCase(accuracyCase);
+        m_results.append(result);
+        allPassed = allPassed && result.passed;
+
+        QString params = QString::fromUtf8(QJsonDocument(result.params).toJson(QJsonDocument::Compact));
+        out << QString("%1 %2").arg(result.name, -40).arg(params, -24)
+            << QString("  %1  max dV %2  max dI %3  speedup %4x")
+                   .arg(result.passed ? "PASS" : "FAIL")
+                   .arg(result.maxVoltageError, 0, 'e', 2)
+                   .arg(result.maxCurrentError, 0, 'e', 2)
+                   .arg(result.speedup, 0, 'f', 1)
+            << "\n";
+        out.flush();
+    }
+
+    return allPassed;
+}
+
+bool AccuracyHarness::withinTolerance(double production, double reference, double absolute) const
+{
+    return std::abs(production - reference) <= absolute + m_relativeTolerance * std::abs(reference);
+}
+
+AccuracyResult AccuracyHarness::runCase(const AccuracyCase &accuracyCase)
+{
+    AccuracyResult result;
+    result.name = accuracyCase.name;
+    result.params = accuracyCase.params;
+    result.passed = false;
+    result.steps = 0;
+    result.nodes = 0;
+    result.components = 0;
+    result.mismatches = 0;
+    result.maxVoltageError = 0.0;
+    result.maxCurrentError = 0.0;
+    result.productionIterations = 0;
+    result.referenceIterations = 0;
+    result.productionNs = 0;
+    result.referenceNs = 0;
+    result.speedup = 0.0;
+
+    std::unique_ptr<Circuit> production(new Circuit());
+    std::unique_ptr<Circuit> reference(new Circuit());
+    if (!accuracyCase.build(production.get()) || !accuracyCase.build(reference.get())) {
+        return result;
+    }
+
+    const QVector<Node*> &productionNodes = production->getNodes();
+    const QVector<Node*> &referenceNodes = reference->getNodes();
+    const QVector<Component*> &productionComponents = production->getComponents();
+    const QVector<Component*> &referenceComponents = reference->getComponents();
+    if (productionNodes.size() != referenceNodes.size() ||
+        productionComponents.size() != referenceComponents.size()) {
+        QTextStream(stdout) << accuracyCase.name << ": builder is not deterministic\n";
+        return result;
+    }
+    result.nodes = productionNodes.size();
+    result.components = productionComponents.size();
+
+    CircuitSimulator *productionSimulator = new CircuitSimulator(production.get(), production.get());
+    CircuitSimulator *referenceSimulator = new CircuitSimulator(reference.get(), reference.get());
+    referenceSimulator->setReferenceMode(true);
+
+    QElapsedTimer timer;
+    bool solved = true;
+
+    for (int step = 0; step < accuracyCase.steps && solved; ++step) {
+        timer.start();
+        solved = productionSimulator->solve();
+        result.productionNs += timer.nsecsElapsed();
+        result.productionIterations += productionSimulator->getIterationCount();
+
+        timer.start();
+        solved = referenceSimulator->solve() && solved;
+        result.referenceNs += timer.nsecsElapsed();
+        result.referenceIterations += referenceSimulator->getIterationCount();
+
+        for (int i = 0; i < productionNodes.size(); ++i) {
+            double v = productionSimulator->getNodeVoltage(productionNodes[i]);
+            double vRef = referenceSimulator->getNodeVoltage(referenceNodes[i]);
+            result.maxVoltageError = qMax(result.maxVoltageError, std::abs(v - vRef));
+            if (!withinTolerance(v, vRef, m_voltageTolerance)) {
+                result.mismatches++;
+            }
+        }
+
+        for (int i = 0; i < productionComponents.size(); ++i) {
+            ElectricalComponent *component = qobject_cast<ElectricalComponent*>(productionComponents[i]);
+            ElectricalComponent *referenceComponent = qobject_cast<ElectricalComponent*>(referenceComponents[i]);
+            if (!component || !referenceComponent) {
+                continue;
+            }
+
+            double v = component->getVoltage();
+            double vRef = referenceComponent->getVoltage();
+            double current = component->getCurrent();
+            double currentRef = referenceComponent->getCurrent();
+            result.maxVoltageError = qMax(result.maxVoltageError, std::abs(v - vRef));
+            result.maxCurrentError = qMax(result.maxCurrentError, std::abs(current - currentRef));
+            if (!withinTolerance(v, vRef, m_voltageTolerance) ||
+                !withinTolerance(current, currentRef, m_currentTolerance)) {
+                result.mismatches++;
+            }
+        }
+
+        result.steps++;
+    }
+
+    result.passed = solved && result.mismatches == 0;
+    if (result.productionNs > 0) {
+        result.speedup = double(result.referenceNs) / double(result.productionNs);
+    }
+    return result;
+}
+
+QJsonObject AccuracyHarness::toJson() const
+{
+    QJsonArray cases;
+    for (const AccuracyResult &result : m_results) {
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["params"] = result.params;
+        entry["passed"] = result.passed;
+        entry["steps"] = result.steps;
+        entry["nodes"] = result.nodes;
+        entry["components"] = result.components;
+        entry["mismatches"] = result.mismatches;
+        entry["maxVoltageError"] = result.maxVoltageError;
+        entry["maxCurrentError"] = result.maxCurrentError;
+        entry["productionIterations"] = result.productionIterations;
+        entry["referenceIterations"] = result.referenceIterations;
+        entry["productionNs"] = result.productionNs;
+        entry["referenceNs"] = result.referenceNs;
+        entry["speedup"] = result.speedup;
+        cases.append(entry);
+    }
+
+    QJsonObject tolerances;
+    tolerances["voltage"] = m_voltageTolerance;
+    tolerances["current"] = m_currentTolerance;
+    tolerances["relative"] = m_relativeTolerance;
+
+    QJsonObject root;
+    root["tolerances"] = tolerances;
+    root["cases"] = cases;
+    return root;
+}
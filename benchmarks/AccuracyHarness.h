@@ -0,0 +1,76 @@
+#ifndef ACCURACYHARNESS_H
+#define ACCURACYHARNESS_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <functional>
+
+class Circuit;
+
+// One circuit checked against the reference solver. build() must be
+// deterministic: it is called twice and both circuits are compared node by
+// node and component by component.
+struct AccuracyCase
+{
+    QString name;
+    QJsonObject params;
+    std::function<bool(Circuit*)> build;
+    int steps;
+};
+
+struct AccuracyResult
+{
+    QString name;
+    QJsonObject params;
+    bool passed;
+    int steps;
+    int nodes;
+    int components;
+    int mismatches;             // Values outside tolerance, over all steps
+    double maxVoltageError;     // Absolute, volts
+    double maxCurrentError;     // Absolute, amperes
+    int productionIterations;   // Newton iterations over all steps
+    int referenceIterations;
+    qint64 productionNs;
+    qint64 referenceNs;
+    double speedup;             // Reference time / production time
+};
+
+// Runs every case through the production solve path and the slow
+// extended-precision reference solver side by side, comparing node
+// voltages and component voltages/currents after every step. A value
+// matches when |production - reference| <= absolute + relative * |reference|.
+class AccuracyHarness
+{
+public:
+    AccuracyHarness();
+
+    void addCase(const AccuracyCase &accuracyCase);
+
+    void setFilter(const QString &filter) { m_filter = filter; }
+    void setVoltageTolerance(double absolute) { m_voltageTolerance = absolute; }
+    void setCurrentTolerance(double absolute) { m_currentTolerance = absolute; }
+    void setRelativeTolerance(double relative) { m_relativeTolerance = relative; }
+
+    // Run all matching cases, printing a summary line per case; returns
+    // false if any case failed
+    bool run();
+
+    const QVector<AccuracyResult>& getResults() const { return m_results; }
+    QJsonObject toJson() const;
+
+private:
+    AccuracyResult runCase(const AccuracyCase &accuracyCase);
+    bool withinTolerance(double production, double reference, double absolute) const;
+
+    QVector<AccuracyCase> m_cases;
+    QVector<AccuracyResult> m_results;
+    QString m_filter;
+    double m_voltageTolerance;
+    double m_currentTolerance;
+    double m_relativeTolerance;
+};
+
+#endif // ACCURACYHARNESS_H
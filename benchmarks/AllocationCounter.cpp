@@ -0,0 +1,101 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<qint64> g_allocations(0);
+std::atomic<qint64> g_allocatedBytes(0);
+
+inline void countAllocation(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+}
+}
+
+qint64 AllocationCounter::allocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+qint64 AllocationCounter::allocatedBytes()
+{
+    return g_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+// Interpose the malloc family; operator new ends up here as well
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return true;
+}
+
+#else
+
+void *operator new(std::size_t size)
+{
+    countAllocation(size);
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return false;
+}
+
+#endif
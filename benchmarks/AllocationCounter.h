@@ -0,0 +1,18 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Process-wide heap allocation counters for benchmarks. On glibc every
+// malloc-family call is counted (which covers both operator new and Qt's
+// container allocations); elsewhere only operator new is counted.
+namespace AllocationCounter
+{
+    qint64 allocations();
+    qint64 allocatedBytes();
+
+    // True when Qt container allocations are included in the counts
+    bool countsMalloc();
+}
+
+#endif // ALLOCATIONCOUNTER_H
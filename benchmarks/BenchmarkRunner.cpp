@@ -0,0 +1,212 @@
+#include "BenchmarkRunner.h"
+#include "AllocationCounter.h"
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QSysInfo>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+qint64 median(QVector<qint64> values)
+{
+    if (values.isEmpty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Counter events per work unit, or -1 if the counter was not measured
+double perUnit(qint64 count, qint64 units)
+{
+    return count >= 0 && units > 0 ? double(count) / double(units) : -1.0;
+}
+}
+
+BenchmarkRunner::BenchmarkRunner()
+    : m_repetitions(10)
+    , m_perfRequested(false)
+{
+}
+
+bool BenchmarkRunner::enablePerfCounters()
+{
+    m_perfRequested = true;
+    if (!m_perf.open()) {
+        qWarning() << "Hardware counters unavailable:" << m_perf.getError();
+        return false;
+    }
+    return true;
+}
+
+void BenchmarkRunner::addCase(const BenchmarkCase &benchmarkCase)
+{
+    m_cases.append(benchmarkCase);
+}
+
+void BenchmarkRunner::run()
+{
+    QTextStream out(stdout);
+    m_results.clear();
+
+    for (const BenchmarkCase &benchmarkCase : m_cases) {
+        if (!m_filter.isEmpty() && !benchmarkCase.name.contains(m_filter)) {
+            continue;
+        }
+
+        BenchmarkResult result = runCase(benchmarkCase);
+        m_results.append(result);
+
+        QString params = QString::fromUtf8(QJsonDocument(result.params).toJson(QJsonDocument::Compact));
+        out << QString("%1 %2").arg(result.name, -40).arg(params, -24)
+            << QString("  median %1 us  min %2 us  iters %3  allocs %4")
+                   .arg(result.medianNs / 1000.0, 10, 'f', 1)
+                   .arg(result.minNs / 1000.0, 10, 'f', 1)
+                   .arg(result.iterations)
+                   .arg(result.allocations);
+        if (result.counters.isValid()) {
+            out << QString("  ipc %1  cache-miss/it %2  br-miss/it %3")
+                       .arg(result.counters.ipc(), 0, 'f', 2)
+                       .arg(perUnit(result.counters.cacheMisses, result.iterations), 0, 'f', 1)
+                       .arg(perUnit(result.counters.branchMisses, result.iterations), 0, 'f', 1);
+        }
+        out << "\n";
+        out.flush();
+    }
+}
+
+BenchmarkResult BenchmarkRunner::runCase(const BenchmarkCase &benchmarkCase)
+{
+    BenchmarkResult result;
+    result.name = benchmarkCase.name;
+    result.params = benchmarkCase.params;
+    result.repetitions = m_repetitions;
+    result.iterations = 0;
+
+    QVector<qint64> times;
+    QVector<qint64> allocations;
+    QVector<qint64> bytes;
+    QVector<qint64> cycles;
+    QVector<qint64> instructions;
+    QVector<qint64> cacheMisses;
+    QVector<qint64> branchMisses;
+    times.reserve(m_repetitions);
+    allocations.reserve(m_repetitions);
+    bytes.reserve(m_repetitions);
+
+    QElapsedTimer timer;
+
+    for (int rep = 0; rep < m_repetitions; ++rep) {
+        if (benchmarkCase.setup) {
+            benchmarkCase.setup();
+        }
+
+        qint64 allocsBefore = AllocationCounter::allocations();
+        qint64 bytesBefore = AllocationCounter::allocatedBytes();
+        m_perf.start();
+        timer.start();
+
+        result.iterations = benchmarkCase.run();
+
+        qint64 elapsed = timer.nsecsElapsed();
+        PerfSample sample = m_perf.stop();
+        if (sample.isValid()) {
+            cycles.append(sample.cycles);
+            instructions.append(sample.instructions);
+            cacheMisses.append(sample.cacheMisses);
+            branchMisses.append(sample.branchMisses);
+        }
+        allocations.append(AllocationCounter::allocations() - allocsBefore);
+        bytes.append(AllocationCounter::allocatedBytes() - bytesBefore);
+        times.append(elapsed);
+
+        if (benchmarkCase.teardown) {
+            benchmarkCase.teardown();
+        }
+    }
+
+    qint64 total = 0;
+    for (qint64 time : times) {
+        total += time;
+    }
+
+    result.minNs = *std::min_element(times.begin(), times.end());
+    result.medianNs = median(times);
+    result.meanNs = total / times.size();
+    result.allocations = median(allocations);
+    result.allocatedBytes = median(bytes);
+
+    // Medians taken per counter; a counter the PMU lacks stays at -1
+    result.counters.cycles = cycles.isEmpty() ? -1 : median(cycles);
+    result.counters.instructions = instructions.isEmpty() ? -1 : median(instructions);
+    result.counters.cacheMisses = cacheMisses.isEmpty() ? -1 : median(cacheMisses);
+    result.counters.branchMisses = branchMisses.isEmpty() ? -1 : median(branchMisses);
+    return result;
+}
+
+bool BenchmarkRunner::writeJson(const QString &fileName, const QString &suite) const
+{
+    QJsonArray results;
+    for (const BenchmarkResult &result : m_results) {
+        QJsonObject wall;
+        wall["minNs"] = result.minNs;
+        wall["medianNs"] = result.medianNs;
+        wall["meanNs"] = result.meanNs;
+
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["params"] = result.params;
+        entry["repetitions"] = result.repetitions;
+        entry["wallTime"] = wall;
+        entry["iterations"] = result.iterations;
+        entry["allocations"] = result.allocations;
+        entry["allocatedBytes"] = result.allocatedBytes;
+
+        if (result.counters.isValid()) {
+            const PerfSample &counters = result.counters;
+            QJsonObject hardware;
+            hardware["cycles"] = counters.cycles;
+            hardware["instructions"] = counters.instructions;
+            hardware["cacheMisses"] = counters.cacheMisses;
+            hardware["branchMisses"] = counters.branchMisses;
+            hardware["ipc"] = counters.ipc();
+            hardware["cacheMissesPerIteration"] = perUnit(counters.cacheMisses, result.iterations);
+            hardware["branchMissesPerIteration"] = perUnit(counters.branchMisses, result.iterations);
+            entry["perfCounters"] = hardware;
+        }
+        results.append(entry);
+    }
+
+    QJsonObject root;
+    root["suite"] = suite;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["host"] = QSysInfo::machineHostName();
+    root["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    root["qtVersion"] = QString(qVersion());
+    root["allocationsIncludeMalloc"] = AllocationCounter::countsMalloc();
+    if (m_perfRequested) {
+        QJsonObject perf;
+        perf["available"] = m_perf.isOpen();
+        if (!m_perf.isOpen()) {
+            perf["error"] = m_perf.getError();
+        }
+        root["perfCounters"] = perf;
+    }
+    root["results"] = results;
+    for (const QString &key : m_sections.keys()) {
+        root[key] = m_sections.value(key);
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write benchmark results to" << fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
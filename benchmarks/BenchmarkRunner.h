@@ -0,0 +1,76 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include "PerfCounters.h"
+#include <functional>
+
+// One measured benchmark case. setup() and teardown() run around every
+// repetition outside the timed region; run() is the timed body and returns
+// how many units of work it did (solver calls, Newton iterations, merges),
+// which is reported alongside the wall time.
+struct BenchmarkCase
+{
+    QString name;
+    QJsonObject params;
+    std::function<void()> setup;
+    std::function<qint64()> run;
+    std::function<void()> teardown;
+};
+
+struct BenchmarkResult
+{
+    QString name;
+    QJsonObject params;
+    int repetitions;
+    qint64 minNs;
+    qint64 medianNs;
+    qint64 meanNs;
+    qint64 iterations;      // Work units per repetition (last repetition)
+    qint64 allocations;     // Heap allocations per repetition (median)
+    qint64 allocatedBytes;  // Heap bytes requested per repetition (median)
+    PerfSample counters;    // Hardware counters per repetition (median), -1 if not measured
+};
+
+// Runs registered cases and writes their results as JSON, so runs on
+// different revisions can be compared.
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner();
+
+    void addCase(const BenchmarkCase &benchmarkCase);
+
+    // Only run cases whose name contains the filter
+    void setFilter(const QString &filter) { m_filter = filter; }
+    void setRepetitions(int repetitions) { m_repetitions = qMax(1, repetitions); }
+
+    // Read hardware counters around every repetition. Returns false (and
+    // the run goes on without them) if the kernel does not allow it.
+    bool enablePerfCounters();
+
+    // Run all matching cases, printing a summary line per case
+    void run();
+
+    const QVector<BenchmarkResult>& getResults() const { return m_results; }
+    
+    // Extra top-level report sections (e.g. accuracy checks)
+    void setSection(const QString &key, const QJsonValue &value) { m_sections[key] = value; }
+    
+    bool writeJson(const QString &fileName, const QString &suite) const;
+
+private:
+    BenchmarkResult runCase(const BenchmarkCase &benchmarkCase);
+
+    QVector<BenchmarkCase> m_cases;
+    QVector<BenchmarkResult> m_results;
+    QJsonObject m_sections;
+    QString m_filter;
+    int m_repetitions;
+    bool m_perfRequested;
+    PerfCounters m_perf;
+};
+
+#endif // BENCHMARKRUNNER_H
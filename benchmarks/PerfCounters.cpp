@@ -0,0 +1,159 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+PerfCounters::PerfCounters()
+    : m_leader(-1)
+    , m_openCount(0)
+{
+    for (int i = 0; i < CounterCount; ++i) {
+        m_fds[i] = -1;
+        m_slots[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+#ifdef __linux__
+
+namespace {
+int openCounter(quint64 config, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0;   // The leader starts the group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+}
+
+bool PerfCounters::open()
+{
+    if (isOpen()) {
+        return true;
+    }
+
+    const quint64 configs[CounterCount] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    m_leader = openCounter(configs[Cycles], -1);
+    if (m_leader < 0) {
+        m_error = QString("perf_event_open failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+    m_fds[Cycles] = m_leader;
+    m_slots[Cycles] = 0;
+    m_openCount = 1;
+
+    // Counters the PMU lacks are skipped rather than failing the group
+    for (int i = Instructions; i < CounterCount; ++i) {
+        m_fds[i] = openCounter(configs[i], m_leader);
+        if (m_fds[i] >= 0) {
+            m_slots[i] = m_openCount++;
+        }
+    }
+
+    m_error.clear();
+    return true;
+}
+
+void PerfCounters::close()
+{
+    for (int i = CounterCount - 1; i >= 0; --i) {
+        if (m_fds[i] >= 0) {
+            ::close(m_fds[i]);
+        }
+        m_fds[i] = -1;
+        m_slots[i] = -1;
+    }
+    m_leader = -1;
+    m_openCount = 0;
+}
+
+void PerfCounters::start()
+{
+    if (!isOpen()) {
+        return;
+    }
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfSample PerfCounters::stop()
+{
+    PerfSample sample = { -1, -1, -1, -1 };
+    if (!isOpen()) {
+        return sample;
+    }
+
+    ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time_enabled, time_running, values[nr]
+    quint64 data[3 + CounterCount];
+    ssize_t expected = static_cast<ssize_t>((3 + m_openCount) * sizeof(quint64));
+    if (read(m_leader, data, sizeof(data)) < expected) {
+        return sample;
+    }
+
+    // Scale up if the group was multiplexed with other users of the PMU
+    double scale = 1.0;
+    if (data[2] > 0 && data[2] < data[1]) {
+        scale = double(data[1]) / double(data[2]);
+    }
+
+    qint64 values[CounterCount];
+    for (int i = 0; i < CounterCount; ++i) {
+        values[i] = m_slots[i] >= 0 ? qint64(data[3 + m_slots[i]] * scale) : -1;
+    }
+
+    sample.cycles = values[Cycles];
+    sample.instructions = values[Instructions];
+    sample.cacheMisses = values[CacheMisses];
+    sample.branchMisses = values[BranchMisses];
+    return sample;
+}
+
+#else
+
+bool PerfCounters::open()
+{
+    m_error = "Hardware counters are only supported on Linux";
+    return false;
+}
+
+void PerfCounters::close()
+{
+}
+
+void PerfCounters::start()
+{
+}
+
+PerfSample PerfCounters::stop()
+{
+    PerfSample sample = { -1, -1, -1, -1 };
+    return sample;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QtGlobal>
+#include <QString>
+
+// Counter values over one measured region; -1 where a counter could not
+// be opened
+struct PerfSample
+{
+    qint64 cycles;
+    qint64 instructions;
+    qint64 cacheMisses;
+    qint64 branchMisses;
+
+    bool isValid() const { return cycles > 0; }
+    double ipc() const { return cycles > 0 && instructions >= 0 ? double(instructions) / double(cycles) : 0.0; }
+};
+
+// Hardware performance counters of the calling thread, read through Linux
+// perf_event_open as one group so all counters cover the same interval
+// (and are scaled if the kernel had to multiplex them). User space only,
+// which works under the default perf_event_paranoid setting. Elsewhere,
+// or when the kernel refuses (containers, paranoid level 3, no PMU in
+// the VM), open() fails and getError() says why.
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    bool open();
+    void close();
+    bool isOpen() const { return m_leader >= 0; }
+    const QString &getError() const { return m_error; }
+
+    void start();
+    PerfSample stop();
+
+private:
+    Q_DISABLE_COPY(PerfCounters)
+
+    enum Counter { Cycles = 0, Instructions, CacheMisses, BranchMisses, CounterCount };
+
+    int m_leader;                   // Group leader fd (cycles)
+    int m_fds[CounterCount];
+    int m_slots[CounterCount];      // Position in the group read, -1 if not open
+    int m_openCount;
+    QString m_error;
+};
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,911 @@
+#include "BenchmarkRunner.h"
+#include "AccuracyHarness.h"
+#include "simulation/Circuit.h"
+#include "simulation/CircuitGenerator.h"
+#include "simulation/CircuitSimulator.h"
+#include "simulation/LaneMatrixSolver.h"
+#include "simulation/LaneSweep.h"
+#include "simulation/MatrixSolver.h"
+#include "simulation/Node.h"
+#include "simulation/SampleStream.h"
+#include "simulation/Subcircuit.h"
+#include "simulation/Tracing.h"
+#include "core/Arduino.h"
+#include "core/ArduinoPin.h"
+#include "core/Breadboard.h"
+#include "core/LED.h"
+#include "core/LedStrip.h"
+#include "core/Resistor.h"
+#include "core/ShiftRegister.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <memory>
+
+namespace {
+
+// Arduino pin 13 (OUTPUT, HIGH) driving ledCount parallel LED + resistor
+// chains to ground. On a breadboard the pin and ground sit on the top rails
+// and each chain's middle node on its own strip; the other strips stay
+// unused.
+class LedArrayFixture
+{
+public:
+    explicit LedArrayFixture(int ledCount, bool onBreadboard = false)
+        : circuit(new Circuit())
+        , arduino(new Arduino(Arduino::UNO))
+        , simulator(new CircuitSimulator(circuit.get(), circuit.get()))
+        , pinNode(nullptr)
+    {
+        arduino->powerOn();
+        arduino->pinMode(13, Arduino::OUTPUT);
+        arduino->digitalWrite(13, Arduino::HIGH);
+
+        pinNode = circuit->createNode();
+        circuit->connectArduinoPin(arduino.get(), 13, pinNode);
+        circuit->addComponent(arduino->getGroundPin());
+        circuit->connectComponentToNode(arduino->getGroundPin(), 0, circuit->getGroundNode());
+
+        Breadboard* board = nullptr;
+        if (onBreadboard) {
+            board = new Breadboard(Breadboard::FullSize, circuit.get());
+            circuit->addComponent(board);
+            circuit->connectComponentToNode(board, board->netTerminal(board->hole(Breadboard::TopPositiveRail, 0)),
+                                            pinNode);
+            circuit->connectComponentToNode(board, board->netTerminal(board->hole(Breadboard::TopNegativeRail, 0)),
+                                            circuit->getGroundNode());
+        }
+
+        for (int i = 0; i < ledCount; ++i) {
+            LED* led = LED::createStandardLED("red", circuit.get());
+            Resistor* resistor = new Resistor(220.0, circuit.get());
+            circuit->addComponent(led);
+            circuit->addComponent(resistor);
+
+            Node* middle = circuit->createNode();
+            circuit->connectComponentToNode(led, 0, pinNode);
+            circuit->connectComponentToNode(led, 1, middle);
+            circuit->connectComponentToNode(resistor, 0, middle);
+            circuit->connectComponentToNode(resistor, 1, circuit->getGroundNode());
+
+            if (board) {
+                int column = i % board->getColumns();
+                int row = i < board->getColumns() ? Breadboard::RowA : Breadboard::RowF;
+                circuit->connectComponentToNode(board, board->netTerminal(board->hole(row, column)), middle);
+            }
+        }
+
+        simulator->initialize();
+    }
+
+    ~LedArrayFixture()
+    {
+        // Pins belong to the Arduino, not the circuit
+        circuit->clearArduinoConnections(arduino.get());
+        circuit.reset();
+    }
+
+    std::unique_ptr<Circuit> circuit;
+    std::unique_ptr<Arduino> arduino;
+    CircuitSimulator* simulator;    // Owned by circuit
+    Node* pinNode;
+};
+
+// Arduino pins 2 (data), 3 (shift clock) and 4 (latch clock) driving a
+// daisy chain of 74HC595s, Q7' of each feeding SER of the next
+class ShiftRegisterFixture
+{
+public:
+    static const int DataPin = 2;
+    static const int ClockPin = 3;
+    static const int LatchPin = 4;
+
+    ShiftRegisterFixture(int chipCount, bool digitalFastPath)
+        : circuit(new Circuit())
+        , arduino(new Arduino(Arduino::UNO))
+        , simulator(new CircuitSimulator(circuit.get(), circuit.get()))
+    {
+        arduino->powerOn();
+        circuit->addComponent(arduino->getGroundPin());
+        circuit->connectComponentToNode(arduino->getGroundPin(), 0, circuit->getGroundNode());
+
+        Node* data = circuit->createNode();
+        Node* clock = circuit->createNode();
+        Node* latch = circuit->createNode();
+        for (int pin : {DataPin, ClockPin, LatchPin}) {
+            arduino->pinMode(pin, Arduino::OUTPUT);
+        }
+        circuit->connectArduinoPin(arduino.get(), DataPin, data);
+        circuit->connectArduinoPin(arduino.get(), ClockPin, clock);
+        circuit->connectArduinoPin(arduino.get(), LatchPin, latch);
+
+        for (int i = 0; i < chipCount; ++i) {
+            ShiftRegister* chip = new ShiftRegister(circuit.get());
+            circuit->addComponent(chip);
+            circuit->connectComponentToNode(chip, ShiftRegister::SerialIn, data);
+            circuit->connectComponentToNode(chip, ShiftRegister::ShiftClock, clock);
+            circuit->connectComponentToNode(chip, ShiftRegister::LatchClock, latch);
+
+            data = circuit->createNode();
+            circuit->connectComponentToNode(chip, chip->outputTerminal(ShiftRegister::SerialOut), data);
+        }
+
+        simulator->setDigitalFastPath(digitalFastPath);
+        simulator->setMinUpdateInterval(0);
+        simulator->start();
+    }
+
+    ~ShiftRegisterFixture()
+    {
+        circuit->clearArduinoConnections(arduino.get());
+        circuit.reset();
+    }
+
+    // shiftOut() of one byte per chip, then latch
+    qint64 shiftOut(quint8 pattern, int chipCount)
+    {
+        for (int bit = 0; bit < chipCount * ShiftRegister::Bits; ++bit) {
+            arduino->digitalWrite(DataPin, (pattern >> (bit % 8)) & 1 ? Arduino::HIGH : Arduino::LOW);
+            arduino->digitalWrite(ClockPin, Arduino::HIGH);
+            arduino->digitalWrite(ClockPin, Arduino::LOW);
+        }
+        arduino->digitalWrite(LatchPin, Arduino::HIGH);
+        arduino->digitalWrite(LatchPin, Arduino::LOW);
+        return chipCount * ShiftRegister::Bits;
+    }
+
+    std::unique_ptr<Circuit> circuit;
+    std::unique_ptr<Arduino> arduino;
+    CircuitSimulator* simulator;    // Owned by circuit
+};
+
+}
+
+// Cases reach into the simulator's private pipeline stages
+class SimulationBenchmarks
+{
+public:
+    static void registerCases(BenchmarkRunner &runner);
+    static void registerAccuracyCases(AccuracyHarness &harness);
+
+private:
+    static void addSolverCases(BenchmarkRunner &runner);
+    static void addSimulatorCases(BenchmarkRunner &runner);
+    static void addTopologyCases(BenchmarkRunner &runner);
+    static void addCircuitCases(BenchmarkRunner &runner);
+    static void addGeneratorCases(BenchmarkRunner &runner);
+    static void addDigitalCases(BenchmarkRunner &runner);
+    static void addSourceCases(BenchmarkRunner &runner);
+};
+
+void SimulationBenchmarks::registerCases(BenchmarkRunner &runner)
+{
+    addSolverCases(runner);
+    addSimulatorCases(runner);
+    addTopologyCases(runner);
+    addCircuitCases(runner);
+    addGeneratorCases(runner);
+    addDigitalCases(runner);
+    addSourceCases(runner);
+}
+
+void SimulationBenchmarks::addSolverCases(BenchmarkRunner &runner)
+{
+    // Resistor ladder stamped into a dense system of the given dimension
+    for (int dimension : {8, 32, 128, 256, 512}) {
+        auto solver = std::make_shared<MatrixSolver>();
+
+        BenchmarkCase benchmarkCase;
+        benchmarkCase.name = "MatrixSolver/solve_dense";
+        benchmarkCase.params["dimension"] = dimension;
+        benchmarkCase.setup = [solver, dimension]() {
+            if (solver->getDimension() != dimension) {
+                solver->setDimension(dimension);
+            }
+            solver->clear();
+            for (int i = 0; i < dimension; ++i) {
+                solver->addConductance(i, -1, 1e-3);
+                if (i + 1 < dimension) {
+                    solver->addConductance(i, i + 1, 1e-2);
+                }
+            }
+            solver->setNodeVoltage(0, 5.0);
+        };
+        benchmarkCase.run = [solver]() -> qint64 {
+            solver->solve();
+            return 1;
+        };
+        runner.addCase(benchmarkCase);
+    }
+
+    // The same ladder in every lane, with lane-dependent leakage; one item
+    // per system solved, comparable with MatrixSolver/solve_dense
+    for (int dimension : {8, 32, 128}) {
+        for (int lanes : {4, 8}) {
+            auto solver = std::make_shared<LaneMatrixSolver>();
+            solver->setLaneCount(lanes);
+
+            BenchmarkCase benchmarkCase;
+            benchmarkCase.name = "LaneMatrixSolver/solve_dense";
+            benchmarkCase.params["dimension"] = dimension;
+            benchmarkCase.params["lanes"] = lanes;
+            benchmarkCase.setup = [solver, dimension, lanes]() {
+                if (solver->getDimension() != dimension) {
+                    solver->setDimension(dimension);
+                }
+                solver->clear();
+                double leakage[LaneMatrixSolver::MaxLanes];
+                double link[LaneMatrixSolver::MaxLanes];
+                double source[LaneMatrixSolver::MaxLanes];
+                for (int lane = 0; lane < lanes; ++lane) {
+                    leakage[lane] = 1e-3 * (1.0 + 0.1 * lane);
+                    link[lane] = 1e-2;
+                    source[lane] = 5.0;
+                }
+                for (int i = 0; i < dimension; ++i) {
+                    solver->addConductance(i, -1, leakage);
+                    if (i + 1 < dimension) {
+                        solver->addConductance(i, i + 1, link);
+                    }
+                }
+                solver->setNodeVoltage(0, source);
+            };
+            benchmarkCase.run = [solver, lanes]() -> qint64 {
+                solver->solve();
+                return lanes;
+            };
+            runner.addCase(benchmarkCase);
+        }
+    }
+}
+
+void SimulationBenchmarks::addSimulatorCases(BenchmarkRunner &runner)
+{
+    for (int ledCount : {10, 50, 200}) {
+        auto fixture = std::make_shared<std::unique_ptr<LedArrayFixture>>();
+        auto create = [fixture, ledCount]() {
+            if (!*fixture) {
+                fixture->reset(new LedArrayFixture(ledCount));
+            }
+        };
+
+        BenchmarkCase build;
+        build.name = "CircuitSimulator/buildMatrices";
+        build.params["leds"] = ledCount;
+        build.setup = create;
+        build.run = [fixture]() -> qint64 {
+            (*fixture)->simulator->buildMatrices();
+            return 1;
+        };
+        runner.addCase(build);
+
+        BenchmarkCase update;
+        update.name = "CircuitSimulator/updateComponentStates";
+        update.params["leds"] = ledCount;
+        update.setup = [fixture, create]() {
+            create();
+            // Give the solver a solution to read back
+            (*fixture)->simulator->buildMatrices();
+            (*fixture)->simulator->m_matrixSolver->solve();
+        };
+        update.run = [fixture]() -> qint64 {
+            (*fixture)->simulator->updateComponentStates();
+            return 1;
+        };
+        runner.addCase(update);
+
+        // Full Newton step from a cold operating point
+        BenchmarkCase step;
+        step.name = "CircuitSimulator/solve_step";
+        step.params["leds"] = ledCount;
+        step.setup = [fixture, create]() {
+            create();
+            (*fixture)->simulator->reset();
+            (*fixture)->simulator->initialize();
+        };
+        step.run = [fixture]() -> qint64 {
+            (*fixture)->simulator->solve();
+            return (*fixture)->simulator->getIterationCount();
+        };
+        step.teardown = [fixture]() {
+            fixture->reset();
+        };
+        runner.addCase(step);
+
+        // The same cold operating point for 4 or 8 resistor values at once
+        for (int lanes : {4, 8}) {
+            auto sweep = std::make_shared<std::unique_ptr<LaneSweep>>();
+
+            BenchmarkCase lockstep;
+            lockstep.name = "LaneSweep/solve";
+            lockstep.params["leds"] = ledCount;
+            lockstep.params["lanes"] = lanes;
+            lockstep.setup = [fixture, create, sweep, lanes]() {
+                create();
+                sweep->reset(new LaneSweep((*fixture)->circuit.get(), lanes));
+                (*sweep)->compile();
+                for (Component* component : (*fixture)->circuit->getComponents()) {
+                    if (qobject_cast<Resistor*>(component)) {
+                        for (int lane = 0; lane < lanes; ++lane) {
+                            (*sweep)->setResistance(component, lane, 150.0 + 25.0 * lane);
+                        }
+                    }
+                }
+            };
+            lockstep.run = [sweep, lanes]() -> qint64 {
+                (*sweep)->solve();
+                return lanes;
+            };
+            lockstep.teardown = [fixture, sweep]() {
+                sweep->reset();
+                fixture->reset();
+            };
+            runner.addCase(lockstep);
+        }
+    }
+
+    // The same LED chains with and without a populated full-size breadboard
+    // under them. Strips are never stamped and unused ones have no node, so
+    // both should cost the same.
+    for (bool onBreadboard : {false, true}) {
+        auto fixture = std::make_shared<std::unique_ptr<LedArrayFixture>>();
+
+        BenchmarkCase step;
+        step.name = "CircuitSimulator/solve_step_breadboard";
+        step.params["leds"] = 50;
+        step.params["breadboard"] = onBreadboard;
+        step.setup = [fixture, onBreadboard]() {
+            fixture->reset(new LedArrayFixture(50, onBreadboard));
+        };
+        step.run = [fixture]() -> qint64 {
+            (*fixture)->simulator->solve();
+            return (*fixture)->simulator->getIterationCount();
+        };
+        step.teardown = [fixture]() {
+            fixture->reset();
+        };
+        runner.addCase(step);
+    }
+
+    // Pin writes through the whole signal pipeline with throttling off; the
+    // per-stage latencies go into the report
+    auto pipeline = std::make_shared<std::unique_ptr<LedArrayFixture>>();
+    const int toggles = 50;
+
+    BenchmarkCase toggle;
+    toggle.name = "CircuitSimulator/pin_to_led";
+    toggle.params["leds"] = 50;
+    toggle.params["toggles"] = toggles;
+    toggle.setup = [pipeline]() {
+        if (!*pipeline) {
+            pipeline->reset(new LedArrayFixture(50));
+            (*pipeline)->simulator->setMinUpdateInterval(0);
+            (*pipeline)->simulator->start();
+            (*pipeline)->simulator->resetResponseLatency();
+        }
+    };
+    toggle.run = [pipeline, toggles]() -> qint64 {
+        Arduino* arduino = (*pipeline)->arduino.get();
+        for (int i = 0; i < toggles; ++i) {
+            arduino->digitalWrite(13, (i & 1) ? Arduino::HIGH : Arduino::LOW);
+        }
+        return toggles;
+    };
+    toggle.teardown = [pipeline, &runner]() {
+        runner.setSection("responseLatency", (*pipeline)->simulator->getResponseLatency().toJson());
+    };
+    runner.addCase(toggle);
+}
+
+void SimulationBenchmarks::addTopologyCases(BenchmarkRunner &runner)
+{
+    // Add one node and two branches next to an LED array, then solve. The
+    // incremental case lets the simulator patch its node indexing; the
+    // full case forces the re-initialization every edit used to cost.
+    for (int ledCount : {10, 50, 200}) {
+        for (bool incremental : {true, false}) {
+            auto fixture = std::make_shared<std::unique_ptr<LedArrayFixture>>();
+            auto added = std::make_shared<QVector<Resistor*>>();
+
+            BenchmarkCase edit;
+            edit.name = incremental ? "CircuitSimulator/topology_edit_incremental"
+                                    : "CircuitSimulator/topology_edit_full_reinit";
+            edit.params["leds"] = ledCount;
+            edit.setup = [fixture, ledCount]() {
+                if (!*fixture) {
+                    fixture->reset(new LedArrayFixture(ledCount));
+                    (*fixture)->simulator->solve();
+                }
+            };
+            edit.run = [fixture, added, incremental]() -> qint64 {
+                LedArrayFixture *f = fixture->get();
+                Circuit *circuit = f->circuit.get();
+
+                Node* node = circuit->createNode();
+                Resistor* upper = new Resistor(1000.0, circuit);
+                Resistor* lower = new Resistor(1000.0, circuit);
+                circuit->addComponent(upper);
+                circuit->addComponent(lower);
+                circuit->connectComponentToNode(upper, 0, f->pinNode);
+                circuit->connectComponentToNode(upper, 1, node);
+                circuit->connectComponentToNode(lower, 0, node);
+                circuit->connectComponentToNode(lower, 1, circuit->getGroundNode());
+                added->append(upper);
+                added->append(lower);
+
+                if (!incremental) {
+                    f->simulator->m_initialized = false;
+                }
+                f->simulator->solve();
+                return f->simulator->getIterationCount();
+            };
+            edit.teardown = [fixture, added]() {
+                for (Resistor* resistor : *added) {
+                    (*fixture)->circuit->detachComponent(resistor);
+                    delete resistor;
+                }
+                added->clear();
+            };
+            runner.addCase(edit);
+        }
+    }
+}
+
+void SimulationBenchmarks::addCircuitCases(BenchmarkRunner &runner)
+{
+    // Chain of resistors that start on separate nodes; every connection
+    // merges two nodes
+    for (int count : {100, 1000, 5000}) {
+        auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+        auto resistors = std::make_shared<QVector<Resistor*>>();
+
+        BenchmarkCase merge;
+        merge.name = "Circuit/connectComponents_merge";
+        merge.params["resistors"] = count;
+        merge.setup = [circuit, resistors, count]() {
+            circuit->reset(new Circuit());
+            resistors->clear();
+            for (int i = 0; i < count; ++i) {
+                Resistor* resistor = new Resistor(100.0, circuit->get());
+                (*circuit)->addComponent(resistor);
+                (*circuit)->connectComponentToNode(resistor, 0, (*circuit)->createNode());
+                (*circuit)->connectComponentToNode(resistor, 1, (*circuit)->createNode());
+                resistors->append(resistor);
+            }
+        };
+        merge.run = [circuit, resistors]() -> qint64 {
+            qint64 merges = 0;
+            for (int i = 0; i + 1 < resistors->size(); ++i) {
+                if ((*circuit)->connectComponents((*resistors)[i], 1, (*resistors)[i + 1], 0)) {
+                    merges++;
+                }
+            }
+            return merges;
+        };
+        merge.teardown = [circuit]() {
+            circuit->reset();
+        };
+        runner.addCase(merge);
+    }
+
+    // Two groups of nodes joined line by line, by one Bus or by one Wire
+    // per line
+    for (int width : {8, 64}) {
+        for (bool bus : {true, false}) {
+            auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+            auto fromNodes = std::make_shared<QVector<Node*>>();
+            auto toNodes = std::make_shared<QVector<Node*>>();
+
+            BenchmarkCase join;
+            join.name = bus ? "Circuit/addBus" : "Circuit/addWire_lines";
+            join.params["width"] = width;
+            join.setup = [circuit, fromNodes, toNodes, width]() {
+                circuit->reset(new Circuit());
+                fromNodes->clear();
+                toNodes->clear();
+                for (int line = 0; line < width; ++line) {
+                    fromNodes->append((*circuit)->createNode());
+                    toNodes->append((*circuit)->createNode());
+                }
+            };
+            join.run = [circuit, fromNodes, toNodes, bus]() -> qint64 {
+                if (bus) {
+                    (*circuit)->addBus(*fromNodes, *toNodes);
+                } else {
+                    for (int line = 0; line < fromNodes->size(); ++line) {
+                        (*circuit)->addWire((*fromNodes)[line], (*toNodes)[line]);
+                    }
+                }
+                return (*circuit)->getComponents().size();
+            };
+            join.teardown = [circuit]() {
+                circuit->reset();
+            };
+            runner.addCase(join);
+        }
+    }
+
+    // LED + series resistor channels off one driver node, placed from a
+    // subcircuit template or built part by part
+    for (int count : {100, 1000}) {
+        for (bool instanced : {true, false}) {
+            auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+            auto channel = std::make_shared<SubcircuitTemplate>("Channel", QStringList{"IN"});
+            channel->addElement("R", [](QObject *parent) { return new Resistor(220.0, parent); },
+                                {"IN", "A"});
+            channel->addElement("D", [](QObject *parent) { return new LED(Qt::red, parent); },
+                                {"A", "GND"});
+
+            BenchmarkCase place;
+            place.name = instanced ? "Circuit/instantiate" : "Circuit/addComponent_channels";
+            place.params["channels"] = count;
+            place.setup = [circuit]() {
+                circuit->reset(new Circuit());
+            };
+            place.run = [circuit, channel, count, instanced]() -> qint64 {
+                Circuit *c = circuit->get();
+                Node *driver = c->createNode();
+                if (instanced) {
+                    c->instantiate(*channel, QVector<QVector<Node*>>(count, {driver}), "CH");
+                } else {
+                    c->beginUpdate();
+                    for (int i = 0; i < count; ++i) {
+                        Resistor *resistor = new Resistor(220.0, c);
+                        LED *led = new LED(Qt::red, c);
+                        Node *anode = c->createNode();
+                        c->addComponent(resistor);
+                        c->addComponent(led);
+                        c->connectComponentToNode(resistor, 0, driver);
+                        c->connectComponentToNode(resistor, 1, anode);
+                        c->connectComponentToNode(led, 0, anode);
+                        c->connectComponentToNode(led, 1, c->getGroundNode());
+                    }
+                    c->endUpdate();
+                }
+                return c->getComponents().size();
+            };
+            place.teardown = [circuit]() {
+                circuit->reset();
+            };
+            runner.addCase(place);
+        }
+    }
+}
+
+void SimulationBenchmarks::addGeneratorCases(BenchmarkRunner &runner)
+{
+    typedef std::function<bool(CircuitGenerator&, Circuit*, int)> Builder;
+
+    // Generation is timed up to large sizes; solve steps stay within what
+    // the dense solver handles in reasonable time
+    struct Shape {
+        QString name;
+        Builder build;
+        QVector<int> generateSizes;
+        QVector<int> solveSizes;
+    };
+
+    const QVector<Shape> shapes = {
+        {"mesh", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildResistorMesh(c, n); },
+         {10, 100, 300}, {10, 20}},
+        {"ladder", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildResistorLadder(c, n); },
+         {1000, 10000, 100000}, {100, 400}},
+        {"random_graph", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildRandomGraph(c, n); },
+         {1000, 10000, 100000}, {100, 400}},
+        {"led_matrix", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildLedMatrix(c, n, n); },
+         {8, 16, 24}, {8, 16}},
+        {"led_matrix_block", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildLedMatrix(c, n, n, true); },
+         {8, 16, 24}, {8, 16}},
+        {"islands", [](CircuitGenerator &g, Circuit *c, int n) { return g.buildArduinoIslands(c, n); },
+         {100, 1000, 10000}, {10, 100}}
+    };
+
+    for (const Shape &shape : shapes) {
+        Builder build = shape.build;
+
+        for (int size : shape.generateSizes) {
+            auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+
+            BenchmarkCase generate;
+            generate.name = "CircuitGenerator/" + shape.name;
+            generate.params["size"] = size;
+            generate.setup = [circuit]() {
+                circuit->reset(new Circuit());
+            };
+            generate.run = [circuit, build, size]() -> qint64 {
+                CircuitGenerator generator;
+                build(generator, circuit->get(), size);
+                return (*circuit)->getComponents().size();
+            };
+            generate.teardown = [circuit]() {
+                circuit->reset();
+            };
+            runner.addCase(generate);
+        }
+
+        // Newton step on the generated circuit from a cold operating point
+        for (int size : shape.solveSizes) {
+            auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+            auto simulator = std::make_shared<CircuitSimulator*>(nullptr);
+
+            BenchmarkCase step;
+            step.name = "CircuitSimulator/solve_step_" + shape.name;
+            step.params["size"] = size;
+            step.setup = [circuit, simulator, build, size]() {
+                if (!*circuit) {
+                    circuit->reset(new Circuit());
+                    CircuitGenerator generator;
+                    build(generator, circuit->get(), size);
+                    *simulator = new CircuitSimulator(circuit->get(), circuit->get());
+                }
+                (*simulator)->reset();
+                (*simulator)->initialize();
+            };
+            step.run = [simulator]() -> qint64 {
+                (*simulator)->solve();
+                return (*simulator)->getIterationCount();
+            };
+            // The simulator is a child of the circuit and goes with it, so
+            // later cases don't run on a heap holding this one's circuit
+            step.teardown = [circuit, simulator]() {
+                *simulator = nullptr;
+                circuit->reset();
+            };
+            runner.addCase(step);
+        }
+    }
+}
+
+void SimulationBenchmarks::addDigitalCases(BenchmarkRunner &runner)
+{
+    // Bit-banged shiftOut into a 595 chain. With the fast path the clock,
+    // latch and data nets are propagated as events; without it every pin
+    // write is an MNA solve with the chips as boundary elements.
+    for (int chipCount : {1, 8}) {
+        for (bool fastPath : {true, false}) {
+            auto fixture = std::make_shared<std::unique_ptr<ShiftRegisterFixture>>();
+            auto pattern = std::make_shared<quint8>(0);
+
+            BenchmarkCase shift;
+            shift.name = fastPath ? "DigitalComponent/shift_out_events"
+                                  : "DigitalComponent/shift_out_analog";
+            shift.params["chips"] = chipCount;
+            shift.setup = [fixture, chipCount, fastPath]() {
+                if (!*fixture) {
+                    fixture->reset(new ShiftRegisterFixture(chipCount, fastPath));
+                }
+            };
+            shift.run = [fixture, pattern, chipCount]() -> qint64 {
+                return (*fixture)->shiftOut((*pattern)++, chipCount);
+            };
+            shift.teardown = [fixture]() {
+                fixture->reset();
+            };
+            runner.addCase(shift);
+        }
+    }
+
+    // Frames of changing colors into two daisy-chained WS2812 strips, as
+    // whole transactions and decoded from a scheduled 800 kHz waveform
+    for (int pixels : {60, 300}) {
+        for (bool waveform : {false, true}) {
+            auto circuit = std::make_shared<std::unique_ptr<Circuit>>();
+            auto first = std::make_shared<LedStrip*>(nullptr);
+            auto frame = std::make_shared<QByteArray>();
+
+            BenchmarkCase show;
+            show.name = waveform ? "LedStrip/decode_waveform" : "LedStrip/show_frame";
+            show.params["pixels"] = pixels;
+            show.setup = [circuit, first, frame, pixels]() {
+                if (*circuit) {
+                    return;
+                }
+                circuit->reset(new Circuit());
+                LedStrip* head = new LedStrip(pixels / 2, circuit->get());
+                LedStrip* tail = new LedStrip(pixels - pixels / 2, circuit->get());
+                (*circuit)->addComponent(head);
+                (*circuit)->addComponent(tail);
+                (*circuit)->connectComponents(head, LedStrip::DataOut, tail, LedStrip::DataIn);
+                *first = head;
+                frame->resize(pixels * 3);
+            };
+            show.run = [first, frame, waveform]() -> qint64 {
+                // New colors every frame so every pixel is rewritten
+                for (int i = 0; i < frame->size(); ++i) {
+                    (*frame)[i] = char((*frame)[i] + i + 1);
+                }
+                LedStrip* strip = *first;
+                if (!waveform) {
+                    strip->receiveTransaction(LedStrip::DataIn, *frame);
+                    return frame->size() / 3;
+                }
+
+                // 1.25 us per bit, high for 0.8 us (1) or 0.4 us (0)
+                qint64 t = 0;
+                for (int i = 0; i < frame->size(); ++i) {
+                    char byte = frame->at(i);
+                    for (int bit = 7; bit >= 0; --bit) {
+                        qint64 high = ((byte >> bit) & 1) ? 800 : 400;
+                        strip->decodeEdge(true, t);
+                        strip->decodeEdge(false, t + high);
+                        t += 1250;
+                    }
+                }
+                strip->decodeEdge(false, t + LedStrip::ResetNs);
+                return frame->size() / 3;
+            };
+            show.teardown = [circuit]() {
+                circuit->reset();
+            };
+            runner.addCase(show);
+        }
+    }
+}
+
+void SimulationBenchmarks::addSourceCases(BenchmarkRunner &runner)
+{
+    // Recorded waveform played back one virtual-time step at a time, with
+    // several steps per sample, from a memory-mapped CSV or binary file.
+    // Steady playback should not allocate.
+    const int sampleCount = 1000000;
+    const double sampleInterval = 1e-3;
+    const int stepsPerRun = 100000;
+
+    for (bool binary : {false, true}) {
+        auto file = std::make_shared<std::unique_ptr<QTemporaryFile>>();
+        auto stream = std::make_shared<std::unique_ptr<SampleStream>>();
+        auto time = std::make_shared<double>(0.0);
+
+        BenchmarkCase playback;
+        playback.name = binary ? "SampleStream/playback_binary" : "SampleStream/playback_csv";
+        playback.params["samples"] = sampleCount;
+        playback.setup = [file, stream, binary, sampleCount, sampleInterval]() {
+            if (*stream) {
+                return;
+            }
+            file->reset(new QTemporaryFile(QDir::tempPath() + "/samples_XXXXXX"));
+            if (!(*file)->open()) {
+                return;
+            }
+
+            QByteArray block;
+            for (int i = 0; i < sampleCount; ++i) {
+                double sample[2] = {i * sampleInterval, double(i % 1024)};
+                if (binary) {
+                    block.append(reinterpret_cast<const char*>(sample), sizeof(sample));
+                } else {
+                    block.append(QByteArray::number(sample[0], 'f', 6));
+                    block.append(',');
+                    block.append(QByteArray::number(sample[1], 'f', 3));
+                    block.append('\n');
+                }
+                if (block.size() > 1024 * 1024) {
+                    (*file)->write(block);
+                    block.clear();
+                }
+            }
+            (*file)->write(block);
+            (*file)->flush();
+
+            stream->reset(new SampleStream());
+            (*stream)->open((*file)->fileName(), binary ? SampleStream::Binary : SampleStream::Csv);
+        };
+        playback.run = [stream, time, sampleInterval, stepsPerRun]() -> qint64 {
+            SampleStream* samples = stream->get();
+            double sum = 0.0;
+            for (int step = 0; step < stepsPerRun; ++step) {
+                sum += samples->valueAt(*time);
+                *time += sampleInterval / 4;
+                if (*time > samples->getEndTime()) {
+                    *time = 0.0;
+                }
+            }
+            return sum >= 0.0 ? stepsPerRun : 0;
+        };
+        playback.teardown = [file, stream, time]() {
+            stream->reset();
+            file->reset();
+            *time = 0.0;
+        };
+        runner.addCase(playback);
+    }
+}
+
+void SimulationBenchmarks::registerAccuracyCases(AccuracyHarness &harness)
+{
+    typedef std::function<bool(CircuitGenerator&, Circuit*)> Builder;
+    struct Shape {
+        QString name;
+        int size;
+        Builder build;
+    };
+
+    const QVector<Shape> shapes = {
+        {"mesh", 12, [](CircuitGenerator &g, Circuit *c) { return g.buildResistorMesh(c, 12); }},
+        {"ladder", 200, [](CircuitGenerator &g, Circuit *c) { return g.buildResistorLadder(c, 200); }},
+        {"random_graph", 200, [](CircuitGenerator &g, Circuit *c) { return g.buildRandomGraph(c, 200); }},
+        {"led_matrix", 8, [](CircuitGenerator &g, Circuit *c) { return g.buildLedMatrix(c, 8, 8); }},
+        {"islands", 30, [](CircuitGenerator &g, Circuit *c) { return g.buildArduinoIslands(c, 30); }}
+    };
+
+    for (const Shape &shape : shapes) {
+        Builder build = shape.build;
+
+        AccuracyCase accuracyCase;
+        accuracyCase.name = "Accuracy/" + shape.name;
+        accuracyCase.params["size"] = shape.size;
+        accuracyCase.steps = 5;
+        accuracyCase.build = [build](Circuit *circuit) {
+            CircuitGenerator generator;
+            return build(generator, circuit);
+        };
+        harness.addCase(accuracyCase);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("SimulationBenchmarks");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Micro-benchmarks for the simulation core");
+    parser.addHelpOption();
+
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                    "Write JSON results to <file>.", "file",
+                                    "benchmark_results.json");
+    QCommandLineOption filterOption(QStringList() << "f" << "filter",
+                                    "Only run cases whose name contains <text>.", "text");
+    QCommandLineOption repetitionsOption(QStringList() << "r" << "repetitions",
+                                         "Repetitions per case.", "count", "10");
+    parser.addOption(outputOption);
+    parser.addOption(filterOption);
+    QCommandLineOption skipAccuracyOption("skip-accuracy",
+                                          "Do not check results against the reference solver.");
+    parser.addOption(repetitionsOption);
+    QCommandLineOption traceOption(QStringList() << "t" << "trace",
+                                   "Write a Chrome trace of the run to <file> "
+                                   "(needs a build with ENABLE_TRACING).", "file");
+    QCommandLineOption perfOption(QStringList() << "p" << "perf-counters",
+                                  "Read hardware performance counters around each case "
+                                  "(Linux, needs perf_event_open permission).");
+    parser.addOption(skipAccuracyOption);
+    parser.addOption(traceOption);
+    parser.addOption(perfOption);
+    parser.process(app);
+
+    BenchmarkRunner runner;
+    runner.setFilter(parser.value(filterOption));
+    runner.setRepetitions(parser.value(repetitionsOption).toInt());
+    if (parser.isSet(perfOption)) {
+        runner.enablePerfCounters();
+    }
+
+    SimulationBenchmarks::registerCases(runner);
+    runner.run();
+
+    // Fast paths must not change answers
+    bool accurate = true;
+    if (!parser.isSet(skipAccuracyOption)) {
+        AccuracyHarness harness;
+        harness.setFilter(parser.value(filterOption));
+        SimulationBenchmarks::registerAccuracyCases(harness);
+        accurate = harness.run();
+        runner.setSection("accuracy", harness.toJson());
+    }
+
+    if (parser.isSet(traceOption)) {
+        Tracing::writeChromeTrace(parser.value(traceOption));
+    }
+
+    QString output = parser.value(outputOption);
+    if (!runner.writeJson(output, "simulation")) {
+        return 1;
+    }
+
+    QTextStream(stdout) << "Results written to " << output << "\n";
+    return accurate ? 0 : 2;
+}
@@ -9,6 +9,7 @@
 #include "ArduinoPin.h"
 
 class Circuit;
+class QDataStream;
 
 class Arduino : public QObject
 {
@@ -57,6 +58,11 @@ public:
     void analogWrite(int pin, int value);
     int analogRead(int pin);
 
+    // Stand-in for a WS2812 bit-bang routine (Adafruit_NeoPixel::show()):
+    // the GRB bytes reach the strip as one transaction instead of 24 edges
+    // per pixel at 800 kHz
+    void ws2812Show(int pin, const QByteArray &grb);
+
     // Advanced pin functions
     void analogReference(int type);
     unsigned long pulseIn(int pin, int value, unsigned long timeout = 1000000);
@@ -93,6 +99,10 @@ public:
     void stopSketch();
     bool isSketchRunning() const { return m_sketchRunning; }
 
+    // Checkpointing of board-level state (pins are saved as circuit components)
+    void saveState(QDataStream &out) const;
+    void restoreState(QDataStream &in);
+
 signals:
     void pinModeChanged(int pin, int mode);
     void pinValueChanged(int pin, double value);
@@ -57,9 +57,18 @@ public:
     void updateState(double voltage, double current) override;
     void reset() override;
 
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
     // Pin reading/writing (for sketch simulation)
     virtual double readPin() const;
     virtual void writePin(double value);
+    
+    // When the sketch wrote the pin (ResponseLatency::now()), for latency
+    // tracking. Cleared once taken, so other pin changes aren't mistaken
+    // for a new write; 0 if there is no write since the last take.
+    qint64 takeWriteTimestamp() { qint64 ns = m_lastWriteNs; m_lastWriteNs = 0; return ns; }
 
 signals:
     void pinModeChanged(PinMode mode);
@@ -88,6 +97,7 @@ protected:
     double m_outputResistance;  // Internal resistance when outputting
     double m_inputResistance;   // Input impedance when reading
     bool m_isOverloaded;
+    qint64 m_lastWriteNs;
     
     // Supply voltages
     static constexpr double VCC = 5.0;  // Arduino supply voltage
@@ -114,6 +124,19 @@ public:
     // Pin state
     bool getDigitalState() const { return m_digitalState; }
 
+    // Send a serial frame to the devices on this pin's net at transaction
+    // level; the line is left low as after the frame's reset gap. Returns
+    // the number of devices that accepted it.
+    int writeFrame(const QByteArray &data);
+
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+    // Logic-level output unless PWM is running (PWM is modeled by its
+    // average voltage); digital input in INPUT and INPUT_PULLUP
+    TerminalRole getTerminalRole(int terminal) const override;
+
 protected:
     void updateOutputState() override;
     void updateInputState() override;
@@ -156,6 +179,10 @@ public:
     double getReference() const { return m_referenceVoltage; }
     void setReference(double voltage) { m_referenceVoltage = voltage; }
 
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
 protected:
     void updateOutputState() override;
     void updateInputState() override;
@@ -0,0 +1,64 @@
+#ifndef BREADBOARD_H
+#define BREADBOARD_H
+
+#include "ElectricalComponent.h"
+
+// Solderless breadboard. Holes are grouped into the board's fixed strips:
+// the a-e and f-j halves of every column and the four power rails. Each
+// strip is one terminal, so a wire ending in a hole joins the strip's net
+// directly; there are no per-hole links or wires to stamp, and a strip
+// with nothing wired to it has no node at all. Jumpers are ordinary wires
+// between holes. Strip terminals are PassiveTerminals and are never
+// stamped, and they don't keep a net from being digital.
+class Breadboard : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    enum Size {
+        HalfSize,       // 30 columns
+        FullSize        // 63 columns
+    };
+
+    // Hole rows, top to bottom
+    enum Row {
+        TopPositiveRail,
+        TopNegativeRail,
+        RowA, RowB, RowC, RowD, RowE,
+        RowF, RowG, RowH, RowI, RowJ,
+        BottomPositiveRail,
+        BottomNegativeRail,
+        RowCount
+    };
+
+    explicit Breadboard(Size size = FullSize, QObject *parent = nullptr);
+
+    Size getSize() const { return m_size; }
+    int getColumns() const { return m_columns; }
+
+    // Holes are numbered row-major
+    int getHoleCount() const { return RowCount * m_columns; }
+    int hole(int row, int column) const { return row * m_columns + column; }
+    int holeRow(int hole) const { return hole / m_columns; }
+    int holeColumn(int hole) const { return hole % m_columns; }
+    bool isValidHole(int hole) const { return hole >= 0 && hole < getHoleCount(); }
+
+    // Strips: a-e of each column, then f-j of each column, then the rails
+    int getStripCount() const { return 2 * m_columns + 4; }
+    int stripOfHole(int hole) const;
+
+    // Terminal that carries the net of a hole
+    int netTerminal(int hole) const { return stripOfHole(hole); }
+
+    // Strips connect nets without loading them; the board is never stamped
+    double getResistance() const override { return OpenResistance; }
+    TerminalRole getTerminalRole(int terminal) const override;
+
+    static constexpr double OpenResistance = 1e12;
+
+private:
+    Size m_size;
+    int m_columns;
+};
+
+#endif // BREADBOARD_H
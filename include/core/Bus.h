@@ -0,0 +1,49 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include "ElectricalComponent.h"
+#include <QVector>
+
+// Group of parallel wires carried by one component, e.g. an 8-bit data
+// bus. Line i joins terminal fromTerminal(i) to terminal toTerminal(i):
+// the first width terminals are one end of the bus, the next width the
+// other end. The simulator stamps all lines in one pass instead of one
+// Wire per line.
+class Bus : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    explicit Bus(int width = 8, QObject *parent = nullptr);
+
+    int getWidth() const { return m_width; }
+    int fromTerminal(int line) const { return line; }
+    int toTerminal(int line) const { return m_width + line; }
+
+    // Every line is an ideal wire, like Wire
+    double getResistance() const override { return IDEAL_RESISTANCE; }
+
+    // Per-line state from the last solve
+    double getLineVoltage(int line) const { return m_lineVoltage.value(line); }
+    double getLineCurrent(int line) const { return m_lineCurrent.value(line); }
+
+    // Update every line from its voltage drop (from end to to end). The
+    // component's own voltage and current become the largest drop and
+    // current on any line, so convergence checks see every line.
+    void updateLines(const double *voltageDrops);
+
+    void reset() override;
+
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+    static constexpr double IDEAL_RESISTANCE = 1e-6;
+
+private:
+    int m_width;
+    QVector<double> m_lineVoltage;
+    QVector<double> m_lineCurrent;
+};
+
+#endif // BUS_H
@@ -0,0 +1,85 @@
+#ifndef DIGITALCOMPONENT_H
+#define DIGITALCOMPONENT_H
+
+#include "ElectricalComponent.h"
+#include <QVector>
+
+// Base for behavioral logic ICs (gates, multiplexers, shift registers).
+//
+// Terminals are the inputs followed by the outputs; supply pins are not
+// modeled. Nothing is evaluated per time step: evaluate() runs only when
+// an input crosses the logic threshold, and componentChanged() is emitted
+// only when an output level actually changes, so an IC with idle inputs
+// costs nothing. Towards the analog solver an input is a high resistance
+// to ground and an enabled output a Norton source (LogicHigh or 0 V behind
+// the output resistance). A disabled (high-Z) output is stamped like an
+// input.
+class DigitalComponent : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    DigitalComponent(const QString &name, int inputCount, int outputCount, QObject *parent = nullptr);
+
+    int getInputCount() const { return m_inputs.size(); }
+    int getOutputCount() const { return m_outputs.size(); }
+    bool isInputTerminal(int terminal) const { return terminal >= 0 && terminal < m_inputs.size(); }
+    int outputTerminal(int output) const { return m_inputs.size() + output; }
+
+    bool getInput(int input) const { return m_inputs.value(input); }
+    bool getOutput(int output) const { return m_outputs.value(output); }
+    virtual bool isOutputEnabled(int output) const;
+
+    // Electrical model
+    double getResistance() const override { return m_inputResistance; }
+    double getInputResistance() const { return m_inputResistance; }
+    void setInputResistance(double resistance);
+    double getOutputResistance() const { return m_outputResistance; }
+    void setOutputResistance(double resistance);
+
+    // Norton equivalent of a terminal: conductance to ground and the
+    // current it injects into the node
+    double getTerminalConductance(int terminal) const;
+    double getTerminalCurrent(int terminal) const;
+
+    // Mixed-signal interface
+    TerminalRole getTerminalRole(int terminal) const override;
+    bool getDigitalOutput(int terminal) const override;
+    void digitalInputChanged(int terminal, bool level) override;
+
+    // Input edges evaluated since construction or reset
+    quint64 getEvaluationCount() const { return m_evaluationCount; }
+
+    void reset() override;
+
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+protected:
+    // An input changed level; getInput() already returns the new level.
+    // Implementations set outputs with setOutput().
+    virtual void evaluate(int input, bool level) = 0;
+
+    // Recompute outputs from the current inputs (construction, reset)
+    virtual void evaluateAll() = 0;
+
+    void setOutput(int output, bool level);
+
+    // Level an unconnected input reads (active-low controls idle high)
+    void setInputDefault(int input, bool level);
+
+    // Emit componentChanged() if outputs changed since the last call
+    void commitOutputs();
+
+private:
+    QVector<bool> m_inputs;
+    QVector<bool> m_defaultInputs;
+    QVector<bool> m_outputs;
+    bool m_outputsDirty;
+    double m_inputResistance;
+    double m_outputResistance;
+    quint64 m_evaluationCount;
+};
+
+#endif // DIGITALCOMPONENT_H
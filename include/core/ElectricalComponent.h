@@ -5,12 +5,27 @@
 #include <QVector>
 
 class Node;
+class QDataStream;
+class QByteArray;
 
 class ElectricalComponent : public Component
 {
     Q_OBJECT
 
 public:
+    // How a terminal interacts with its net. Nets joining one digital
+    // output to digital inputs only are taken out of the analog solve and
+    // updated by event-driven propagation instead (MixedSignalPartition).
+    enum TerminalRole {
+        AnalogTerminal,     // Stamped into the MNA system
+        DigitalOutput,      // Drives a logic level from a low impedance
+        DigitalInput,       // Reads a logic level at high impedance
+        PassiveTerminal     // Joins the net without loading it (breadboard strip)
+    };
+
+    static constexpr double LogicHigh = 5.0;
+    static constexpr double LogicThreshold = 2.5;
+
     explicit ElectricalComponent(const QString &name, int terminalCount = 2, QObject *parent = nullptr);
 
     // Electrical properties
@@ -27,12 +42,33 @@ public:
     // Simulation updates
     virtual void updateState(double voltage, double current);
 
+    // Mixed-signal interface; everything is analog by default
+    virtual TerminalRole getTerminalRole(int terminal) const;
+    virtual bool getDigitalOutput(int terminal) const;
+    
+    // Logic level on a DigitalInput terminal changed, either on a digital
+    // net or across the threshold of an analog net
+    virtual void digitalInputChanged(int terminal, bool level);
+
+    // Transaction-level data (a whole serial frame instead of its edges)
+    // arriving on a DigitalInput terminal. Returns false if not understood.
+    virtual bool receiveTransaction(int terminal, const QByteArray &data);
+
     void reset() override;
 
+    // Checkpointing: serialize the complete simulation state. Derived
+    // classes append their own fields after calling the base version.
+    virtual void saveState(QDataStream &out) const;
+    virtual void restoreState(QDataStream &in);
+
 signals:
     void stateChanged(double voltage, double current);
 
 protected:
+    // Deliver a frame to every DigitalInput on the terminal's net; returns
+    // the number of receivers that accepted it
+    int transmit(int terminal, const QByteArray &data);
+
     QVector<Node*> m_terminals;
     double m_voltage;
     double m_current;
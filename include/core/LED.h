@@ -24,6 +24,7 @@ public:
     // Electrical parameters
     double getForwardVoltage() const { return m_forwardVoltage; }
     void setForwardVoltage(double voltage);
+    double getForwardCurrent() const { return m_forwardCurrent; }
     
     double getMaxCurrent() const { return m_maxCurrent; }
     void setMaxCurrent(double current);
@@ -35,9 +36,23 @@ public:
     // Reset to initial state
     void reset() override;
 
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
     // Factory method for common LED types
     static LED* createStandardLED(const QString &type, QObject *parent = nullptr);
 
+    // State computed outside the LED (LedBatch evaluates many at once);
+    // signals changes like updateState()
+    void setEvaluatedState(double voltage, double current, double brightness, double resistance);
+
+    // LED model parameters
+    static constexpr double OFF_RESISTANCE = 1e6;    // Very high when off
+    static constexpr double MIN_CONDUCTION_CURRENT = 1e-6; // Minimum detectable current
+    static constexpr double SERIES_RESISTANCE = 25.0; // Bulk resistance when conducting
+    static constexpr double BRIGHTNESS_SATURATION = 0.3; // Log gain above rated current
+
 signals:
     void ledStateChanged(bool isOn, double brightness);
     void overloadDetected();
@@ -45,6 +60,7 @@ signals:
 private:
     void calculateElectricalState();
     void checkOverloadCondition();
+    void finishUpdate(bool wasOn, double prevBrightness);
     double calculateBrightness(double current) const;
     double calculateDynamicResistance(double current) const;
 
@@ -63,9 +79,6 @@ private:
     bool m_isOverloaded;
     double m_thermalLimit;      // Maximum power dissipation
     
-    // LED model parameters
-    static constexpr double OFF_RESISTANCE = 1e6;    // Very high when off
-    static constexpr double MIN_CONDUCTION_CURRENT = 1e-6; // Minimum detectable current
     static constexpr double THERMAL_VOLTAGE = 0.026; // kT/q at room temperature
 };
 
@@ -0,0 +1,76 @@
+#ifndef LEDMATRIX_H
+#define LEDMATRIX_H
+
+#include "ElectricalComponent.h"
+#include <QColor>
+#include <QVector>
+
+// Row-anode LED matrix (8x8, 16x16, ...) as a single component.
+//
+// Terminals are the rows (anodes) followed by the columns (cathodes); the
+// diode at (row, column) sits between the two. The diodes use the same
+// empirical model as LED, but their state lives in flat per-diode arrays
+// (structure of arrays, row-major) that are updated by one branch-free
+// loop the compiler can vectorize. The simulator stamps the whole
+// conductance array as one block, and one graphics item draws it.
+class LedMatrix : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    explicit LedMatrix(int rows = 8, int columns = 8, const QColor &color = Qt::red, QObject *parent = nullptr);
+
+    int getRows() const { return m_rows; }
+    int getColumns() const { return m_columns; }
+    int getDiodeCount() const { return m_rows * m_columns; }
+    int rowTerminal(int row) const { return row; }
+    int columnTerminal(int column) const { return m_rows + column; }
+
+    const QColor &getColor() const { return m_color; }
+    double getForwardVoltage() const { return m_forwardVoltage; }
+
+    // Per-diode state, row-major
+    const QVector<double>& getConductances() const { return m_conductance; }
+    const QVector<double>& getBrightness() const { return m_brightness; }
+    double getBrightness(int row, int column) const { return m_brightness.value(row * m_columns + column); }
+    bool isLit(int row, int column) const { return getBrightness(row, column) > 0.0; }
+
+    // Block-level view for the rest of the simulator: the aggregate is an
+    // open circuit; the diodes are stamped individually
+    double getResistance() const override { return OffResistance; }
+
+    // Update every diode from the solved row and column voltages
+    // (nodes not in the solve read as 0 V). Sets the component's voltage
+    // to the mean diode voltage and its current to the total current.
+    void evaluate(const double *rowVoltages, const double *columnVoltages);
+
+    void reset() override;
+
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+    static constexpr double OffResistance = 1e6;
+    static constexpr double SeriesResistance = 25.0;
+    static constexpr double MinConductionCurrent = 1e-6;
+
+signals:
+    // Some diode's brightness changed by more than 1%
+    void matrixChanged();
+
+private:
+    int m_rows;
+    int m_columns;
+    QColor m_color;
+    double m_forwardVoltage;
+    double m_forwardCurrent;
+
+    // Structure of arrays, one entry per diode
+    QVector<double> m_diodeVoltage;
+    QVector<double> m_diodeCurrent;
+    QVector<double> m_conductance;
+    QVector<double> m_brightness;
+    QVector<double> m_previousBrightness;
+};
+
+#endif // LEDMATRIX_H
@@ -0,0 +1,88 @@
+#ifndef LEDSTRIP_H
+#define LEDSTRIP_H
+
+#include "ElectricalComponent.h"
+#include <QVector>
+#include <QByteArray>
+#include <QRgb>
+
+// WS2812 addressable LED strip, simulated at the protocol level.
+//
+// Terminals: DIN, DOUT, VDD and GND. Pixel data arrives on DIN either as
+// a whole frame (receiveTransaction(), e.g. from Arduino::ws2812Show()) or
+// as timestamped edges from a scheduled waveform (decodeEdge()). Each
+// pixel takes the first 3 GRB bytes and the rest is passed on through
+// DOUT, so daisy-chained strips work. Colors are kept in one packed array
+// for the renderer. Towards the analog solver the whole strip is a single
+// conductance between VDD and GND that draws the current of the displayed
+// colors.
+class LedStrip : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    enum Terminal {
+        DataIn = 0,
+        DataOut,
+        Supply,
+        Ground
+    };
+
+    // WS2812B datasheet timing
+    static const qint64 BitThresholdNs = 625;   // High time separating 0 (0.4 us) from 1 (0.8 us)
+    static const qint64 ResetNs = 50000;        // Low time that latches a frame
+
+    static constexpr double NominalVoltage = 5.0;
+    static constexpr double ChannelCurrent = 0.020;     // Per color channel at full brightness
+    static constexpr double IdleCurrent = 0.001;        // Per pixel, all channels off
+    static constexpr double DataInputResistance = 1e9;
+    static constexpr double DataOutputResistance = 50.0;
+
+    explicit LedStrip(int pixelCount = 60, QObject *parent = nullptr);
+
+    int getPixelCount() const { return m_pixels.size(); }
+    QRgb getPixel(int index) const { return m_pixels.value(index); }
+    const QVector<QRgb>& getPixels() const { return m_pixels; }
+    quint64 getFrameCount() const { return m_frameCount; }
+
+    // Electrical model: one aggregated load between VDD and GND
+    double getResistance() const override { return 1.0 / getSupplyConductance(); }
+    double getSupplyConductance() const;
+    double getSupplyCurrent() const;    // At NominalVoltage
+
+    // Mixed-signal interface
+    TerminalRole getTerminalRole(int terminal) const override;
+    bool getDigitalOutput(int terminal) const override;
+    bool receiveTransaction(int terminal, const QByteArray &data) override;
+
+    // Feed one DIN edge of a WS2812 waveform. Bits are decoded from the
+    // high time, a low time of ResetNs or more latches the frame. A low
+    // sample repeated after the gap latches without another rising edge.
+    void decodeEdge(bool level, qint64 timeNs);
+
+    void reset() override;
+
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+signals:
+    // Emitted once per latched frame that changed any pixel
+    void pixelsChanged();
+
+private:
+    void latchDecodedFrame();
+
+    QVector<QRgb> m_pixels;         // 0xffRRGGBB
+    int m_channelSum;               // Sum of all color bytes, for the supply current
+    quint64 m_frameCount;
+
+    // Edge decoder state
+    QByteArray m_decoded;
+    quint8 m_bitCount;
+    quint8 m_currentByte;
+    bool m_lineHigh;
+    qint64 m_lastEdgeNs;
+};
+
+#endif // LEDSTRIP_H
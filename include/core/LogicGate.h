@@ -0,0 +1,42 @@
+#ifndef LOGICGATE_H
+#define LOGICGATE_H
+
+#include "DigitalComponent.h"
+
+// Combinational gate with N inputs (terminals 0..N-1) and one output
+// (terminal N). NOT and buffer gates have a single input.
+class LogicGate : public DigitalComponent
+{
+    Q_OBJECT
+
+public:
+    enum GateType {
+        And,
+        Or,
+        Nand,
+        Nor,
+        Xor,
+        Xnor,
+        Not,
+        Buffer
+    };
+
+    explicit LogicGate(GateType type = And, int inputCount = 2, QObject *parent = nullptr);
+
+    GateType getGateType() const { return m_type; }
+    static const char* typeName(GateType type);
+
+    void restoreState(QDataStream &in) override;
+
+protected:
+    void evaluate(int input, bool level) override;
+    void evaluateAll() override;
+
+private:
+    bool outputFor(int highInputs) const;
+
+    GateType m_type;
+    int m_highInputs;   // Inputs currently high; makes an edge O(1)
+};
+
+#endif // LOGICGATE_H
@@ -0,0 +1,45 @@
+#ifndef MULTIPLEXER_H
+#define MULTIPLEXER_H
+
+#include "DigitalComponent.h"
+
+// Data selector in the style of the 74HC151 (3 select bits).
+//
+// Terminals: data inputs D0..D(2^n-1), select inputs S0..S(n-1), the
+// active-low enable E, then outputs Y and its complement W. With E high
+// Y is low and W high. A change on an unselected data input does nothing.
+class Multiplexer : public DigitalComponent
+{
+    Q_OBJECT
+
+public:
+    static const int MaxSelectBits = 4;
+
+    explicit Multiplexer(int selectBits = 3, QObject *parent = nullptr);
+
+    int getSelectBits() const { return m_selectBits; }
+    int getDataInputCount() const { return 1 << m_selectBits; }
+
+    // Terminal numbers
+    int dataTerminal(int index) const { return index; }
+    int selectTerminal(int bit) const { return getDataInputCount() + bit; }
+    int enableTerminal() const { return getDataInputCount() + m_selectBits; }
+    int outputY() const { return outputTerminal(0); }
+    int outputW() const { return outputTerminal(1); }
+
+    int getSelected() const { return m_selected; }
+
+    void restoreState(QDataStream &in) override;
+
+protected:
+    void evaluate(int input, bool level) override;
+    void evaluateAll() override;
+
+private:
+    void updateOutputs();
+
+    int m_selectBits;
+    int m_selected;     // Data input routed to Y
+};
+
+#endif // MULTIPLEXER_H
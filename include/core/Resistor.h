@@ -17,6 +17,10 @@ public:
     // Power calculation
     double getPower() const { return m_voltage * m_current; }
 
+    // Checkpointing
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
 private:
     double m_resistance; // Ohms
 };
@@ -0,0 +1,84 @@
+#ifndef SAMPLEDSOURCE_H
+#define SAMPLEDSOURCE_H
+
+#include "ElectricalComponent.h"
+#include "simulation/SampleStream.h"
+
+// Plays back a recorded sensor waveform (thermistor, LDR, accelerometer
+// axis, ...) on the simulator's virtual clock. Samples stream from a
+// memory-mapped file through SampleStream and are interpolated at the
+// current time; file values become volts or ohms through
+// value * scale + offset. As a voltage source the component is a Norton
+// equivalent behind the source resistance, so it can drive a divider or
+// an analog input directly; as a variable resistor it is a plain
+// conductance. With no file loaded the value is the offset.
+class SampledSource : public ElectricalComponent
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        VoltageSource,
+        VariableResistor
+    };
+
+    enum Terminal {
+        Positive,
+        Negative
+    };
+
+    explicit SampledSource(Mode mode = VoltageSource, QObject *parent = nullptr);
+
+    Mode getMode() const { return m_mode; }
+
+    // Recording
+    bool load(const QString &fileName);
+    void unload();
+    bool isLoaded() const { return m_stream.isOpen(); }
+    QString getFileName() const { return m_stream.getFileName(); }
+    const SampleStream &getStream() const { return m_stream; }
+
+    // File value to volts or ohms
+    double getScale() const { return m_scale; }
+    void setScale(double scale);
+    double getOffset() const { return m_offset; }
+    void setOffset(double offset);
+
+    // Restart from the beginning when the recording ends
+    bool isLooping() const { return m_looping; }
+    void setLooping(bool looping) { m_looping = looping; }
+
+    // Move playback to a virtual time; returns true if the value changed
+    bool setTime(double time);
+    double getTime() const { return m_time; }
+    double getValue() const { return m_value; }
+
+    // Electrical model
+    double getResistance() const override;
+    double getSourceResistance() const { return m_sourceResistance; }
+    void setSourceResistance(double resistance);
+    double getSourceCurrent() const;
+
+    void reset() override;
+
+    // Checkpointing (the file itself is not saved; playback re-seeks
+    // from the restored time)
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+    static constexpr double MinimumResistance = 1e-3;
+
+private:
+    double sampleAt(double time);
+
+    Mode m_mode;
+    SampleStream m_stream;
+    double m_scale;
+    double m_offset;
+    bool m_looping;
+    double m_sourceResistance;
+    double m_time;
+    double m_value;
+};
+
+#endif // SAMPLEDSOURCE_H
@@ -0,0 +1,48 @@
+#ifndef SHIFTREGISTER_H
+#define SHIFTREGISTER_H
+
+#include "DigitalComponent.h"
+
+// 74HC595: 8-bit serial-in shift register with an output storage latch.
+//
+// Terminals: SER, SRCLK, RCLK, SRCLR (active low), OE (active low), then
+// outputs Q0..Q7 and the serial output Q7'. A rising SRCLK shifts SER into
+// bit 0, a rising RCLK copies the shift register to Q0..Q7, SRCLR low
+// clears the shift register and OE high puts Q0..Q7 in high-Z. Q7' always
+// drives.
+class ShiftRegister : public DigitalComponent
+{
+    Q_OBJECT
+
+public:
+    enum Input {
+        SerialIn = 0,
+        ShiftClock,
+        LatchClock,
+        Clear,
+        OutputEnable
+    };
+
+    static const int Bits = 8;
+    static const int SerialOut = Bits;  // Output index of Q7'
+
+    explicit ShiftRegister(QObject *parent = nullptr);
+
+    quint8 getShiftRegister() const { return m_shift; }
+    quint8 getStorageRegister() const { return m_storage; }
+
+    bool isOutputEnabled(int output) const override;
+
+    void saveState(QDataStream &out) const override;
+    void restoreState(QDataStream &in) override;
+
+protected:
+    void evaluate(int input, bool level) override;
+    void evaluateAll() override;
+
+private:
+    quint8 m_shift;
+    quint8 m_storage;
+};
+
+#endif // SHIFTREGISTER_H
@@ -6,6 +6,7 @@
 #include <QHash>
 #include <QMutex>
 #include <QSet>
+#include "simulation/Subcircuit.h"
 
 class Component;
 class Node;
@@ -15,6 +16,7 @@ class ArduinoPin;
 class LED;
 class Resistor;
 class Wire;
+class Bus;
 
 class Circuit : public QObject
 {
@@ -26,8 +28,12 @@ public:
 
     // Component management
     void addComponent(Component *component);
+    void addComponents(const QVector<Component*> &components); // Bulk insert, one change notification
     void removeComponent(Component *component);
     const QVector<Component*> &getComponents() const { return m_components; }
+    
+    // Changes whenever a component is added or removed, batched or not
+    quint64 getComponentRevision() const { return m_componentRevision; }
 
     // Node management
     Node *createNode();
@@ -51,10 +57,31 @@ public:
     void removeWire(Wire* wire);
     const QVector<Wire*> &getWires() const { return m_wires; }
 
+    // Bus management: one Bus joins fromNodes[i] to toNodes[i] for every
+    // line, instead of one Wire per line
+    Bus* addBus(const QVector<Node*>& fromNodes, const QVector<Node*>& toNodes);
+    void removeBus(Bus* bus);
+    const QVector<Bus*> &getBuses() const { return m_buses; }
+
+    // Joins width consecutive terminals of comp1, starting at terminal1,
+    // to the matching terminals of comp2 as one edit (one circuitChanged)
+    bool connectBus(Component* comp1, int terminal1,
+                    Component* comp2, int terminal2, int width);
+
+    // Subcircuit instancing: ports[i] binds the template's port i. The
+    // template is compiled on first use; every instance of a call lands in
+    // one circuitChanged(). Returns an instance with no components on error.
+    SubcircuitInstance instantiate(SubcircuitTemplate& subcircuit,
+                                   const QVector<Node*>& ports, const QString& name);
+    QVector<SubcircuitInstance> instantiate(SubcircuitTemplate& subcircuit,
+                                            const QVector<QVector<Node*>>& ports,
+                                            const QString& namePrefix);
+
     // Arduino integration methods
     bool connectArduinoPin(Arduino* arduino, int pinNumber, Node* node);
     bool connectArduinoPinByName(Arduino* arduino, const QString& pinName, Node* node);
     void disconnectArduinoPin(Arduino* arduino, int pinNumber);
+    QVector<Arduino*> getArduinos() const; // Boards with pins in this circuit
 
     // Circuit validation
     bool validateConnections() const;
@@ -70,11 +97,20 @@ public:
     void removeAllComponents();
     void clearArduinoConnections(Arduino* arduino);
 
+    // Undoable editing: removes the component from the circuit without
+    // deleting it, so it can be added back with addComponent()
+    void detachComponent(Component* component);
+
     // Simulation status
     bool isSimulationRunning() const { return m_simulationRunning; }
 
     // Circuit changes
     void componentChanged(Component *component);
+    
+    // Batched editing: circuitChanged() is held back until the outermost
+    // endUpdate() and then emitted once. Node signals are not deferred.
+    void beginUpdate();
+    void endUpdate();
 
     // Simulator integration
     void setSimulator(CircuitSimulator* simulator) { m_simulator = simulator; }
@@ -87,12 +123,22 @@ public slots:
     void onSimulationStep(int step, double time);
 
 signals:
-    void circuitChanged();
+    void circuitChanged();                              // Topology changed
+    void nodeAdded(Node* node);
+    void nodeRemoved(Node* node);                       // Emitted before deletion
+    void componentValueChanged(Component* component);   // Parameters/state only
 
 private:
+    bool insertComponent(Component *component);
+    bool placeInstance(const SubcircuitTemplate &subcircuit, const QVector<Node*> &ports,
+                       SubcircuitInstance &instance);
+    void notifyCircuitChanged();
+    
     QVector<Component*> m_components;
+    quint64 m_componentRevision;
     QVector<Node*> m_nodes;
     QVector<Wire*> m_wires;
+    QVector<Bus*> m_buses;
     CircuitSimulator *m_simulator;
     bool m_simulationRunning;
     QMutex m_circuitMutex;
@@ -104,6 +150,10 @@ private:
 
     // External component tracking (components owned by other objects like Arduino)
     QSet<Component*> m_externalComponents;
+    
+    // Batched editing
+    int m_updateDepth;
+    bool m_changePending;
 };
 
 #endif // CIRCUIT_H
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef CIRCUITGENERATOR_H
+#define CIRCUITGENERATOR_H
+
+#include <QVector>
+#include <QRandomGenerator>
+#include "core/Arduino.h"
+
+class Circuit;
+class Node;
+
+// Builds parameterized synthetic circuits through the Circuit API, for
+// benchmarks and stress tests. Every build call reseeds the generator, so
+// the same seed and parameters always produce the same circuit (component
+// values, pin levels, graph edges) whatever was generated before.
+// Components and boards are created as children of the target circuit;
+// building into an empty circuit is the expected use. Topology signals
+// are batched, so each build emits circuitChanged() once.
+class CircuitGenerator
+{
+public:
+    explicit CircuitGenerator(quint32 seed = 1);
+
+    void setSeed(quint32 seed) { m_seed = seed; }
+    quint32 getSeed() const { return m_seed; }
+
+    // Relative spread of generated resistor values, e.g. 0.05 for +/-5%
+    void setTolerance(double tolerance) { m_tolerance = tolerance; }
+    double getTolerance() const { return m_tolerance; }
+
+    // size x size grid of nodes joined by resistors to their right and
+    // lower neighbours; an Arduino pin drives one corner and the opposite
+    // corner is grounded
+    bool buildResistorMesh(Circuit *circuit, int size, double resistance = 1000.0);
+
+    // rows x columns LEDs multiplexed by a MEGA: row pins drive the anodes,
+    // column pins sink the cathodes through one resistor per column. Rows
+    // and columns are randomly enabled to form one multiplexing frame.
+    // With aggregate set the LEDs are one LedMatrix component instead of
+    // rows x columns discrete LEDs.
+    bool buildLedMatrix(Circuit *circuit, int rows, int columns, bool aggregate = false);
+
+    // R-2R ladder of the given number of stages driven by an Arduino pin
+    bool buildResistorLadder(Circuit *circuit, int stages, double resistance = 1000.0);
+
+    // Connected random graph of nodeCount nodes (plus ground) with resistor
+    // edges of log-uniform value and the given average node degree. A
+    // random spanning tree keeps every node reachable from the source.
+    bool buildRandomGraph(Circuit *circuit, int nodeCount, double averageDegree = 3.0);
+
+    // count independent UNOs, each driving pin 13 -> LED -> resistor to
+    // ground at a random level; islands share only the ground node
+    bool buildArduinoIslands(Circuit *circuit, int count);
+
+private:
+    void reseed();
+    double spread(double value);
+    double logUniform(double minimum, double maximum);
+
+    // Powered board with its ground pin tied to circuit ground
+    Arduino *createBoard(Circuit *circuit, Arduino::BoardType boardType);
+    void drivePin(Circuit *circuit, Arduino *arduino, int pin, bool level, Node *node);
+
+    QVector<Node*> createNodes(Circuit *circuit, int count);
+
+    quint32 m_seed;
+    double m_tolerance;
+    QRandomGenerator m_random;
+};
+
+#endif // CIRCUITGENERATOR_H
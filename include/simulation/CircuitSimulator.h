@@ -9,10 +9,24 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QMutex>
+#include "simulation/SimulatorSnapshot.h"
+#include "simulation/SimulationMetrics.h"
+#include "simulation/ResponseLatency.h"
+#include "simulation/UpdateScheduler.h"
+#include "simulation/MixedSignalPartition.h"
+#include "simulation/LedBatch.h"
 
 class Circuit;
 class Component;
 class ElectricalComponent;
+class DigitalComponent;
+class LedStrip;
+class LedMatrix;
+class Bus;
+class Breadboard;
+class SampledSource;
+class ArduinoPin;
+class LED;
 class Node;
 class MatrixSolver;
 
@@ -36,31 +50,85 @@ public:
     void setConvergenceTolerance(double tolerance) { m_convergenceTolerance = tolerance; }
     double getConvergenceTolerance() const { return m_convergenceTolerance; }
     
-    void setTimeStep(double timeStep) { m_timeStep = timeStep; }
+    void setTimeStep(double timeStep) { m_timeStep = timeStep; m_scheduler.setTimeStep(timeStep); }
     double getTimeStep() const { return m_timeStep; }
     
-    // Minimum update interval to prevent excessive updates
-    void setMinUpdateInterval(int msecs) { m_minUpdateIntervalMs = msecs; }
-    int getMinUpdateInterval() const { return m_minUpdateIntervalMs; }
+    // Topology edits update node indexing in place, leaving holes where
+    // nodes were removed; past this fraction of holes the indexing is
+    // rebuilt from scratch
+    void setMaxFragmentation(double fraction) { m_maxFragmentation = fraction; }
+    double getMaxFragmentation() const { return m_maxFragmentation; }
+    
+    // Use the slow extended-precision reference solver (accuracy checks)
+    void setReferenceMode(bool enabled);
+    bool isReferenceMode() const;
+    
+    // Coalescing of change notifications and Newton budget per update,
+    // adapted to measured solve cost (see UpdateScheduler)
+    UpdateScheduler& getScheduler() { return m_scheduler; }
+    const UpdateScheduler& getScheduler() const { return m_scheduler; }
+    
+    // Fixed minimum update interval; switches the scheduler to its Fixed policy
+    void setMinUpdateInterval(int msecs)
+    {
+        m_scheduler.setFixedInterval(msecs);
+        m_scheduler.setPolicy(UpdateScheduler::Fixed);
+    }
+    int getMinUpdateInterval() const { return m_scheduler.getUpdateInterval(); }
+    
+    // Propagate purely digital nets as events instead of solving them
+    // (see MixedSignalPartition); takes effect on the next initialization
+    void setDigitalFastPath(bool enabled);
+    bool isDigitalFastPath() const { return m_partition.isEnabled(); }
+    const MixedSignalPartition& getPartition() const { return m_partition; }
     
     // Simulation stats
     int getIterationCount() const { return m_iterationCount; }
     double getSimulationTime() const { return m_simulationTime; }
+    int getFullRebuildCount() const { return m_fullRebuildCount; }
+    int getIncrementalEditCount() const { return m_incrementalEditCount; }
+    
+    // Per-phase timings and solver statistics, updated after every step.
+    // Safe to call from any thread without locking.
+    SimulationMetricsSnapshot getMetrics() const { return m_metrics.snapshot(); }
+    void resetMetrics() { m_metrics.reset(); }
+    
+    // Append the metrics as a JSON line to fileName every intervalMs
+    void startMetricsDump(const QString &fileName, int intervalMs = 1000);
+    void stopMetricsDump();
+    
+    // Pin write to LED response latency, per pipeline stage. Safe to read
+    // from any thread.
+    const ResponseLatency& getResponseLatency() const { return m_responseLatency; }
+    void resetResponseLatency() { m_responseLatency.reset(); }
     
     // Circuit access
     Circuit* getCircuit() const { return m_circuit; }
+    
+    // Solved voltage of a node after the last step
+    double getNodeVoltage(Node *node) const;
+    
+    // Checkpointing. Passing the previous snapshot as base lets unchanged
+    // state pages be shared instead of stored again. Call between steps,
+    // from the thread the simulator lives in.
+    SimulatorSnapshot saveSnapshot(const SimulatorSnapshot &base = SimulatorSnapshot());
+    bool restoreSnapshot(const SimulatorSnapshot &snapshot);
 
 public slots:
     void start();
     void stop();
     void reset();
-    void step();
+    // Returns false if the step failed and simulation time did not advance
+    bool step();
     
     // Trigger update - handles recursion prevention
     void triggerUpdate();
     
     // Handle component changes
     void onCircuitChanged();
+    void onComponentValueChanged(Component *component);
+    void onNodeAdded(Node *node);
+    void onNodeRemoved(Node *node);
 
 signals:
     void simulationStarted();
@@ -74,16 +142,27 @@ signals:
 private slots:
     // Actual update function called after debouncing
     void doUpdate();
+    
+    void writeMetricsDump();
 
 private:
+    // Benchmarks time the individual pipeline stages
+    friend class SimulationBenchmarks;
+    
     // Matrix building and solving
     bool buildMatrices();
     bool updateComponentStates();
     bool hasConverged();
     
     // Utility functions
+    void classifyComponents();
     void assignNodeIds();
     int getNodeCount() const;
+    void publishMetrics(bool converged, qint64 stepNs);
+    
+    // Checkpointing helpers
+    QVector<ElectricalComponent*> getElectricalComponents() const;
+    uint computeTopologySignature() const;
     
     // Current circuit state
     Circuit *m_circuit;
@@ -91,6 +170,35 @@ private:
     
     // Node mapping (Node object to matrix index)
     QHash<Node*, int> m_nodeIndices;
+    QVector<int> m_freeIndices;     // Indices of removed nodes, pinned to 0 V
+    int m_indexCount;               // Matrix dimension including holes
+    double m_maxFragmentation;
+    int m_fullRebuildCount;
+    int m_incrementalEditCount;
+    
+    // Components sorted by how they are stamped, so the Newton loop never
+    // casts; rebuilt when the circuit's component revision moves on
+    quint64 m_classifiedRevision;
+    bool m_classified;
+    QVector<ElectricalComponent*> m_electricalComponents;  // Circuit order
+    QVector<DigitalComponent*> m_digitalComponents;
+    QVector<LedStrip*> m_ledStrips;
+    QVector<Breadboard*> m_breadboards;
+    QVector<Bus*> m_buses;
+    QVector<LedMatrix*> m_ledMatrices;
+    QVector<LED*> m_leds;
+    QVector<SampledSource*> m_sampledSources;
+    QVector<ArduinoPin*> m_arduinoPins;
+    QVector<ElectricalComponent*> m_linearComponents;      // Other one- and two-terminal parts
+    
+    // Discrete LEDs of the current iteration, filled while stamping
+    LedBatch m_ledBatch;
+    
+    // Per-iteration scratch for LED matrices, sized to the largest one
+    QVector<int> m_matrixColumnIndices;
+    QVector<double> m_matrixRowVoltages;
+    QVector<double> m_matrixColumnVoltages;
+    QVector<double> m_busDrops;     // Per line of the bus being updated
     
     // Previous voltage/current values for convergence check
     QHash<ElectricalComponent*, QPair<double, double>> m_prevValues;
@@ -99,7 +207,13 @@ private:
     int m_maxIterations;
     double m_convergenceTolerance;
     double m_timeStep;
-    int m_minUpdateIntervalMs;
+    UpdateScheduler m_scheduler;
+    int m_iterationBudget;          // Newton limit of the running update, 0 for none
+    bool m_budgetExhausted;         // Last solve ran out of budget before converging
+    
+    // Digital nets outside the matrix, and the A/D and D/A boundaries
+    MixedSignalPartition m_partition;
+    bool m_boundaryPending;         // A D/A boundary changed during the running update
     
     // Simulation state
     bool m_running;
@@ -113,6 +227,12 @@ private:
     QElapsedTimer m_lastUpdateTime;
     QTimer m_updateTimer;
     
+    // Statistics
+    SimulationMetrics m_metrics;
+    ResponseLatency m_responseLatency;
+    QTimer m_metricsDumpTimer;
+    QString m_metricsDumpFile;
+    
     // Thread safety
     QMutex m_simulationMutex;
 };
@@ -0,0 +1,60 @@
+#ifndef LANEMATRIXSOLVER_H
+#define LANEMATRIXSOLVER_H
+
+#include <QVector>
+
+// Dense nodal solver for several systems with the same dimension, solved
+// together. Every matrix entry and right-hand side value is stored as 4 or
+// 8 consecutive lane values, one per system, so each step of stamping,
+// elimination and substitution is the same arithmetic on a short
+// contiguous block that the compiler turns into vector instructions.
+//
+// Each lane pivots on its own (partial pivoting, like MatrixSolver's
+// fallback path); the pivot search and row exchange are per lane, the
+// elimination itself is not. Rows whose multipliers are zero in every
+// lane are skipped, so a shared stamp pattern keeps its sparsity benefit.
+// A lane that turns out singular is marked failed and finishes with a
+// unit pivot, so its neighbours are unaffected.
+class LaneMatrixSolver
+{
+public:
+    LaneMatrixSolver();
+
+    // 4 or 8; discards the stored system
+    void setLaneCount(int lanes);
+    int getLaneCount() const { return m_lanes; }
+
+    void setDimension(int dimension);
+    int getDimension() const { return m_dimension; }
+
+    // Zero the system, keeping the storage
+    void clear();
+
+    // Same stamps as MatrixSolver, each taking one value per lane
+    // (node -1 is ground)
+    void addConductance(int nodeA, int nodeB, const double *conductance);
+    void addCurrentSource(int nodeA, int nodeB, const double *current);
+    void setNodeVoltage(int node, const double *voltage);
+
+    // Solves every lane; false if any lane was singular
+    bool solve();
+    bool isLaneSolved(int lane) const;
+
+    double getNodeVoltage(int node, int lane) const;
+    const double *getNodeVoltages(int node) const;      // One per lane
+
+    static constexpr int MaxLanes = 8;
+
+private:
+    int m_lanes;
+    int m_dimension;
+    double m_epsilon;
+
+    // Entry (row, column) of lane l at (row * dimension + column) * lanes + l
+    QVector<double> m_matrix;
+    QVector<double> m_rightHandSide;
+    QVector<double> m_solution;
+    unsigned m_failedLanes;     // Bit per lane, from the last solve()
+};
+
+#endif // LANEMATRIXSOLVER_H
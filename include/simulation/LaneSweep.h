@@ -0,0 +1,107 @@
+#ifndef LANESWEEP_H
+#define LANESWEEP_H
+
+#include "simulation/LaneMatrixSolver.h"
+#include "simulation/LedBatch.h"
+#include <QHash>
+#include <QVector>
+
+class Circuit;
+class Component;
+class Node;
+class LED;
+class ArduinoPin;
+
+// DC operating points of one circuit for 4 or 8 parameter sets at once,
+// for Monte Carlo runs and parameter sweeps. compile() flattens the
+// circuit into the stamps CircuitSimulator would make, with one value per
+// lane; set*() then changes a value in a single lane. solve() runs the
+// Newton loop for all lanes in lockstep on a LaneMatrixSolver: stamping,
+// the LED model (LedBatch::model over diode x lane) and the convergence
+// test all work on lane blocks. Lanes that converge early keep iterating
+// until the slowest one is done, which leaves their result unchanged.
+//
+// Lanes share the topology, so only values can vary; which pins act as
+// sources is taken from the circuit at compile(). Digital ICs, LED strips
+// and matrices, breadboards and sampled sources are not supported. The
+// circuit is only read, and a sweep shares nothing else, so sweeps on
+// separate threads are independent as long as the circuit is not edited
+// while they run.
+class LaneSweep
+{
+public:
+    explicit LaneSweep(Circuit *circuit, int lanes = 4);
+
+    int getLaneCount() const { return m_solver.getLaneCount(); }
+
+    // Every lane starts from the circuit's present values; fails on
+    // components the sweep cannot model
+    bool compile();
+    bool isCompiled() const { return m_compiled; }
+
+    // Per-lane values; false if the component has no such value here
+    bool setResistance(Component *component, int lane, double resistance);
+    bool setSourceVoltage(ArduinoPin *pin, int lane, double voltage);
+    bool setForwardVoltage(LED *led, int lane, double voltage);
+
+    // Operating point of every lane, continuing from the last one; true
+    // if all lanes converged
+    bool solve();
+    bool isLaneConverged(int lane) const;
+    int getIterationCount() const { return m_iterationCount; }
+
+    // Results of the last solve()
+    double getNodeVoltage(Node *node, int lane) const;
+    double getCurrent(Component *component, int lane) const;
+    double getBrightness(LED *led, int lane) const;
+
+    void setMaxIterations(int iterations) { m_maxIterations = iterations; }
+    void setConvergenceTolerance(double tolerance) { m_convergenceTolerance = tolerance; }
+
+private:
+    enum StampKind {
+        ConductanceStamp,       // Between nodeA and nodeB (-1 is ground)
+        SourceStamp             // nodeA pinned to a voltage
+    };
+
+    struct Stamp {
+        StampKind kind;
+        int nodeA;
+        int nodeB;
+    };
+
+    int addStamp(StampKind kind, int nodeA, int nodeB, double value);
+    int laneIndex(const QHash<const Component*, int> &indices, const Component *component, int lane) const;
+
+    Circuit *m_circuit;
+    LaneMatrixSolver m_solver;
+    bool m_compiled;
+    int m_maxIterations;
+    double m_convergenceTolerance;
+    int m_iterationCount;
+    unsigned m_convergedLanes;      // Bit per lane
+
+    QHash<Node*, int> m_nodeIndices;
+
+    // Linear stamps in circuit order; value of stamp s in lane l at
+    // s * lanes + l
+    QVector<Stamp> m_stamps;
+    QVector<double> m_stampValues;
+    QHash<const Component*, int> m_stampOf;
+
+    // Diodes, lane-interleaved like the stamps
+    QVector<int> m_ledAnode;
+    QVector<int> m_ledCathode;
+    QVector<LedBatch::Parameters> m_ledParameters;
+    QVector<double> m_ledVoltage;
+    QVector<double> m_ledCurrent;
+    QVector<double> m_ledResistance;
+    QVector<double> m_ledBrightness;
+    QHash<const Component*, int> m_ledOf;
+
+    // Convergence history, node x lane and diode x lane
+    QVector<double> m_previousVoltage;
+    QVector<double> m_previousCurrent;
+};
+
+#endif // LANESWEEP_H
@@ -0,0 +1,49 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+#include <QVector>
+
+// Log-linear histogram of durations in nanoseconds. Each power of two is
+// split into SubBuckets linear buckets, so percentiles are within 1/8 of
+// the true value from 1 ns up to ~3 days with a few hundred counters and
+// no allocation per sample. Not thread-safe; record from one thread.
+class LatencyHistogram
+{
+public:
+    static const int SubBucketBits = 3;
+    static const int SubBuckets = 1 << SubBucketBits;
+    static const int MaxExponent = 47;
+    static const int BucketCount = (MaxExponent - SubBucketBits + 2) * SubBuckets;
+
+    LatencyHistogram();
+
+    void record(qint64 ns);
+    void reset();
+
+    quint64 getCount() const { return m_count; }
+    qint64 getMin() const { return m_count ? m_min : 0; }
+    qint64 getMax() const { return m_max; }
+    double getMean() const { return m_count ? double(m_sum) / double(m_count) : 0.0; }
+
+    // Value at or below which the fraction p (0..1) of samples fall
+    qint64 percentile(double p) const;
+
+    // Bucket access for plotting
+    quint64 getBucketCount(int bucket) const { return m_buckets[bucket]; }
+    static qint64 bucketLowerBound(int bucket);
+    static int bucketFor(qint64 ns);
+
+    // count, min, mean, p50, p90, p99, max and the non-empty buckets
+    QJsonObject toJson() const;
+
+private:
+    QVector<quint64> m_buckets;
+    quint64 m_count;
+    qint64 m_sum;
+    qint64 m_min;
+    qint64 m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,65 @@
+#ifndef LEDBATCH_H
+#define LEDBATCH_H
+
+#include <QVector>
+
+class LED;
+class MatrixSolver;
+
+// Discrete LEDs of a circuit evaluated together instead of one virtual
+// updateState() call at a time. While stamping, the simulator collects
+// every connected LED into flat per-device arrays and stamps their
+// conductances in one pass; after the solve, evaluate() gathers the diode
+// voltages and runs the LED model for all of them in one branch-free loop
+// the compiler can vectorize, with a polynomial log in place of std::log.
+// Each LED then receives its result. The batch is refilled on every
+// stamping pass, so it never outlives a topology edit.
+//
+// The read-only model parameters are packed per device; as separate
+// arrays they would need more runtime alias checks than GCC versions a
+// loop for, and the loop would stay scalar.
+class LedBatch
+{
+public:
+    void clear();
+    void add(LED *led, int anode, int cathode);
+    int size() const { return m_leds.size(); }
+
+    // Every LED's conductance at its present dynamic resistance
+    void stamp(MatrixSolver *solver) const;
+
+    // Model update from the solution; must follow the stamping pass that
+    // filled the batch
+    void evaluate(const MatrixSolver *solver);
+
+    struct Parameters {
+        double forwardVoltage;
+        double forwardCurrent;
+        double saturationScale;     // 1 / (max - forward current), 0 if none
+    };
+    static Parameters parametersOf(const LED *led);
+
+    // The LED model over count diodes: from the diode voltages and present
+    // resistances, the currents, brightness and next resistances. Also
+    // used by LaneSweep, whose diodes are lane copies.
+    static void model(int count, const Parameters *parameters, const double *voltage,
+                      double *current, double *resistance, double *brightness);
+
+    // Natural log of x > 0 from its exponent and a series on the
+    // mantissa; relative error below 1e-9, no branches
+    static double fastLog(double x);
+
+private:
+    QVector<LED*> m_leds;
+    QVector<int> m_anode;
+    QVector<int> m_cathode;
+    QVector<Parameters> m_parameters;
+
+    // State
+    QVector<double> m_voltage;
+    QVector<double> m_current;
+    QVector<double> m_resistance;
+    QVector<double> m_brightness;
+};
+
+#endif // LEDBATCH_H
@@ -46,14 +46,40 @@ public:
     double getNodeVoltage(int node) const;
     double getBranchCurrent(int nodeA, int nodeB) const;
     
+    // Whole solution vector, for snapshots; setSolution() ignores a vector
+    // of the wrong dimension
+    QVector<double> getSolution() const;
+    bool setSolution(const QVector<double> &solution);
+    
     // Get the number of nodes
     int getDimension() const { return m_dimension; }
     
+    // Allocated dimension; growing up to it reuses the existing storage
+    int getCapacity() const { return m_capacity; }
+    
     // Check if the matrix is consistent and well-conditioned
     bool isValid() const;
+    
+    // Solve with long double Gaussian elimination and full pivoting instead
+    // of the production path. Much slower; meant as the golden reference
+    // that faster solve paths are checked against.
+    void setReferenceMode(bool enabled) { m_referenceMode = enabled; }
+    bool isReferenceMode() const { return m_referenceMode; }
+    
+    // Statistics of the last solve()
+    qint64 getLastFactorizationNs() const { return m_lastFactorizationNs; }
+    qint64 getLastSubstitutionNs() const { return m_lastSubstitutionNs; }
+    qint64 getLastNonZeros() const { return m_lastNonZeros; }             // Stamped entries
+    qint64 getLastFactorNonZeros() const { return m_lastFactorNonZeros; } // Entries of the factors
+    
+    // Dimension changes, and how many of them had to reallocate storage
+    quint64 getResizeCount() const { return m_resizeCount; }
+    quint64 getReallocationCount() const { return m_reallocationCount; }
 
 private:
     void setupMatrices();
+    bool solveReference();
+    qint64 countNonZeros() const;
 
 #ifdef HAVE_EIGEN3
     // Implementation using Eigen (preferred)
@@ -75,8 +101,18 @@ private:
 
     // Common attributes
     int m_dimension;           // Number of nodes in the circuit
+    int m_capacity;            // Dimension the storage is allocated for
     bool m_isSetup;            // Whether matrices are initialized
     double m_epsilon;          // Small value for numerical stability
+    bool m_referenceMode;      // Solve with the reference solver
+    
+    // Statistics
+    qint64 m_lastFactorizationNs;
+    qint64 m_lastSubstitutionNs;
+    qint64 m_lastNonZeros;
+    qint64 m_lastFactorNonZeros;
+    quint64 m_resizeCount;
+    quint64 m_reallocationCount;
     
     // Mapping to track branch currents
     struct BranchKey {
@@ -0,0 +1,120 @@
+#ifndef MIXEDSIGNALPARTITION_H
+#define MIXEDSIGNALPARTITION_H
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <functional>
+#include "core/ElectricalComponent.h"
+
+class Circuit;
+class Node;
+
+// Splits a circuit into digital nets and the analog rest.
+//
+// A net is digital when exactly one terminal drives it as DigitalOutput
+// and every other terminal on it is a DigitalInput (an Arduino output
+// pin wired to input pins or logic IC inputs); PassiveTerminals such as
+// breadboard strips don't count either way. Digital nets are left out
+// of the MNA system. When a driver changes, its nets are re-evaluated as
+// events: the new level is set on the node and delivered to the inputs,
+// whose reactions may queue further events.
+//
+// Digital terminals on analog nets are the boundary elements:
+//  - D/A: a DigitalOutput on an analog net is stamped like any other
+//    source (Norton equivalent) and solved with the analog island
+//  - A/D: a DigitalInput on an analog net is thresholded after each
+//    converged solve and raises an input edge when its level flips
+class MixedSignalPartition
+{
+public:
+    struct Terminal
+    {
+        ElectricalComponent *component;
+        int terminal;
+    };
+
+    struct DigitalNet
+    {
+        Node *node;
+        Terminal driver;
+        QVector<Terminal> loads;
+        int connectionCount;    // Node connections when classified
+        int level;              // -1 until first evaluated
+    };
+
+    struct Boundary
+    {
+        Terminal terminal;
+        Node *node;             // Analog node on the other side
+        int level;              // Last thresholded level (A/D), -1 if unknown
+    };
+
+    MixedSignalPartition();
+
+    // Classify all nets of the circuit (ground is never digital) and queue
+    // every digital net for evaluation on the next propagate()
+    void build(Circuit *circuit);
+    void clear();
+
+    // Disabled, every net is solved as analog; digital terminals still
+    // become boundaries so logic components see their input edges
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    bool isDigital(Node *node) const { return m_netOfNode.contains(node); }
+    const QVector<DigitalNet>& getDigitalNets() const { return m_nets; }
+    const QVector<Boundary>& getAnalogToDigital() const { return m_analogToDigital; }
+    const QVector<Boundary>& getDigitalToAnalog() const { return m_digitalToAnalog; }
+
+    // Component drives at least one digital output terminal
+    bool hasDigitalOutputs(ElectricalComponent *component) const { return m_outputComponents.contains(component); }
+
+    // All of the component's connected terminals are on digital nets, so
+    // its changes never need an analog solve
+    bool isDigitalOnly(ElectricalComponent *component) const { return m_digitalOnly.contains(component); }
+
+    // Terminal roles differ from when the partition was built (pin mode
+    // change, PWM started), so the partition must be rebuilt
+    bool rolesChanged(ElectricalComponent *component) const;
+
+    // Connections of a digital net changed since it was classified
+    bool isStale() const;
+
+    // Queue the nets a driver feeds and, unless already inside a
+    // propagation, process the queue. Returns the nets whose level changed.
+    int driverChanged(ElectricalComponent *component);
+    int propagate();
+
+    // Forget all known levels and re-evaluate every net, e.g. after the
+    // component state was restored from a snapshot
+    int resync();
+
+    // Threshold the A/D boundaries against solved node voltages and raise
+    // input edges; queued follow-up events are propagated
+    int sampleBoundaries(const std::function<double(Node*)> &voltageOf);
+
+    quint64 getEventCount() const { return m_eventCount; }
+
+private:
+    static const int MaxEventsPerPropagation = 100000;
+
+    void enqueue(int net);
+
+    bool m_enabled;
+    QVector<DigitalNet> m_nets;
+    QHash<Node*, int> m_netOfNode;
+    QHash<ElectricalComponent*, QVector<int>> m_drivenNets;
+    QHash<ElectricalComponent*, QVector<ElectricalComponent::TerminalRole>> m_roles;
+    QSet<ElectricalComponent*> m_outputComponents;
+    QSet<ElectricalComponent*> m_digitalOnly;
+    QVector<Boundary> m_analogToDigital;
+    QVector<Boundary> m_digitalToAnalog;
+
+    QVector<int> m_queue;
+    QVector<bool> m_queued;
+    bool m_propagating;
+    quint64 m_eventCount;
+};
+
+#endif // MIXEDSIGNALPARTITION_H
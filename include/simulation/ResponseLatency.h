@@ -0,0 +1,72 @@
+#ifndef RESPONSELATENCY_H
+#define RESPONSELATENCY_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+#include <QMutex>
+#include "simulation/LatencyHistogram.h"
+
+// Stimulus-to-response latency through the simulator pipeline:
+//
+//   pin write -> componentChanged -> simulator notified     (Notify)
+//             -> triggerUpdate throttling -> doUpdate       (Throttle)
+//             -> solve() returns                            (Solve)
+//   pin write -> first LED state change in that update      (LedResponse)
+//   pin write -> solve() returns                            (Total)
+//
+// Writes that arrive while an update is already queued are coalesced into
+// it; the stages are measured from the oldest of them, which waited
+// longest. Recording is cheap and lock-protected so histograms can be
+// read from another thread.
+class ResponseLatency
+{
+public:
+    enum Stage {
+        Notify = 0,
+        Throttle,
+        Solve,
+        LedResponse,
+        Total,
+        StageCount
+    };
+
+    ResponseLatency();
+
+    // Monotonic nanoseconds; the clock stimulus timestamps must use
+    static qint64 now();
+    static const char* stageName(Stage stage);
+
+    // Pipeline events, in order
+    void stimulus(qint64 writtenNs, qint64 notifiedNs);
+    void beginUpdate(qint64 ns);
+    void response(qint64 ns);
+    void endUpdate(qint64 ns);
+
+    // True while an update is carrying a stimulus whose LED response has
+    // not been seen yet
+    bool isAwaitingResponse() const { return m_inFlight && !m_responded; }
+
+    LatencyHistogram getHistogram(Stage stage) const;
+    void reset();
+
+    // Per stage: count, p50/p90/p99/max and buckets
+    QJsonObject toJson() const;
+
+private:
+    Q_DISABLE_COPY(ResponseLatency)
+
+    mutable QMutex m_mutex;
+    LatencyHistogram m_stages[StageCount];
+
+    // Oldest stimulus not yet picked up by an update
+    qint64 m_pendingWrittenNs;      // -1 if none
+    qint64 m_pendingNotifiedNs;
+
+    // Stimulus carried by the running update
+    bool m_inFlight;
+    bool m_responded;
+    qint64 m_inFlightWrittenNs;
+    qint64 m_updateStartNs;
+};
+
+#endif // RESPONSELATENCY_H
@@ -0,0 +1,118 @@
+#ifndef SAMPLESTREAM_H
+#define SAMPLESTREAM_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Time-stamped samples read straight from a memory-mapped file, for
+// playing back recorded sensor waveforms. Two formats are understood:
+//
+//   Csv     one "time,value" pair per line (comma, semicolon, tab or
+//           space separated); blank lines, '#' comments and a header
+//           line are skipped
+//   Binary  consecutive records of two little-endian doubles (time,
+//           value), as written by most data loggers' raw export
+//
+// Times are in seconds and must not decrease. Only a window of the file
+// is mapped at a time and the cursor moves with the playback time, so a
+// recording of any size streams with bounded address space and without
+// allocating per sample. Seeking backwards (reset, snapshot restore) is a
+// binary search for binary files and a resume from the nearest
+// checkpoint for CSV files; one checkpoint is kept per
+// CheckpointInterval lines.
+class SampleStream
+{
+    struct Sample {
+        double time;
+        double value;
+    };
+
+public:
+    enum Format {
+        Csv,
+        Binary
+    };
+
+    SampleStream();
+    ~SampleStream();
+
+    // Format defaults from the extension: ".bin", ".dat" and ".raw" are
+    // binary, everything else CSV
+    bool open(const QString &fileName);
+    bool open(const QString &fileName, Format format);
+    void close();
+    bool isOpen() const { return m_isOpen; }
+
+    QString getFileName() const { return m_file.fileName(); }
+    Format getFormat() const { return m_format; }
+    qint64 getFileSize() const { return m_fileSize; }
+
+    // Recorded time span
+    double getStartTime() const { return m_first.time; }
+    double getEndTime() const { return m_last.time; }
+    double getDuration() const { return m_last.time - m_first.time; }
+
+    // Value at a time, linearly interpolated between the neighbouring
+    // samples; held at the first or last sample outside the recording
+    double valueAt(double time);
+
+    // Bytes mapped at a time (default 16 MiB)
+    void setWindowSize(qint64 bytes);
+    qint64 getWindowSize() const { return m_windowSize; }
+
+    static constexpr int CheckpointInterval = 4096;
+    static constexpr int MaxLineLength = 256;
+
+private:
+    struct Checkpoint {
+        double time;
+        qint64 offset;
+    };
+
+    Q_DISABLE_COPY(SampleStream)
+
+    // Pointer to length bytes at offset, remapping the window if needed;
+    // available is set to the bytes readable there (less at end of file)
+    const char *map(qint64 offset, qint64 length, qint64 *available);
+    void unmapWindow();
+
+    // Binary records
+    qint64 recordCount() const { return m_fileSize / qint64(sizeof(Sample)); }
+    bool readRecord(qint64 index, Sample &sample);
+    void seekRecord(double time);
+    bool advanceRecord();
+
+    // CSV lines: parses the first sample at or after offset and returns
+    // the offset after its line, or -1 at end of file
+    qint64 readLine(qint64 offset, Sample &sample);
+    void seekLine(double time);
+    bool advanceLine();
+    bool findLastLine(Sample &sample);
+
+    QFile m_file;
+    Format m_format;
+    bool m_isOpen;
+    qint64 m_fileSize;
+
+    // Mapped window
+    qint64 m_windowSize;
+    uchar *m_window;
+    qint64 m_windowOffset;
+    qint64 m_windowLength;
+
+    Sample m_first;
+    Sample m_last;
+
+    // Cursor: the samples around the last requested time
+    Sample m_current;
+    Sample m_next;
+    bool m_hasNext;
+    qint64 m_record;        // Binary: index of m_current
+    qint64 m_nextOffset;    // Csv: offset of the line after m_next
+    qint64 m_lineNumber;    // Csv: data line number of m_next
+
+    QVector<Checkpoint> m_checkpoints;
+};
+
+#endif // SAMPLESTREAM_H
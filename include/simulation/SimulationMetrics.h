@@ -0,0 +1,102 @@
+#ifndef SIMULATIONMETRICS_H
+#define SIMULATIONMETRICS_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+#include <atomic>
+
+// Plain copy of the simulator metrics at one point in time. Times are
+// cumulative nanoseconds since the last reset.
+struct SimulationMetricsSnapshot
+{
+    enum Phase {
+        Stamping = 0,       // buildMatrices()
+        Factorization,      // Matrix decomposition
+        Substitution,       // Forward/back substitution
+        StateUpdate,        // updateComponentStates()
+        ConvergenceCheck,   // hasConverged()
+        PhaseCount
+    };
+
+    quint64 steps;
+    quint64 iterations;             // Newton iterations over all steps
+    quint64 convergenceFailures;    // Steps that hit the iteration limit
+    qint64 phaseNs[PhaseCount];
+    qint64 stepNs;                  // Wall time inside solve()
+
+    // Last step
+    int lastIterations;
+    qint64 lastStepNs;
+
+    // Node indexing reuse across topology edits
+    quint64 fullRebuilds;
+    quint64 incrementalEdits;
+
+    // Solver storage reuse across dimension changes
+    quint64 solverResizes;
+    quint64 solverReallocations;
+
+    // Matrix of the last solve
+    int dimension;
+    qint64 nonZeros;            // Stamped entries
+    qint64 factorNonZeros;      // Entries of the factors
+
+    double iterationsPerStep() const;
+    double indexReuseRate() const;      // Edits handled without a rebuild
+    double solverStorageReuseRate() const;
+    qint64 fillIn() const { return factorNonZeros - nonZeros; }
+
+    QJsonObject toJson() const;
+};
+
+// Metrics updated by CircuitSimulator on every step. There is a single
+// writer (the simulator's thread); any thread may call snapshot() without
+// locking. A sequence counter makes each snapshot internally consistent:
+// readers retry if a step was published while they were copying.
+class SimulationMetrics
+{
+public:
+    typedef SimulationMetricsSnapshot::Phase Phase;
+
+    SimulationMetrics();
+
+    SimulationMetricsSnapshot snapshot() const;
+    void reset();   // Writer side only
+
+    // Writer side: accumulate into the pending step, then publish it
+    void addPhaseTime(Phase phase, qint64 ns) { m_pending.phaseNs[phase] += ns; }
+    void setMatrixStats(int dimension, qint64 nonZeros, qint64 factorNonZeros);
+    void setTopologyCounts(quint64 fullRebuilds, quint64 incrementalEdits);
+    void setSolverCounts(quint64 resizes, quint64 reallocations);
+    void publishStep(int iterations, bool converged, qint64 stepNs);
+
+private:
+    void publish();
+
+    template<typename T>
+    static T load(const std::atomic<T> &value) { return value.load(std::memory_order_relaxed); }
+    template<typename T>
+    static void store(std::atomic<T> &value, T v) { value.store(v, std::memory_order_relaxed); }
+
+    // Writer-local accumulation for the step in progress
+    SimulationMetricsSnapshot m_pending;
+
+    // Published values
+    std::atomic<unsigned> m_sequence;
+    std::atomic<quint64> m_steps;
+    std::atomic<quint64> m_iterations;
+    std::atomic<quint64> m_convergenceFailures;
+    std::atomic<qint64> m_phaseNs[SimulationMetricsSnapshot::PhaseCount];
+    std::atomic<qint64> m_stepNs;
+    std::atomic<int> m_lastIterations;
+    std::atomic<qint64> m_lastStepNs;
+    std::atomic<quint64> m_fullRebuilds;
+    std::atomic<quint64> m_incrementalEdits;
+    std::atomic<quint64> m_solverResizes;
+    std::atomic<quint64> m_solverReallocations;
+    std::atomic<int> m_dimension;
+    std::atomic<qint64> m_nonZeros;
+    std::atomic<qint64> m_factorNonZeros;
+};
+
+#endif // SIMULATIONMETRICS_H
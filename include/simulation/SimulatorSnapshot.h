@@ -0,0 +1,50 @@
+#ifndef SIMULATORSNAPSHOT_H
+#define SIMULATORSNAPSHOT_H
+
+#include <QVector>
+#include <QByteArray>
+
+// Complete, restorable state of a CircuitSimulator and the Arduinos in its
+// circuit: virtual time, node voltages, every component's electrical state
+// and pin modes/values. Component state is stored in fixed-size pages of
+// serialized data. Pages (and the node voltage vector) are implicitly
+// shared Qt containers, and a snapshot taken relative to a previous one
+// reuses every page whose contents did not change, so a chain of snapshots
+// only pays for what differs. Copying a snapshot never copies page data.
+class SimulatorSnapshot
+{
+public:
+    SimulatorSnapshot();
+
+    bool isValid() const { return m_valid; }
+
+    double getSimulationTime() const { return m_simulationTime; }
+    int getComponentCount() const { return m_componentCount; }
+    int getPageCount() const { return m_pages.size(); }
+
+    // Number of pages whose data is physically shared with another snapshot
+    int getSharedPageCount(const SimulatorSnapshot &other) const;
+
+    // Approximate memory held by this snapshot's own data
+    qint64 getByteSize() const;
+
+    // Components per state page
+    static const int PAGE_SIZE = 64;
+
+private:
+    friend class CircuitSimulator;
+
+    bool m_valid;
+    uint m_topologySignature;   // Detects restoring into a different circuit
+    int m_componentCount;
+
+    double m_simulationTime;
+    int m_iterationCount;
+
+    QVector<double> m_nodeVoltages;
+    QVector<double> m_solution;     // Solver state, by matrix index
+    QVector<QByteArray> m_pages;    // Component state, PAGE_SIZE per page
+    QByteArray m_arduinoState;      // Board-level state of every Arduino
+};
+
+#endif // SIMULATORSNAPSHOT_H
@@ -0,0 +1,88 @@
+#ifndef SPEEDCONTROLLER_H
+#define SPEEDCONTROLLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class CircuitSimulator;
+
+// Paces the simulation clock against wall time by stepping the simulator
+// from a timer, so a circuit runs at 1x, in slow motion (0.1x to watch
+// PWM) or as fast as possible.
+//
+// Each tick steps until simulated time reaches targetRatio * elapsed wall
+// time, spending at most the catch-up budget. After a hiccup the backlog is
+// worked off over the following ticks. Backlog beyond maxLag simulated
+// seconds is dropped, so a long stall is not followed by a long burst.
+// In unbounded mode (ratio <= 0) the controller steps in long slices and
+// returns to the event loop only between them. LED and pin updates are then
+// painted a few times per second instead of every frame.
+class SpeedController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SpeedController(CircuitSimulator *simulator, QObject *parent = nullptr);
+
+    // Simulated seconds per wall second; 0 or less runs unbounded
+    void setTargetRatio(double ratio);
+    double getTargetRatio() const { return m_targetRatio; }
+    bool isUnbounded() const { return m_targetRatio <= 0.0; }
+
+    // Wall time one tick may spend catching up
+    void setCatchUpBudget(int msecs) { m_catchUpBudgetMs = qMax(1, msecs); }
+    int getCatchUpBudget() const { return m_catchUpBudgetMs; }
+
+    // Simulated seconds of backlog kept after a hiccup
+    void setMaxLag(double seconds) { m_maxLag = qMax(0.0, seconds); }
+    double getMaxLag() const { return m_maxLag; }
+
+    // Measured over the last report interval
+    double getAchievedRatio() const { return m_achievedRatio; }
+
+    // Time steps given up because the backlog exceeded maxLag
+    qint64 getDroppedSteps() const { return m_droppedSteps; }
+
+    bool isRunning() const { return m_timer.isActive(); }
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    // Emitted every ReportIntervalMs while running
+    void ratioUpdated(double achievedRatio, double simulationTime);
+
+private slots:
+    void tick();
+
+private:
+    void anchor();
+    void report(qint64 nowNs);
+
+    static const int FrameIntervalMs = 16;      // Bounded mode tick
+    static const int UnboundedSliceMs = 200;    // Stepping between event loop turns
+    static const int ReportIntervalMs = 250;
+
+    CircuitSimulator *m_simulator;
+    QTimer m_timer;
+    QElapsedTimer m_wallClock;
+
+    double m_targetRatio;
+    int m_catchUpBudgetMs;
+    double m_maxLag;
+
+    // Clock anchor: simulated time m_simOrigin corresponds to wall time
+    // m_wallOriginNs; moved when backlog is dropped or the ratio changes
+    double m_simOrigin;
+    qint64 m_wallOriginNs;
+
+    // Achieved ratio window
+    double m_reportSimTime;
+    qint64 m_reportWallNs;
+    double m_achievedRatio;
+    qint64 m_droppedSteps;
+};
+
+#endif // SPEEDCONTROLLER_H
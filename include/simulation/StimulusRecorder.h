@@ -0,0 +1,102 @@
+#ifndef STIMULUSRECORDER_H
+#define STIMULUSRECORDER_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include "simulation/SimulatorSnapshot.h"
+
+class CircuitSimulator;
+class Arduino;
+class Resistor;
+
+// One external input applied to the circuit, stamped with the simulator's
+// virtual time (not wall-clock time) at which it was applied.
+struct Stimulus
+{
+    enum Type {
+        PinMode = 0,
+        DigitalWrite,
+        AnalogWrite,
+        ResistorValue,
+        PowerOn,
+        PowerOff
+    };
+
+    double time;    // Virtual time in seconds
+    int type;       // Stimulus::Type
+    int target;     // Arduino index (pin/power stimuli) or component index
+    int pin;        // Pin number, -1 when not applicable
+    double value;
+};
+
+// Outcome of a headless replay
+struct ReplayResult
+{
+    bool success;
+    int steps;
+    int stimuliApplied;
+    double finalTime;
+    quint64 fingerprint;    // Hash of every component's state after every step
+    qint64 elapsedMs;       // Wall-clock time taken by the replay
+};
+
+// Records the inputs applied to a circuit together with the virtual time at
+// which they happened, and replays them headless as fast as the solver
+// allows. Recording starts from a simulator snapshot, so a replay always
+// begins from exactly the same state; results of two replays of the same
+// recording are bit-identical, which the replay fingerprint makes easy to
+// check. Inputs must be routed through the recorder to be captured.
+class StimulusRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StimulusRecorder(CircuitSimulator *simulator, QObject *parent = nullptr);
+
+    // Recording control
+    void startRecording();
+    void stopRecording();
+    bool isRecording() const { return m_recording; }
+    void clear();
+
+    // Inputs: applied immediately and recorded while recording
+    void pinMode(Arduino *arduino, int pin, int mode);
+    void digitalWrite(Arduino *arduino, int pin, int value);
+    void analogWrite(Arduino *arduino, int pin, int value);
+    void setResistance(Resistor *resistor, double resistance);
+    void setPowered(Arduino *arduino, bool on);
+
+    // Recorded data
+    const QVector<Stimulus>& getStimuli() const { return m_stimuli; }
+    int getStimulusCount() const { return m_stimuli.size(); }
+    double getRecordedDuration() const;
+
+    // Persistence (start snapshot is not saved; replay from file starts
+    // from the simulator's reset state)
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    // Replay the recording headless until the given virtual time. A
+    // negative duration replays up to the last recorded stimulus.
+    ReplayResult replay(double duration = -1.0);
+
+signals:
+    void stimulusRecorded(const Stimulus &stimulus);
+    void replayFinished(const ReplayResult &result);
+
+private:
+    void record(double time, int type, int target, int pin, double value);
+    bool apply(const Stimulus &stimulus);
+    int arduinoIndex(Arduino *arduino) const;
+    int componentIndex(QObject *component) const;
+    quint64 hashState(quint64 hash) const;
+
+    CircuitSimulator *m_simulator;
+    bool m_recording;
+    double m_recordStartTime;
+    SimulatorSnapshot m_startSnapshot;
+    QVector<Stimulus> m_stimuli;
+};
+
+#endif // STIMULUSRECORDER_H
@@ -0,0 +1,84 @@
+#ifndef SUBCIRCUIT_H
+#define SUBCIRCUIT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+class Component;
+class Node;
+class QObject;
+
+// A reusable block (LED + resistor per channel, button + pull-up per
+// input, ...) described once and instantiated many times with
+// Circuit::instantiate(). Elements name the nets their terminals go to:
+// ports are bound to caller nodes per instance, "GND" is the circuit's
+// ground, an empty name leaves the terminal open, and any other name is a
+// net private to the instance.
+//
+// compile() resolves every element terminal to a net slot once. Each
+// instance then only creates its components and internal nodes and
+// connects them straight from that table, with no name lookups, node
+// merging or per-connection notifications; the simulator picks the
+// instances up in its usual batched passes (LEDs through LedBatch).
+class SubcircuitTemplate
+{
+public:
+    // Creates one element component, parented to the given object
+    typedef std::function<Component*(QObject*)> Factory;
+
+    SubcircuitTemplate(const QString &name, const QStringList &ports);
+
+    const QString &getName() const { return m_name; }
+    const QStringList &getPorts() const { return m_ports; }
+
+    // Adds an element whose terminal i connects to nets[i]; returns its
+    // index. Adding an element discards a previous compile().
+    int addElement(const QString &name, const Factory &factory, const QStringList &nets);
+    int getElementCount() const { return m_elements.size(); }
+    QString getElementName(int element) const;
+
+    // Resolves nets to slots and checks each element's terminal count
+    // against a prototype; instantiate() compiles on demand
+    bool compile();
+    bool isCompiled() const { return m_compiled; }
+    int getInternalNetCount() const { return m_internalNets.size(); }
+
+private:
+    friend class Circuit;
+
+    // Slot encoding: 0..ports-1 are ports, ports.. are internal nets,
+    // GroundSlot is the circuit's ground
+    static constexpr int GroundSlot = -1;
+    static constexpr int UnconnectedSlot = -2;
+
+    struct Element {
+        QString name;
+        Factory factory;
+        QStringList nets;
+        int firstTerminal;      // Into m_slots
+        int terminalCount;
+    };
+
+    QString m_name;
+    QStringList m_ports;
+    QVector<Element> m_elements;
+
+    // Compiled
+    bool m_compiled;
+    QVector<int> m_slots;
+    QStringList m_internalNets;
+};
+
+// One placed copy of a template. Components and internal nodes belong to
+// the circuit like any other; the record only groups them.
+struct SubcircuitInstance
+{
+    const SubcircuitTemplate *subcircuit;
+    QString name;
+    QVector<Component*> components;     // In element order
+    QVector<Node*> nodes;               // Internal nets, in template order
+};
+
+#endif // SUBCIRCUIT_H
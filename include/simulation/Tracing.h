@@ -0,0 +1,59 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QtGlobal>
+#include <QString>
+
+// Low-overhead instrumentation for the simulation hot paths, selected at
+// compile time with ARDUINOSIM_ENABLE_TRACING (CMake option ENABLE_TRACING).
+//
+//   TRACE_SCOPE("MatrixSolver::solve");          // span until end of scope
+//   TRACE_COUNTER("solver.nonZeros", nonZeros);  // counter sample
+//
+// Events go into a fixed-size ring buffer owned by the recording thread;
+// recording takes no lock and never allocates after the thread's first
+// event. When the buffer wraps, the oldest events are overwritten.
+// writeChromeTrace() collects every thread's buffer into Chrome
+// trace-event JSON (chrome://tracing, Perfetto). Event names must be
+// string literals. With tracing disabled the macros compile to nothing.
+namespace Tracing
+{
+    // Always available, so callers need no #ifdef; without tracing
+    // compiled in writeChromeTrace() fails and isEnabled() is false
+    bool isEnabled();
+    bool writeChromeTrace(const QString &fileName);
+    void clear();
+
+    // Events per thread buffer (power of two)
+    const int BufferSize = 1 << 16;
+
+#ifdef ARDUINOSIM_ENABLE_TRACING
+    qint64 now();   // Monotonic nanoseconds
+    void recordSpan(const char *name, qint64 start, qint64 duration);
+    void recordCounter(const char *name, qint64 value);
+
+    class ScopedSpan
+    {
+    public:
+        explicit ScopedSpan(const char *name) : m_name(name), m_start(now()) {}
+        ~ScopedSpan() { recordSpan(m_name, m_start, now() - m_start); }
+
+    private:
+        Q_DISABLE_COPY(ScopedSpan)
+        const char *m_name;
+        qint64 m_start;
+    };
+#endif
+}
+
+#ifdef ARDUINOSIM_ENABLE_TRACING
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) Tracing::ScopedSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) Tracing::recordCounter(name, static_cast<qint64>(value))
+#else
+#define TRACE_SCOPE(name) do {} while (false)
+#define TRACE_COUNTER(name, value) do {} while (false)
+#endif
+
+#endif // TRACING_H
@@ -0,0 +1,90 @@
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include <QtGlobal>
+#include <QJsonObject>
+
+// Decides how long CircuitSimulator coalesces change notifications before
+// solving, and how many Newton iterations one update may spend, from a
+// moving average of measured solve cost.
+//
+// The update period (start to start) is chosen so solving takes a bounded
+// share of the GUI thread:
+//   Fixed            - period is the configured interval (legacy behavior)
+//   LatencyFirst     - solve as soon as the simulator has used at most half
+//                      the thread; Newton iterations are capped to fit half a
+//                      frame, and an unconverged update continues in the next
+//   ThroughputFirst  - at most one update per frame, using up to 90% of the
+//                      thread, with the full Newton budget
+// With a target real-time factor, the period is shortened so each
+// simulated time step waits no longer than its wall-clock duration at that
+// speed, as long as solving stays under 90% of the thread.
+class UpdateScheduler
+{
+public:
+    enum Policy {
+        Fixed,
+        LatencyFirst,
+        ThroughputFirst
+    };
+
+    UpdateScheduler();
+
+    Policy getPolicy() const { return m_policy; }
+    void setPolicy(Policy policy) { m_policy = policy; }
+
+    // Update interval of the Fixed policy
+    int getFixedInterval() const { return m_fixedIntervalMs; }
+    void setFixedInterval(int msecs) { m_fixedIntervalMs = qMax(0, msecs); }
+
+    // Wall time of one UI frame
+    double getFrameBudget() const { return m_frameBudgetMs; }
+    void setFrameBudget(double msecs) { m_frameBudgetMs = qMax(1.0, msecs); }
+
+    // Simulated seconds per wall second to aim for; 0 for no target
+    double getTargetRealTimeFactor() const { return m_targetRealTimeFactor; }
+    void setTargetRealTimeFactor(double factor) { m_targetRealTimeFactor = qMax(0.0, factor); }
+
+    // Simulated seconds advanced per update
+    void setTimeStep(double seconds) { m_timeStepMs = seconds * 1000.0; }
+
+    // Feedback after every update: wall time since the previous update
+    // started, solve cost and simulated time advanced
+    void recordUpdate(qint64 periodNs, qint64 solveNs, int iterations, double simulatedSeconds);
+    void reset();
+
+    // Minimum wall time between the starts of two updates
+    int getUpdateInterval() const;
+
+    // Newton iterations one update may use, at most maxIterations
+    int getIterationBudget(int maxIterations) const;
+
+    // Moving averages
+    double getAverageSolveMs() const { return m_solveMs; }
+    double getAverageIterationMs() const { return m_iterationMs; }
+    double getAchievedRealTimeFactor() const { return m_achievedRealTimeFactor; }
+
+    QJsonObject toJson() const;
+
+    static const char* policyName(Policy policy);
+
+private:
+    static constexpr double Smoothing = 0.2;        // EWMA weight of the newest sample
+    static constexpr double LatencyDuty = 0.5;
+    static constexpr double ThroughputDuty = 0.9;
+    static constexpr int MinIterationBudget = 5;
+    static constexpr int MaxIntervalMs = 1000;
+
+    Policy m_policy;
+    int m_fixedIntervalMs;
+    double m_frameBudgetMs;
+    double m_targetRealTimeFactor;
+    double m_timeStepMs;
+
+    bool m_hasSamples;
+    double m_solveMs;
+    double m_iterationMs;
+    double m_achievedRealTimeFactor;
+};
+
+#endif // UPDATESCHEDULER_H
@@ -0,0 +1,104 @@
+#ifndef VCDWRITER_H
+#define VCDWRITER_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include "core/ArduinoPin.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+class Arduino;
+class CircuitSimulator;
+
+// Streams digital pin activity as a Value Change Dump (IEEE 1364) so that
+// runs can be inspected in GTKWave and similar viewers. Values are written
+// only when a pin's level or mode actually changes, time-stamped with the
+// simulator's virtual time. Output is buffered in a fixed-size block, so
+// memory stays bounded however many edges are recorded. File names ending
+// in ".gz" are gzip-compressed on the fly when zlib is available.
+class VcdWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VcdWriter(CircuitSimulator *simulator, QObject *parent = nullptr);
+    ~VcdWriter();
+
+    // Signal registration (must happen before open())
+    void addArduino(Arduino *arduino);
+    void addPin(DigitalPin *pin, const QString &scope);
+    int getTracedPinCount() const { return m_traces.size(); }
+
+    // Output control
+    bool open(const QString &fileName);
+    void close();
+    void flush();
+    bool isOpen() const { return m_isOpen; }
+
+    // Size of the write buffer in bytes (default 64 KiB)
+    void setBufferSize(int bytes);
+    int getBufferSize() const { return m_bufferSize; }
+
+    // Statistics
+    qint64 getEdgeCount() const { return m_edgeCount; }
+    qint64 getBytesWritten() const { return m_bytesWritten; }
+
+private slots:
+    void onPinValueChanged(double value);
+    void onPinModeChanged(ArduinoPin::PinMode mode);
+    void onPinDestroyed(QObject *object);
+
+private:
+    struct PinTrace {
+        DigitalPin *pin;
+        QString scope;
+        QByteArray levelId;     // VCD identifier for the logic level
+        QByteArray modeId;      // VCD identifier for the pin mode
+        char lastLevel;         // '0', '1' or 'z'
+        int lastMode;
+    };
+
+    static QByteArray makeIdentifier(int index);
+    static char levelOf(const DigitalPin *pin);
+
+    void writeHeader();
+    void writeTime();
+    void writeLevel(const PinTrace &trace, char level);
+    void writeMode(const PinTrace &trace, int mode);
+    void append(const QByteArray &data);
+    void flushBuffer();
+
+    CircuitSimulator *m_simulator;
+
+    // Traced signals
+    QVector<PinTrace> m_traces;
+    QHash<DigitalPin*, int> m_traceIndex;
+
+    // Output sink
+    QFile m_file;
+#ifdef HAVE_ZLIB
+    gzFile m_gzFile;
+#endif
+    bool m_isOpen;
+    bool m_compressed;
+
+    // Write buffering
+    QByteArray m_buffer;
+    int m_bufferSize;
+
+    // Time tracking (nanoseconds of virtual time)
+    qint64 m_lastTime;
+    bool m_timeWritten;
+
+    // Statistics
+    qint64 m_edgeCount;
+    qint64 m_bytesWritten;
+};
+
+#endif // VCDWRITER_H
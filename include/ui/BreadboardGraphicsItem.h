@@ -0,0 +1,51 @@
+#ifndef BREADBOARDGRAPHICSITEM_H
+#define BREADBOARDGRAPHICSITEM_H
+
+#include "ui/ComponentGraphicsItem.h"
+#include <QPainterPath>
+#include <QSet>
+
+class Breadboard;
+
+// Breadboard with one connection point per hole. Connection indices are
+// hole numbers; the canvas maps them to the strip terminal of the hole.
+// Holes are laid out on a fixed pitch, so hit testing is arithmetic
+// instead of a search, and all empty holes are drawn as one cached path.
+class BreadboardGraphicsItem : public ComponentGraphicsItem
+{
+    Q_OBJECT
+
+public:
+    explicit BreadboardGraphicsItem(Breadboard* backendBoard, QGraphicsItem* parent = nullptr);
+
+    // QGraphicsItem interface
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    // ComponentGraphicsItem interface
+    Component* getBackendComponent() const override;
+    QString getComponentType() const override;
+    QPointF getConnectionPointPosition(int index) const override;
+    bool isConnectionPointOccupied(int index) const override;
+    void setConnectionPointOccupied(int index, bool occupied) override;
+    int getConnectionPointAt(const QPointF& scenePos) const override;
+    int findFreeConnectionPoint(const QPointF& scenePos, qreal radius, qreal* distance) const override;
+
+    Breadboard* getBackendBoard() const { return m_backendBoard; }
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private:
+    static constexpr qreal Pitch = 10.0;    // Hole spacing
+    static constexpr qreal HoleSize = 4.0;
+
+    QPointF holePosition(int hole) const;
+    void buildHolePath();
+
+    Breadboard* m_backendBoard;
+    QPainterPath m_holePath;
+    QSet<int> m_occupiedHoles;          // Holes with a wire on them
+};
+
+#endif // BREADBOARDGRAPHICSITEM_H
@@ -5,13 +5,20 @@
 #include <QVector>
 #include <QPointF>
 #include <QColor>
+#include <QPointer>
 #include "core/Arduino.h"
+#include "core/SampledSource.h"
 
 class Circuit;
+class Component;
+class Resistor;
 class ComponentGraphicsItem;
 class WireGraphicsItem;
 class QGraphicsSceneMouseEvent;
 class QKeyEvent;
+class QUndoStack;
+class UiDiagnostics;
+class StimulusRecorder;
 
 class CircuitCanvas : public QGraphicsScene
 {
@@ -35,7 +42,36 @@ public:
     ComponentGraphicsItem* addLED(const QPointF& position, const QColor& color = Qt::red);
     ComponentGraphicsItem* addResistor(const QPointF& position, double resistance = 1000.0);
     ComponentGraphicsItem* addArduino(const QPointF& position, Arduino::BoardType boardType = Arduino::UNO);
+    ComponentGraphicsItem* addLedStrip(const QPointF& position, int pixelCount = 60);
+    ComponentGraphicsItem* addLedMatrix(const QPointF& position, int rows = 8, int columns = 8,
+                                        const QColor& color = Qt::red);
+    ComponentGraphicsItem* addBreadboard(const QPointF& position, bool fullSize = true);
+    // Plays the recording in fileName (see SampleStream); an empty name
+    // adds the source without one
+    ComponentGraphicsItem* addSampledSource(const QPointF& position, const QString& fileName,
+                                            SampledSource::Mode mode = SampledSource::VoltageSource);
     void removeComponent(ComponentGraphicsItem* component);
+    void removeWire(WireGraphicsItem* wire);
+
+    // Joins width consecutive connection points of start, from
+    // startTerminal, to those of end with one bus wire (undoable)
+    WireGraphicsItem* addBus(ComponentGraphicsItem* start, int startTerminal,
+                             ComponentGraphicsItem* end, int endTerminal, int width);
+
+    // Parameter edits (undoable)
+    void setResistance(Resistor* resistor, double resistance);
+
+    // Undo/redo of component, wire and parameter edits
+    QUndoStack* getUndoStack() const { return m_undoStack; }
+
+    // Responsiveness measurements (owned elsewhere, may be null)
+    UiDiagnostics* getDiagnostics() const;
+    void setDiagnostics(UiDiagnostics* diagnostics);
+
+    // Parameter edits, including their undo and redo, are applied through
+    // the recorder when one is set (owned elsewhere, may be null)
+    StimulusRecorder* getStimulusRecorder() const;
+    void setStimulusRecorder(StimulusRecorder* recorder);
 
     // Wire drawing interface
     void startWireDrawing(ComponentGraphicsItem* component, int terminal);
@@ -47,6 +83,10 @@ public:
     DrawingState getDrawingState() const { return m_drawingState; }
     bool isDrawingWire() const { return m_drawingState == DRAWING_WIRE; }
 
+    // Lines carried by each wire drawn from now on (1 for a plain wire)
+    int getBusWidth() const { return m_busWidth; }
+    void setBusWidth(int width) { m_busWidth = qMax(1, width); }
+
     // Grid and snapping
     bool isGridVisible() const { return m_showGrid; }
     void setGridVisible(bool visible) { m_showGrid = visible; update(); }
@@ -66,6 +106,8 @@ public:
 
 public slots:
     void toggleGrid();
+    void undo();
+    void redo();
 
 signals:
     // Wire drawing signals
@@ -84,6 +126,10 @@ protected:
     void mouseMoveEvent(QGraphicsSceneMouseEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
 
+    // Bracket each render for frame time diagnostics
+    void drawBackground(QPainter* painter, const QRectF& rect) override;
+    void drawForeground(QPainter* painter, const QRectF& rect) override;
+
 private slots:
     // Component event handlers
     void onComponentDoubleClicked(ComponentGraphicsItem* component);
@@ -92,9 +138,36 @@ private slots:
     void onCircuitChanged();
 
 private:
-    // Backend connection creation
-    bool createBackendConnection(ComponentGraphicsItem* comp1, int terminal1,
-                               ComponentGraphicsItem* comp2, int terminal2);
+    friend class AddComponentCommand;
+    friend class RemoveComponentCommand;
+    friend class ConnectCommand;
+    friend class RemoveWireCommand;
+
+    // Maps a connection point to the backend component and terminal behind it
+    bool resolveTerminal(ComponentGraphicsItem* item, int terminal,
+                         Component*& component, int& backendTerminal) const;
+
+    // Backend terminals joined by one line of a wire
+    struct WireLine {
+        Component* start;
+        int startTerminal;
+        Component* end;
+        int endTerminal;
+    };
+
+    // Every line of a wire (the bus width for a bus); false if any end
+    // cannot be resolved
+    bool resolveWireLines(WireGraphicsItem* wire, QVector<WireLine>& lines) const;
+
+    // Whether width connection points from terminal are free to connect
+    bool canConnectLines(ComponentGraphicsItem* item, int terminal, int width) const;
+
+    // Scene bookkeeping used by the undo commands
+    void attachComponentItem(ComponentGraphicsItem* item);
+    void detachComponentItem(ComponentGraphicsItem* item);
+    void attachWireItem(WireGraphicsItem* wire);
+    void detachWireItem(WireGraphicsItem* wire);
+    QVector<WireGraphicsItem*> getWiresConnectedTo(ComponentGraphicsItem* component) const;
 
     // Helper methods
     void findSnapTarget(const QPointF& pos, ComponentGraphicsItem*& component, int& terminal);
@@ -102,7 +175,6 @@ private:
     QPointF snapToGrid(const QPointF& pos) const;
     void clearHighlights();
     void connectComponentSignals(ComponentGraphicsItem* component);
-    void removeWiresConnectedTo(ComponentGraphicsItem* component);
     void deleteSelectedItems();
     void showContextMenu(const QPointF& scenePos, const QPoint& screenPos);
 
@@ -118,6 +190,7 @@ private:
     WireGraphicsItem* m_currentWire;        // Temporary wire being drawn
     ComponentGraphicsItem* m_startComponent; // Starting component for wire
     int m_startTerminal;                    // Starting terminal index
+    int m_busWidth;                         // Lines per drawn wire
 
     // Grid and snapping settings
     qreal m_snapRadius;      // Radius for snapping to connection points
@@ -128,6 +201,12 @@ private:
 
     // Component ID tracking
     int m_nextComponentId;
+
+    // Edit history
+    QUndoStack* m_undoStack;
+
+    QPointer<UiDiagnostics> m_diagnostics;
+    QPointer<StimulusRecorder> m_stimulusRecorder;
 };
 
 #endif // CIRCUITCANVAS_H
\ No newline at end of file
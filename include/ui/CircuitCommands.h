@@ -0,0 +1,136 @@
+#ifndef CIRCUITCOMMANDS_H
+#define CIRCUITCOMMANDS_H
+
+#include <QUndoCommand>
+#include <QVector>
+#include <QPair>
+#include <QPointer>
+
+class CircuitCanvas;
+class Circuit;
+class Component;
+class Resistor;
+class StimulusRecorder;
+class ComponentGraphicsItem;
+class WireGraphicsItem;
+
+// Undo commands for canvas edits. Each command stores only the delta it
+// applied (the objects it added or removed and the terminal connections it
+// changed), never a copy of the circuit. Objects taken out of the circuit
+// stay alive inside the command that removed them and are deleted only
+// when that command is discarded from the stack.
+
+// Terminal connection captured before an edit, used to put it back
+struct TerminalLink {
+    Component* component;
+    int terminal;
+    QVector<QPair<Component*, int>> peers;  // Other terminals on the same node
+    bool ground;
+};
+
+class AddComponentCommand : public QUndoCommand
+{
+public:
+    AddComponentCommand(CircuitCanvas* canvas, ComponentGraphicsItem* item,
+                        QUndoCommand* parent = nullptr);
+    ~AddComponentCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    CircuitCanvas* m_canvas;
+    QPointer<ComponentGraphicsItem> m_item;
+    QVector<QPointer<QObject>> m_backend;   // Owned while undone
+    bool m_attached;
+};
+
+class RemoveComponentCommand : public QUndoCommand
+{
+public:
+    RemoveComponentCommand(CircuitCanvas* canvas, ComponentGraphicsItem* item,
+                           QUndoCommand* parent = nullptr);
+    ~RemoveComponentCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    CircuitCanvas* m_canvas;
+    QPointer<ComponentGraphicsItem> m_item;
+    QVector<QPointer<QObject>> m_backend;   // Owned while done
+    QVector<QPointer<WireGraphicsItem>> m_wires;
+    QVector<TerminalLink> m_links;
+    bool m_removed;
+};
+
+// Connects two terminals with a wire, merging their nodes if needed. A bus
+// wire connects all its lines as one step.
+class ConnectCommand : public QUndoCommand
+{
+public:
+    ConnectCommand(CircuitCanvas* canvas, WireGraphicsItem* wire,
+                   QUndoCommand* parent = nullptr);
+    ~ConnectCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    // State of one line before it was connected
+    struct LineState {
+        QVector<QPair<Component*, int>> startPeers;
+        QVector<QPair<Component*, int>> endPeers;
+        bool endWasGround;
+        bool alreadyConnected;
+    };
+
+    CircuitCanvas* m_canvas;
+    QPointer<WireGraphicsItem> m_wire;      // Owned while undone
+    QVector<LineState> m_lines;
+    bool m_connected;
+};
+
+// Removes a wire, splitting a line's node when nothing else still joins
+// its ends
+class RemoveWireCommand : public QUndoCommand
+{
+public:
+    RemoveWireCommand(CircuitCanvas* canvas, WireGraphicsItem* wire,
+                      QUndoCommand* parent = nullptr);
+    ~RemoveWireCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    CircuitCanvas* m_canvas;
+    QPointer<WireGraphicsItem> m_wire;      // Owned while done
+    QVector<bool> m_splitLines;
+    bool m_removed;
+};
+
+// Parameter edit; consecutive edits of the same resistor merge into one step
+class SetResistanceCommand : public QUndoCommand
+{
+public:
+    SetResistanceCommand(Resistor* resistor, double resistance,
+                         StimulusRecorder* recorder = nullptr,
+                         QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+
+    int id() const override { return 1; }
+    bool mergeWith(const QUndoCommand* other) override;
+
+private:
+    void apply(double resistance);
+
+    QPointer<Resistor> m_resistor;
+    QPointer<StimulusRecorder> m_recorder;
+    double m_oldResistance;
+    double m_newResistance;
+};
+
+#endif // CIRCUITCOMMANDS_H
@@ -43,6 +43,11 @@ public:
     virtual void setConnectionPointOccupied(int index, bool occupied) = 0;
     virtual int getConnectionPointAt(const QPointF& scenePos) const = 0;
 
+    // Closest unoccupied connection point within radius of scenePos, or -1;
+    // its distance is returned through distance. The default checks every
+    // point; items with many points on a regular layout can do better.
+    virtual int findFreeConnectionPoint(const QPointF& scenePos, qreal radius, qreal* distance) const;
+
     // Connection point access
     int getConnectionPointCount() const { return m_connectionPoints.size(); }
     const ConnectionPoint& getConnectionPoint(int index) const;
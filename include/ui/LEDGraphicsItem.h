@@ -52,6 +52,7 @@ private:
     double m_brightness;
     QColor m_currentColor;
     bool m_overloadIndicator;
+    bool m_stateDirty;          // State changed since the last paint
 };
 
 #endif // LEDGRAPHICSITEM_H
\ No newline at end of file
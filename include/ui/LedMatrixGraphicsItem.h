@@ -0,0 +1,51 @@
+#ifndef LEDMATRIXGRAPHICSITEM_H
+#define LEDMATRIXGRAPHICSITEM_H
+
+#include "ui/ComponentGraphicsItem.h"
+#include <QImage>
+
+class LedMatrix;
+
+// Draws a whole LED matrix with a single drawImage() call instead of one
+// item per diode. Brightness is mapped onto the LED color in a cached
+// image, one image pixel per diode, only when the matrix reports a change.
+class LedMatrixGraphicsItem : public ComponentGraphicsItem
+{
+    Q_OBJECT
+
+public:
+    explicit LedMatrixGraphicsItem(LedMatrix* backendMatrix, QGraphicsItem* parent = nullptr);
+
+    // QGraphicsItem interface
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    // ComponentGraphicsItem interface
+    Component* getBackendComponent() const override;
+    QString getComponentType() const override;
+    QPointF getConnectionPointPosition(int index) const override;
+    bool isConnectionPointOccupied(int index) const override;
+    void setConnectionPointOccupied(int index, bool occupied) override;
+    int getConnectionPointAt(const QPointF& scenePos) const override;
+
+    LedMatrix* getBackendMatrix() const { return m_backendMatrix; }
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private slots:
+    void onMatrixChanged();
+
+private:
+    static const int CellSize = 10;
+
+    void setupConnectionPoints();
+    void refreshImage();
+    QRectF diodeArea() const;
+
+    LedMatrix* m_backendMatrix;
+    QImage m_image;
+    bool m_imageDirty;
+};
+
+#endif // LEDMATRIXGRAPHICSITEM_H
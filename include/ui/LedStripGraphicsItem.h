@@ -0,0 +1,52 @@
+#ifndef LEDSTRIPGRAPHICSITEM_H
+#define LEDSTRIPGRAPHICSITEM_H
+
+#include "ui/ComponentGraphicsItem.h"
+#include <QImage>
+
+class LedStrip;
+
+// Draws all pixels of a WS2812 strip with a single drawImage() call. The
+// packed colors are copied into a cached image, one image pixel per LED,
+// only when a frame changed them.
+class LedStripGraphicsItem : public ComponentGraphicsItem
+{
+    Q_OBJECT
+
+public:
+    explicit LedStripGraphicsItem(LedStrip* backendStrip, QGraphicsItem* parent = nullptr);
+
+    // QGraphicsItem interface
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    // ComponentGraphicsItem interface
+    Component* getBackendComponent() const override;
+    QString getComponentType() const override;
+    QPointF getConnectionPointPosition(int index) const override;
+    bool isConnectionPointOccupied(int index) const override;
+    void setConnectionPointOccupied(int index, bool occupied) override;
+    int getConnectionPointAt(const QPointF& scenePos) const override;
+
+    LedStrip* getBackendStrip() const { return m_backendStrip; }
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private slots:
+    void onPixelsChanged();
+
+private:
+    static const int Columns = 30;      // Pixels per row before wrapping
+    static const int CellSize = 8;
+
+    void setupConnectionPoints();
+    void refreshImage();
+    QRectF pixelArea() const;
+
+    LedStrip* m_backendStrip;
+    QImage m_image;
+    bool m_imageDirty;
+};
+
+#endif // LEDSTRIPGRAPHICSITEM_H
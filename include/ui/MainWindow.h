@@ -9,6 +9,8 @@
 class CircuitCanvas;
 class ComponentLibrary;
 class Circuit;
+class UiDiagnostics;
+class QDockWidget;
 
 class MainWindow : public QMainWindow
 {
@@ -34,11 +36,16 @@ private:
     void createMenus();
     void createToolBars();
     void createStatusBar();
+    void createDiagnostics();
 
     CircuitCanvas *m_circuitCanvas;
     ComponentLibrary *m_componentLibrary;
     Circuit *m_circuit;
 
+    // Responsiveness diagnostics, collected while the dock is visible
+    UiDiagnostics *m_diagnostics;
+    QDockWidget *m_diagnosticsDock;
+
     // Menus
     QMenu *m_fileMenu;
     QMenu *m_simulationMenu;
@@ -56,6 +63,7 @@ private:
     QAction *m_startSimAction;
     QAction *m_stopSimAction;
     QAction *m_aboutAction;
+    QAction *m_diagnosticsAction;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,47 @@
+#ifndef SAMPLEDSOURCEGRAPHICSITEM_H
+#define SAMPLEDSOURCEGRAPHICSITEM_H
+
+#include "ui/ComponentGraphicsItem.h"
+
+class SampledSource;
+
+// Two-terminal box for a recorded sensor source, labelled with the file it
+// plays and the value at the current simulation time
+class SampledSourceGraphicsItem : public ComponentGraphicsItem
+{
+    Q_OBJECT
+
+public:
+    explicit SampledSourceGraphicsItem(SampledSource* backendSource, QGraphicsItem* parent = nullptr);
+
+    // QGraphicsItem interface
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    // ComponentGraphicsItem interface
+    Component* getBackendComponent() const override;
+    QString getComponentType() const override;
+    QPointF getConnectionPointPosition(int index) const override;
+    bool isConnectionPointOccupied(int index) const override;
+    void setConnectionPointOccupied(int index, bool occupied) override;
+    int getConnectionPointAt(const QPointF& scenePos) const override;
+
+    SampledSource* getBackendSource() const { return m_backendSource; }
+
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private slots:
+    void onStateChanged();
+
+private:
+    static constexpr qreal BodyWidth = 80.0;
+    static constexpr qreal BodyHeight = 36.0;
+
+    void setupConnectionPoints();
+    QRectF bodyRect() const;
+
+    SampledSource* m_backendSource;
+};
+
+#endif // SAMPLEDSOURCEGRAPHICSITEM_H
@@ -0,0 +1,109 @@
+#ifndef UIDIAGNOSTICS_H
+#define UIDIAGNOSTICS_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include "simulation/LatencyHistogram.h"
+
+class QGraphicsItem;
+class QTimer;
+
+// Responsiveness measurements for the canvas, collected while enabled:
+//  - event-loop latency: how late a fixed-interval probe timer fires,
+//    i.e. how long the GUI thread was busy with something else
+//  - frame time: one full scene render (background to foreground)
+//  - paint time per item type
+//  - input-to-LED: from a mouse/key press on the canvas to the next paint
+//    of an LED whose state changed. Presses not followed by an LED change
+//    within InputTimeoutMs are dropped; LED changes with no pending press
+//    (free-running sketches) are not counted.
+// When disabled every hook returns immediately.
+class UiDiagnostics : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ItemType {
+        LedItem = 0,
+        WireItem,
+        ArduinoItem,
+        ItemTypeCount
+    };
+
+    static const int InputTimeoutMs = 2000;
+
+    explicit UiDiagnostics(QObject* parent = nullptr);
+
+    bool isEnabled() const { return m_enabled; }
+    int getProbeInterval() const { return m_probeIntervalMs; }
+    void setProbeInterval(int intervalMs);
+
+    const LatencyHistogram& getEventLoopLatency() const { return m_eventLoopLatency; }
+    const LatencyHistogram& getFrameTime() const { return m_frameTime; }
+    const LatencyHistogram& getPaintTime(ItemType type) const { return m_paintTime[type]; }
+    const LatencyHistogram& getInputToLed() const { return m_inputToLed; }
+    static const char* itemTypeName(ItemType type);
+
+    // Hooks called from the canvas and graphics items
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+    void markInput();
+    void beginFrame();
+    void endFrame();
+    void recordPaint(ItemType type, qint64 ns);
+    void ledRepainted();
+
+    // Diagnostics of the canvas the item is in, or nullptr if none or disabled
+    static UiDiagnostics* forItem(const QGraphicsItem* item);
+
+    QJsonObject toJson() const;
+    bool exportJson(const QString& fileName) const;
+
+public slots:
+    void setEnabled(bool enabled);
+    void reset();
+
+private slots:
+    void probeEventLoop();
+
+private:
+    bool m_enabled;
+    QElapsedTimer m_clock;
+    QTimer* m_probeTimer;
+    int m_probeIntervalMs;
+    qint64 m_lastProbeNs;
+    qint64 m_frameStartNs;      // -1 outside a frame
+    qint64 m_pendingInputNs;    // -1 if no press is waiting for an LED
+
+    LatencyHistogram m_eventLoopLatency;
+    LatencyHistogram m_frameTime;
+    LatencyHistogram m_paintTime[ItemTypeCount];
+    LatencyHistogram m_inputToLed;
+};
+
+// Times one paint() call into the diagnostics of the item's canvas
+class PaintTimer
+{
+public:
+    PaintTimer(const QGraphicsItem* item, UiDiagnostics::ItemType type)
+        : m_diagnostics(UiDiagnostics::forItem(item))
+        , m_type(type)
+        , m_start(m_diagnostics ? m_diagnostics->now() : 0)
+    {
+    }
+
+    ~PaintTimer()
+    {
+        if (m_diagnostics) {
+            m_diagnostics->recordPaint(m_type, m_diagnostics->now() - m_start);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(PaintTimer)
+
+    UiDiagnostics* m_diagnostics;
+    UiDiagnostics::ItemType m_type;
+    qint64 m_start;
+};
+
+#endif // UIDIAGNOSTICS_H
@@ -0,0 +1,32 @@
+#ifndef UIDIAGNOSTICSWIDGET_H
+#define UIDIAGNOSTICSWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+
+class UiDiagnostics;
+class LatencyHistogram;
+class QTimer;
+
+// Live view of UiDiagnostics: one histogram per measurement, refreshed a
+// few times per second, with reset and JSON export
+class UiDiagnosticsWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit UiDiagnosticsWidget(UiDiagnostics* diagnostics, QWidget* parent = nullptr);
+
+private slots:
+    void refresh();
+    void exportResults();
+
+private:
+    void addHistogram(const QString& title, const LatencyHistogram* histogram);
+
+    UiDiagnostics* m_diagnostics;
+    QVector<QWidget*> m_views;
+    QTimer* m_refreshTimer;
+};
+
+#endif // UIDIAGNOSTICSWIDGET_H
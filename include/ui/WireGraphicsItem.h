@@ -5,9 +5,10 @@
 #include <QObject>
 #include <QPainterPath>
 #include <QPointF>
+#include <QPointer>
+#include "ui/ComponentGraphicsItem.h"
 
 class Wire;
-class ComponentGraphicsItem;
 
 class WireGraphicsItem : public QObject, public QGraphicsItem
 {
@@ -54,6 +55,17 @@ public:
     int getStartTerminal() const { return m_startTerminal; }
     int getEndTerminal() const { return m_endTerminal; }
 
+    // Bus wires carry several lines in one item: line i joins terminal
+    // getStartTerminal() + i to getEndTerminal() + i. Set before connecting.
+    int getBusWidth() const { return m_busWidth; }
+    void setBusWidth(int width);
+    bool isBus() const { return m_busWidth > 1; }
+    int getStartTerminal(int line) const { return m_startTerminal + line; }
+    int getEndTerminal(int line) const { return m_endTerminal + line; }
+
+    // Marks the connection points of every line at both ends
+    void setEndsOccupied(bool occupied);
+
     // Visual properties
     RoutingStyle getRoutingStyle() const { return m_routingStyle; }
     void setRoutingStyle(RoutingStyle style);
@@ -98,6 +110,11 @@ private:
     void drawArrow(QPainter* painter, const QPointF& pos, qreal angleDegrees, qreal size);
     void drawSelectionIndicators(QPainter* painter);
     void drawElectricalInfo(QPainter* painter);
+    void drawBusMarker(QPainter* painter);
+
+    // Scene position of a terminal group, between its first and last line
+    QPointF groupPosition(ComponentGraphicsItem* component, int firstTerminal) const;
+    void setLinesOccupied(ComponentGraphicsItem* component, int firstTerminal, bool occupied);
 
     // Component management
     void disconnectFromComponents();
@@ -106,10 +123,11 @@ private:
     Wire* m_backendWire;
 
     // Component connections
-    ComponentGraphicsItem* m_startComponent;
-    ComponentGraphicsItem* m_endComponent;
+    QPointer<ComponentGraphicsItem> m_startComponent;
+    QPointer<ComponentGraphicsItem> m_endComponent;
     int m_startTerminal;
     int m_endTerminal;
+    int m_busWidth;
 
     // Wire geometry
     QPointF m_startPoint;
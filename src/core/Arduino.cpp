@@ -1,8 +1,10 @@
 #include "core/Arduino.h"
 #include "core/ArduinoPin.h"
 #include "simulation/Circuit.h"
+#include "simulation/Tracing.h"
 #include <QDebug>
 #include <QTime>
+#include <QDataStream>
 #include <algorithm>
 
 Arduino::Arduino(BoardType board, QObject *parent)
@@ -241,6 +243,20 @@ void Arduino::analogWrite(int pin, int value)
     }
 }
 
+void Arduino::ws2812Show(int pin, const QByteArray &grb)
+{
+    if (!m_isPoweredOn) return;
+
+    TRACE_SCOPE("Arduino::ws2812Show");
+
+    DigitalPin *digitalPin = findDigitalPin(pin);
+    if (digitalPin) {
+        digitalPin->writeFrame(grb);
+    } else {
+        qWarning() << "Invalid digital pin for ws2812Show:" << pin;
+    }
+}
+
 int Arduino::analogRead(int pin)
 {
     if (!m_isPoweredOn) return 0;
@@ -466,6 +482,52 @@ void Arduino::stopSketch()
     }
 }
 
+void Arduino::saveState(QDataStream &out) const
+{
+    // Store elapsed time rather than the wall-clock start so that millis()
+    // continues from the same point after a restore
+    out << m_isPoweredOn << m_sketchRunning << m_analogReference
+        << static_cast<quint64>(millis());
+}
+
+void Arduino::restoreState(QDataStream &in)
+{
+    bool poweredOn;
+    bool sketchRunning;
+    quint64 elapsedMs;
+    in >> poweredOn >> sketchRunning >> m_analogReference >> elapsedMs;
+
+    m_startTime = QTime::currentTime().msecsSinceStartOfDay() - static_cast<unsigned long>(elapsedMs);
+
+    if (poweredOn != m_isPoweredOn) {
+        m_isPoweredOn = poweredOn;
+        if (m_systemTimer) {
+            if (m_isPoweredOn) {
+                m_systemTimer->start();
+            } else {
+                m_systemTimer->stop();
+            }
+        }
+        emit arduinoPowered(m_isPoweredOn);
+    }
+
+    if (sketchRunning != m_sketchRunning) {
+        m_sketchRunning = sketchRunning;
+        if (m_sketchTimer) {
+            if (m_sketchRunning) {
+                m_sketchTimer->start(m_sketchLoopDelay);
+            } else {
+                m_sketchTimer->stop();
+            }
+        }
+        if (m_sketchRunning) {
+            emit sketchStarted();
+        } else {
+            emit sketchStopped();
+        }
+    }
+}
+
 // Slot implementations
 void Arduino::onPinModeChanged(ArduinoPin::PinMode mode)
 {
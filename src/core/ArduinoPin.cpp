@@ -1,6 +1,9 @@
 #include "core/ArduinoPin.h"
 #include "core/Arduino.h"
+#include "simulation/ResponseLatency.h"
+#include "simulation/Tracing.h"
 #include <QDebug>
+#include <QDataStream>
 #include <algorithm>
 #include <cmath>
 
@@ -19,6 +22,7 @@ ArduinoPin::ArduinoPin(int pinNumber, PinType type, Arduino *arduino, QObject *p
     , m_outputResistance(25.0)  // ~25 ohm output resistance
     , m_inputResistance(1e9)    // Very high input impedance
     , m_isOverloaded(false)
+    , m_lastWriteNs(0)
 {
 }
 
@@ -133,6 +137,7 @@ double ArduinoPin::readPin() const
 void ArduinoPin::writePin(double value)
 {
     if (isOutput()) {
+        m_lastWriteNs = ResponseLatency::now();
         m_setValue = value;
         updateOutputState();
         emit componentChanged();
@@ -152,6 +157,31 @@ void ArduinoPin::reset()
     emit pinValueChanged(0.0);
 }
 
+void ArduinoPin::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << static_cast<qint32>(m_mode) << m_outputVoltage << m_inputVoltage
+        << m_outputCurrent << m_setValue << m_isOverloaded;
+}
+
+void ArduinoPin::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+
+    qint32 mode;
+    in >> mode >> m_outputVoltage >> m_inputVoltage
+       >> m_outputCurrent >> m_setValue >> m_isOverloaded;
+
+    // Restore the mode directly: setMode() would clear the output state
+    // and signal a circuit change
+    PinMode restoredMode = static_cast<PinMode>(mode);
+    if (restoredMode != m_mode) {
+        m_mode = restoredMode;
+        emit pinModeChanged(m_mode);
+    }
+    emit pinValueChanged(isOutput() ? m_outputVoltage : m_inputVoltage);
+}
+
 // DigitalPin implementation
 DigitalPin::DigitalPin(int pinNumber, Arduino *arduino, QObject *parent)
     : ArduinoPin(pinNumber, DIGITAL_PIN, arduino, parent)
@@ -179,6 +209,7 @@ void DigitalPin::digitalWrite(bool value)
         return;
     }
     
+    m_lastWriteNs = ResponseLatency::now();
     m_digitalState = value;
     m_setValue = value ? VCC : GND;
     
@@ -192,7 +223,20 @@ void DigitalPin::digitalWrite(bool value)
     emit pinValueChanged(m_outputVoltage);
     emit componentChanged();
     
-    qDebug() << "Digital write pin" << m_pinNumber << ":" << (value ? "HIGH" : "LOW");
+    TRACE_COUNTER("DigitalPin.digitalWrite", value ? 1 : 0);
+}
+
+int DigitalPin::writeFrame(const QByteArray &data)
+{
+    if (m_mode != OUTPUT) {
+        qWarning() << "Attempting to write a frame to pin" << m_pinNumber << "which is not in OUTPUT mode";
+        return 0;
+    }
+    
+    if (m_digitalState) {
+        digitalWrite(false);
+    }
+    return transmit(0, data);
 }
 
 bool DigitalPin::digitalRead() const
@@ -225,6 +269,7 @@ void DigitalPin::analogWrite(int value)
         return;
     }
     
+    m_lastWriteNs = ResponseLatency::now();
     m_pwmValue = std::clamp(value, 0, 255);
     m_setValue = calculatePWMVoltage();
     
@@ -237,7 +282,7 @@ void DigitalPin::analogWrite(int value)
     emit pinValueChanged(m_outputVoltage);
     emit componentChanged();
     
-    qDebug() << "PWM write pin" << m_pinNumber << ":" << m_pwmValue << "(" << m_setValue << "V average)";
+    TRACE_COUNTER("DigitalPin.analogWrite", m_pwmValue);
 }
 
 void DigitalPin::updateOutputState()
@@ -279,6 +324,44 @@ void DigitalPin::updatePWMOutput()
     emit componentChanged();
 }
 
+void DigitalPin::saveState(QDataStream &out) const
+{
+    ArduinoPin::saveState(out);
+    out << m_digitalState << static_cast<qint32>(m_pwmValue) << m_pwmPhase
+        << (m_pwmTimer && m_pwmTimer->isActive());
+}
+
+void DigitalPin::restoreState(QDataStream &in)
+{
+    qint32 pwmValue;
+    bool pwmActive;
+
+    ArduinoPin::restoreState(in);
+    in >> m_digitalState >> pwmValue >> m_pwmPhase >> pwmActive;
+    m_pwmValue = pwmValue;
+
+    if (m_pwmTimer) {
+        if (pwmActive && !m_pwmTimer->isActive()) {
+            m_pwmTimer->start();
+        } else if (!pwmActive && m_pwmTimer->isActive()) {
+            m_pwmTimer->stop();
+        }
+    }
+}
+
+ElectricalComponent::TerminalRole DigitalPin::getTerminalRole(int terminal) const
+{
+    Q_UNUSED(terminal)
+    
+    if (m_mode == OUTPUT) {
+        return m_pwmTimer && m_pwmTimer->isActive() ? AnalogTerminal : DigitalOutput;
+    }
+    if (m_mode == INPUT || m_mode == INPUT_PULLUP) {
+        return DigitalInput;
+    }
+    return AnalogTerminal;
+}
+
 double DigitalPin::calculatePWMVoltage() const
 {
     // PWM average voltage: Vavg = (duty_cycle / 255) * VCC
@@ -304,13 +387,14 @@ void AnalogPin::analogWrite(double voltage)
     
     // Clamp voltage to valid range
     voltage = std::clamp(voltage, 0.0, VCC);
+    m_lastWriteNs = ResponseLatency::now();
     m_setValue = voltage;
     
     updateOutputState();
     emit pinValueChanged(m_outputVoltage);
     emit componentChanged();
     
-    qDebug() << "Analog write pin A" << m_pinNumber << ":" << voltage << "V";
+    TRACE_COUNTER("AnalogPin.millivolts", qRound(voltage * 1000.0));
 }
 
 int AnalogPin::analogRead() const
@@ -349,4 +433,22 @@ int AnalogPin::voltageToADC(double voltage) const
     ratio = std::clamp(ratio, 0.0, 1.0);
     
     return static_cast<int>(ratio * maxValue);
-}
\ No newline at end of file
+}
+
+void AnalogPin::saveState(QDataStream &out) const
+{
+    ArduinoPin::saveState(out);
+    out << static_cast<qint32>(m_adcResolution) << m_referenceVoltage
+        << static_cast<qint32>(m_lastADCReading);
+}
+
+void AnalogPin::restoreState(QDataStream &in)
+{
+    qint32 resolution;
+    qint32 lastReading;
+
+    ArduinoPin::restoreState(in);
+    in >> resolution >> m_referenceVoltage >> lastReading;
+    m_adcResolution = resolution;
+    m_lastADCReading = lastReading;
+}
@@ -0,0 +1,45 @@
+#include "core/Breadboard.h"
+
+namespace {
+const int HalfSizeColumns = 30;
+const int FullSizeColumns = 63;
+const int RailCount = 4;
+
+int columnsFor(Breadboard::Size size)
+{
+    return size == Breadboard::HalfSize ? HalfSizeColumns : FullSizeColumns;
+}
+}
+
+Breadboard::Breadboard(Size size, QObject *parent)
+    : ElectricalComponent("Breadboard", 2 * columnsFor(size) + RailCount, parent)
+    , m_size(size)
+    , m_columns(columnsFor(size))
+{
+}
+
+int Breadboard::stripOfHole(int hole) const
+{
+    if (!isValidHole(hole)) {
+        return -1;
+    }
+
+    int row = holeRow(hole);
+    int column = holeColumn(hole);
+    if (row >= RowA && row <= RowE) {
+        return column;
+    }
+    if (row >= RowF && row <= RowJ) {
+        return m_columns + column;
+    }
+
+    // Rails run the length of the board
+    int rail = row < RowA ? row - TopPositiveRail : 2 + row - BottomPositiveRail;
+    return 2 * m_columns + rail;
+}
+
+ElectricalComponent::TerminalRole Breadboard::getTerminalRole(int terminal) const
+{
+    Q_UNUSED(terminal)
+    return PassiveTerminal;
+}
@@ -0,0 +1,52 @@
+#include "core/Bus.h"
+#include <QDataStream>
+#include <QtMath>
+
+Bus::Bus(int width, QObject *parent)
+    : ElectricalComponent("Bus", 2 * qMax(1, width), parent)
+    , m_width(qMax(1, width))
+{
+    m_lineVoltage.fill(0.0, m_width);
+    m_lineCurrent.fill(0.0, m_width);
+}
+
+void Bus::updateLines(const double *voltageDrops)
+{
+    double largestVoltage = 0.0;
+    double largestCurrent = 0.0;
+
+    for (int line = 0; line < m_width; ++line) {
+        double voltage = voltageDrops[line];
+        double current = voltage / IDEAL_RESISTANCE;
+        m_lineVoltage[line] = voltage;
+        m_lineCurrent[line] = current;
+
+        if (qAbs(voltage) > qAbs(largestVoltage)) {
+            largestVoltage = voltage;
+        }
+        if (qAbs(current) > qAbs(largestCurrent)) {
+            largestCurrent = current;
+        }
+    }
+
+    ElectricalComponent::updateState(largestVoltage, largestCurrent);
+}
+
+void Bus::reset()
+{
+    ElectricalComponent::reset();
+    m_lineVoltage.fill(0.0);
+    m_lineCurrent.fill(0.0);
+}
+
+void Bus::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_lineVoltage << m_lineCurrent;
+}
+
+void Bus::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_lineVoltage >> m_lineCurrent;
+}
@@ -0,0 +1,126 @@
+#include "core/DigitalComponent.h"
+#include <QDataStream>
+
+DigitalComponent::DigitalComponent(const QString &name, int inputCount, int outputCount, QObject *parent)
+    : ElectricalComponent(name, inputCount + outputCount, parent)
+    , m_inputs(inputCount, false)
+    , m_defaultInputs(inputCount, false)
+    , m_outputs(outputCount, false)
+    , m_outputsDirty(false)
+    , m_inputResistance(1e9)    // CMOS input
+    , m_outputResistance(50.0)  // 74HC output at 5 V
+    , m_evaluationCount(0)
+{
+}
+
+bool DigitalComponent::isOutputEnabled(int output) const
+{
+    Q_UNUSED(output)
+    return true;
+}
+
+void DigitalComponent::setInputResistance(double resistance)
+{
+    if (resistance > 0.0) {
+        m_inputResistance = resistance;
+        emit componentChanged();
+    }
+}
+
+void DigitalComponent::setOutputResistance(double resistance)
+{
+    if (resistance > 0.0) {
+        m_outputResistance = resistance;
+        emit componentChanged();
+    }
+}
+
+double DigitalComponent::getTerminalConductance(int terminal) const
+{
+    int output = terminal - m_inputs.size();
+    if (output >= 0 && isOutputEnabled(output)) {
+        return 1.0 / m_outputResistance;
+    }
+    return 1.0 / m_inputResistance;
+}
+
+double DigitalComponent::getTerminalCurrent(int terminal) const
+{
+    int output = terminal - m_inputs.size();
+    if (output < 0 || !isOutputEnabled(output) || !m_outputs.value(output)) {
+        return 0.0;
+    }
+    return LogicHigh / m_outputResistance;
+}
+
+ElectricalComponent::TerminalRole DigitalComponent::getTerminalRole(int terminal) const
+{
+    if (isInputTerminal(terminal)) {
+        return DigitalInput;
+    }
+    // A high-Z output neither drives nor reads its net
+    return isOutputEnabled(terminal - m_inputs.size()) ? DigitalOutput : AnalogTerminal;
+}
+
+bool DigitalComponent::getDigitalOutput(int terminal) const
+{
+    return m_outputs.value(terminal - m_inputs.size());
+}
+
+void DigitalComponent::digitalInputChanged(int terminal, bool level)
+{
+    if (!isInputTerminal(terminal) || m_inputs[terminal] == level) {
+        return;
+    }
+
+    m_inputs[terminal] = level;
+    m_evaluationCount++;
+    evaluate(terminal, level);
+    commitOutputs();
+}
+
+void DigitalComponent::setOutput(int output, bool level)
+{
+    if (output >= 0 && output < m_outputs.size() && m_outputs[output] != level) {
+        m_outputs[output] = level;
+        m_outputsDirty = true;
+    }
+}
+
+void DigitalComponent::setInputDefault(int input, bool level)
+{
+    if (isInputTerminal(input)) {
+        m_defaultInputs[input] = level;
+        m_inputs[input] = level;
+    }
+}
+
+void DigitalComponent::commitOutputs()
+{
+    if (m_outputsDirty) {
+        m_outputsDirty = false;
+        emit componentChanged();
+    }
+}
+
+void DigitalComponent::reset()
+{
+    ElectricalComponent::reset();
+    m_inputs = m_defaultInputs;
+    m_evaluationCount = 0;
+    evaluateAll();
+    commitOutputs();
+}
+
+void DigitalComponent::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_inputs << m_outputs << m_evaluationCount;
+}
+
+void DigitalComponent::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_inputs >> m_outputs >> m_evaluationCount;
+    m_outputsDirty = false;
+}
@@ -1,5 +1,6 @@
 #include "core/ElectricalComponent.h"
 #include "simulation/Node.h"
+#include <QDataStream>
 
 ElectricalComponent::ElectricalComponent(const QString &name, int terminalCount, QObject *parent)
     : Component(name, parent)
@@ -42,9 +43,64 @@ void ElectricalComponent::updateState(double voltage, double current)
     emit stateChanged(voltage, current);
 }
 
+ElectricalComponent::TerminalRole ElectricalComponent::getTerminalRole(int terminal) const
+{
+    Q_UNUSED(terminal)
+    return AnalogTerminal;
+}
+
+bool ElectricalComponent::getDigitalOutput(int terminal) const
+{
+    Q_UNUSED(terminal)
+    return getVoltage() > LogicThreshold;
+}
+
+void ElectricalComponent::digitalInputChanged(int terminal, bool level)
+{
+    Q_UNUSED(terminal)
+    Q_UNUSED(level)
+}
+
+bool ElectricalComponent::receiveTransaction(int terminal, const QByteArray &data)
+{
+    Q_UNUSED(terminal)
+    Q_UNUSED(data)
+    return false;
+}
+
+int ElectricalComponent::transmit(int terminal, const QByteArray &data)
+{
+    Node *node = getNode(terminal);
+    if (!node) {
+        return 0;
+    }
+
+    int accepted = 0;
+    for (const QPair<Component*, int> &connection : node->getConnections()) {
+        ElectricalComponent *receiver = qobject_cast<ElectricalComponent*>(connection.first);
+        if (receiver && receiver != this &&
+            receiver->getTerminalRole(connection.second) == DigitalInput &&
+            receiver->receiveTransaction(connection.second, data)) {
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
 void ElectricalComponent::reset()
 {
     m_voltage = 0.0;
     m_current = 0.0;
     emit stateChanged(m_voltage, m_current);
 }
+
+void ElectricalComponent::saveState(QDataStream &out) const
+{
+    out << m_voltage << m_current;
+}
+
+void ElectricalComponent::restoreState(QDataStream &in)
+{
+    in >> m_voltage >> m_current;
+    emit stateChanged(m_voltage, m_current);
+}
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cmath>
 #include <QDebug>
+#include <QDataStream>
 
 LED::LED(const QColor &color, QObject *parent)
     : ElectricalComponent("LED", 2, parent)
@@ -43,6 +44,26 @@ void LED::updateState(double voltage, double current)
     // Calculate new LED state
     calculateElectricalState();
     
+    finishUpdate(wasOn, prevBrightness);
+}
+
+void LED::setEvaluatedState(double voltage, double current, double brightness, double resistance)
+{
+    bool wasOn = m_isOn;
+    double prevBrightness = m_brightness;
+
+    ElectricalComponent::updateState(voltage, current);
+
+    // Lit exactly when conducting, as in calculateElectricalState()
+    m_isOn = brightness > 0.0;
+    m_brightness = brightness;
+    m_dynamicResistance = resistance;
+
+    finishUpdate(wasOn, prevBrightness);
+}
+
+void LED::finishUpdate(bool wasOn, double prevBrightness)
+{
     // Check for overload condition
     checkOverloadCondition();
 
@@ -100,7 +121,7 @@ double LED::calculateBrightness(double current) const
     double maxExcess = m_maxCurrent - m_forwardCurrent;
     
     if (maxExcess > 0) {
-        double saturationFactor = 1.0 + 0.3 * std::log(1.0 + excess / maxExcess);
+        double saturationFactor = 1.0 + BRIGHTNESS_SATURATION * std::log(1.0 + excess / maxExcess);
         return std::min(1.0, saturationFactor);
     }
     
@@ -119,10 +140,9 @@ double LED::calculateDynamicResistance(double current) const
     
     // Empirical model: rd = Vf / I + rs
     // where rs is series resistance (~10-50 ohms for typical LEDs)
-    double seriesResistance = 25.0; // Ohms
     double dynamicComponent = m_forwardVoltage / current;
     
-    return seriesResistance + dynamicComponent;
+    return SERIES_RESISTANCE + dynamicComponent;
 }
 
 void LED::checkOverloadCondition()
@@ -212,6 +232,20 @@ void LED::reset()
     emit ledStateChanged(m_isOn, m_brightness);
 }
 
+void LED::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_isOn << m_brightness << m_dynamicResistance << m_isOverloaded;
+}
+
+void LED::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_isOn >> m_brightness >> m_dynamicResistance >> m_isOverloaded;
+
+    emit ledStateChanged(m_isOn, m_brightness);
+}
+
 LED* LED::createStandardLED(const QString &type, QObject *parent)
 {
     LED *led = nullptr;
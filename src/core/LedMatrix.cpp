@@ -0,0 +1,118 @@
+#include "core/LedMatrix.h"
+#include <QDataStream>
+#include <algorithm>
+#include <cmath>
+
+LedMatrix::LedMatrix(int rows, int columns, const QColor &color, QObject *parent)
+    : ElectricalComponent("LED Matrix", qMax(1, rows) + qMax(1, columns), parent)
+    , m_rows(qMax(1, rows))
+    , m_columns(qMax(1, columns))
+    , m_color(color)
+    , m_forwardVoltage(1.8)      // Red, as for LED
+    , m_forwardCurrent(0.02)
+{
+    if (color == Qt::blue || color == Qt::white) {
+        m_forwardVoltage = 3.2;
+    } else if (color == Qt::green) {
+        m_forwardVoltage = 2.2;
+    } else if (color == Qt::yellow) {
+        m_forwardVoltage = 2.0;
+    }
+
+    int count = getDiodeCount();
+    m_diodeVoltage.fill(0.0, count);
+    m_diodeCurrent.fill(0.0, count);
+    m_conductance.fill(1.0 / OffResistance, count);
+    m_brightness.fill(0.0, count);
+    m_previousBrightness.fill(0.0, count);
+}
+
+void LedMatrix::evaluate(const double *rowVoltages, const double *columnVoltages)
+{
+    const double forwardVoltage = m_forwardVoltage;
+    const double forwardCurrent = m_forwardCurrent;
+    const double offConductance = 1.0 / OffResistance;
+    const int rows = m_rows;
+    const int columns = m_columns;
+
+    double *voltage = m_diodeVoltage.data();
+    double *current = m_diodeCurrent.data();
+    double *conductance = m_conductance.data();
+
+    // Brightness is double-buffered so the change check against the last
+    // step stays out of the vectorized loop
+    m_brightness.swap(m_previousBrightness);
+    double *brightness = m_brightness.data();
+    const double *previousBrightness = m_previousBrightness.constData();
+
+    for (int row = 0; row < rows; ++row) {
+        const double rowVoltage = rowVoltages[row];
+        const int base = row * columns;
+
+        // Same model as LED::calculateElectricalState(), written as selects
+        // over contiguous arrays so the loop vectorizes. Reductions would
+        // pin it to scalar order, so they are taken separately below.
+        for (int column = 0; column < columns; ++column) {
+            const int k = base + column;
+            double v = rowVoltage - columnVoltages[column];
+            double i = v * conductance[k];
+            bool on = (v >= forwardVoltage) & (i > MinConductionCurrent);
+
+            // Both branches are computed and then selected; a conditional
+            // division would keep the loop scalar
+            double safeCurrent = std::max(i, MinConductionCurrent);
+            double onConductance = 1.0 / (SeriesResistance + forwardVoltage / safeCurrent);
+            double onBrightness = std::min(1.0, safeCurrent / forwardCurrent);
+            double g = on ? onConductance : offConductance;
+            double b = on ? onBrightness : 0.0;
+
+            voltage[k] = v;
+            current[k] = i;
+            conductance[k] = g;
+            brightness[k] = b;
+        }
+    }
+
+    const int count = getDiodeCount();
+    double voltageSum = 0.0;
+    double currentSum = 0.0;
+    for (int k = 0; k < count; ++k) {
+        voltageSum += voltage[k];
+        currentSum += current[k];
+    }
+    ElectricalComponent::updateState(voltageSum / count, currentSum);
+
+    bool changed = false;
+    for (int k = 0; k < count && !changed; ++k) {
+        changed = std::abs(brightness[k] - previousBrightness[k]) > 0.01;
+    }
+    if (changed) {
+        emit matrixChanged();
+    }
+}
+
+void LedMatrix::reset()
+{
+    ElectricalComponent::reset();
+
+    m_diodeVoltage.fill(0.0);
+    m_diodeCurrent.fill(0.0);
+    m_conductance.fill(1.0 / OffResistance);
+    m_brightness.fill(0.0);
+    m_previousBrightness.fill(0.0);
+    emit matrixChanged();
+}
+
+void LedMatrix::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_diodeVoltage << m_diodeCurrent << m_conductance << m_brightness;
+}
+
+void LedMatrix::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_diodeVoltage >> m_diodeCurrent >> m_conductance >> m_brightness;
+    m_previousBrightness = m_brightness;
+    emit matrixChanged();
+}
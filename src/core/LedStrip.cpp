@@ -0,0 +1,164 @@
+#include "core/LedStrip.h"
+#include <QDataStream>
+
+LedStrip::LedStrip(int pixelCount, QObject *parent)
+    : ElectricalComponent("WS2812", 4, parent)
+    , m_pixels(qMax(1, pixelCount), qRgb(0, 0, 0))
+    , m_channelSum(0)
+    , m_frameCount(0)
+    , m_bitCount(0)
+    , m_currentByte(0)
+    , m_lineHigh(false)
+    , m_lastEdgeNs(0)
+{
+}
+
+double LedStrip::getSupplyCurrent() const
+{
+    return m_pixels.size() * IdleCurrent + m_channelSum / 255.0 * ChannelCurrent;
+}
+
+double LedStrip::getSupplyConductance() const
+{
+    return getSupplyCurrent() / NominalVoltage;
+}
+
+ElectricalComponent::TerminalRole LedStrip::getTerminalRole(int terminal) const
+{
+    switch (terminal) {
+        case DataIn:
+            return DigitalInput;
+        case DataOut:
+            return DigitalOutput;
+        default:
+            return AnalogTerminal;
+    }
+}
+
+bool LedStrip::getDigitalOutput(int terminal) const
+{
+    // DOUT idles low between frames; data only leaves as transactions
+    Q_UNUSED(terminal)
+    return false;
+}
+
+bool LedStrip::receiveTransaction(int terminal, const QByteArray &data)
+{
+    if (terminal != DataIn) {
+        return false;
+    }
+
+    // Each pixel latches the first 3 bytes it sees (GRB order) and shifts
+    // the rest out; pixels beyond the end of the data keep their color
+    int pixelBytes = qMin(data.size() / 3, m_pixels.size()) * 3;
+    const uchar *bytes = reinterpret_cast<const uchar*>(data.constData());
+    int oldChannelSum = m_channelSum;
+    bool changed = false;
+
+    for (int offset = 0, pixel = 0; offset < pixelBytes; offset += 3, ++pixel) {
+        QRgb color = qRgb(bytes[offset + 1], bytes[offset], bytes[offset + 2]);
+        QRgb &current = m_pixels[pixel];
+        if (color != current) {
+            m_channelSum += bytes[offset] + bytes[offset + 1] + bytes[offset + 2]
+                          - qRed(current) - qGreen(current) - qBlue(current);
+            current = color;
+            changed = true;
+        }
+    }
+    m_frameCount++;
+
+    if (data.size() > pixelBytes) {
+        transmit(DataOut, data.mid(pixelBytes));
+    }
+
+    if (changed) {
+        emit pixelsChanged();
+    }
+    if (m_channelSum != oldChannelSum) {
+        emit componentChanged();    // Supply load changed; needs a solve
+    }
+    return true;
+}
+
+void LedStrip::decodeEdge(bool level, qint64 timeNs)
+{
+    qint64 elapsed = timeNs - m_lastEdgeNs;
+
+    if (level == m_lineHigh) {
+        // A repeated low sample after the reset gap latches as well, so a
+        // waveform can end without a trailing rising edge
+        if (!level && elapsed >= ResetNs) {
+            latchDecodedFrame();
+        }
+        return;
+    }
+
+    if (level) {
+        if (elapsed >= ResetNs) {
+            latchDecodedFrame();
+        }
+    } else {
+        m_currentByte = quint8((m_currentByte << 1) | (elapsed > BitThresholdNs ? 1 : 0));
+        if (++m_bitCount == 8) {
+            m_decoded.append(char(m_currentByte));
+            m_bitCount = 0;
+            m_currentByte = 0;
+        }
+    }
+
+    m_lineHigh = level;
+    m_lastEdgeNs = timeNs;
+}
+
+void LedStrip::latchDecodedFrame()
+{
+    // Bits of an incomplete byte are dropped, like the strip does
+    m_bitCount = 0;
+    m_currentByte = 0;
+    if (m_decoded.isEmpty()) {
+        return;
+    }
+
+    QByteArray frame;
+    frame.swap(m_decoded);
+    receiveTransaction(DataIn, frame);
+}
+
+void LedStrip::reset()
+{
+    ElectricalComponent::reset();
+
+    bool wasLit = m_channelSum != 0;
+    m_pixels.fill(qRgb(0, 0, 0));
+    m_channelSum = 0;
+    m_frameCount = 0;
+    m_decoded.clear();
+    m_bitCount = 0;
+    m_currentByte = 0;
+    m_lineHigh = false;
+    m_lastEdgeNs = 0;
+
+    if (wasLit) {
+        emit pixelsChanged();
+    }
+}
+
+void LedStrip::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_pixels << m_frameCount
+        << m_decoded << m_bitCount << m_currentByte << m_lineHigh << m_lastEdgeNs;
+}
+
+void LedStrip::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_pixels >> m_frameCount
+       >> m_decoded >> m_bitCount >> m_currentByte >> m_lineHigh >> m_lastEdgeNs;
+
+    m_channelSum = 0;
+    for (QRgb color : m_pixels) {
+        m_channelSum += qRed(color) + qGreen(color) + qBlue(color);
+    }
+    emit pixelsChanged();
+}
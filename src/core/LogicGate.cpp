@@ -0,0 +1,88 @@
+#include "core/LogicGate.h"
+#include <QDataStream>
+
+LogicGate::LogicGate(GateType type, int inputCount, QObject *parent)
+    : DigitalComponent(typeName(type),
+                       (type == Not || type == Buffer) ? 1 : qMax(2, inputCount),
+                       1, parent)
+    , m_type(type)
+    , m_highInputs(0)
+{
+    evaluateAll();
+    commitOutputs();
+}
+
+const char* LogicGate::typeName(GateType type)
+{
+    switch (type) {
+        case And:
+            return "AND";
+        case Or:
+            return "OR";
+        case Nand:
+            return "NAND";
+        case Nor:
+            return "NOR";
+        case Xor:
+            return "XOR";
+        case Xnor:
+            return "XNOR";
+        case Not:
+            return "NOT";
+        case Buffer:
+            return "Buffer";
+    }
+    return "Gate";
+}
+
+bool LogicGate::outputFor(int highInputs) const
+{
+    int inputCount = getInputCount();
+
+    switch (m_type) {
+        case And:
+            return highInputs == inputCount;
+        case Or:
+            return highInputs > 0;
+        case Nand:
+            return highInputs != inputCount;
+        case Nor:
+            return highInputs == 0;
+        case Xor:
+            return (highInputs & 1) != 0;
+        case Xnor:
+            return (highInputs & 1) == 0;
+        case Not:
+            return highInputs == 0;
+        case Buffer:
+            return highInputs > 0;
+    }
+    return false;
+}
+
+void LogicGate::evaluate(int input, bool level)
+{
+    Q_UNUSED(input)
+    m_highInputs += level ? 1 : -1;
+    setOutput(0, outputFor(m_highInputs));
+}
+
+void LogicGate::evaluateAll()
+{
+    m_highInputs = 0;
+    for (int i = 0; i < getInputCount(); ++i) {
+        if (getInput(i)) {
+            m_highInputs++;
+        }
+    }
+    setOutput(0, outputFor(m_highInputs));
+}
+
+void LogicGate::restoreState(QDataStream &in)
+{
+    DigitalComponent::restoreState(in);
+
+    // Recount the high inputs; the output is already consistent with them
+    evaluateAll();
+    commitOutputs();
+}
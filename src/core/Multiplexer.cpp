@@ -0,0 +1,68 @@
+#include "core/Multiplexer.h"
+#include <QDataStream>
+
+namespace {
+
+int clampSelectBits(int selectBits)
+{
+    return qBound(1, selectBits, Multiplexer::MaxSelectBits);
+}
+
+// Data inputs, select inputs and the enable
+int inputCountFor(int selectBits)
+{
+    return (1 << selectBits) + selectBits + 1;
+}
+
+}
+
+Multiplexer::Multiplexer(int selectBits, QObject *parent)
+    : DigitalComponent("Multiplexer", inputCountFor(clampSelectBits(selectBits)), 2, parent)
+    , m_selectBits(clampSelectBits(selectBits))
+    , m_selected(0)
+{
+    evaluateAll();
+    commitOutputs();
+}
+
+void Multiplexer::updateOutputs()
+{
+    bool enabled = !getInput(enableTerminal());
+    bool y = enabled && getInput(dataTerminal(m_selected));
+    setOutput(0, y);
+    setOutput(1, !y);
+}
+
+void Multiplexer::evaluate(int input, bool level)
+{
+    int dataInputs = getDataInputCount();
+
+    if (input < dataInputs) {
+        if (input != m_selected) {
+            return;
+        }
+    } else if (input < dataInputs + m_selectBits) {
+        int bit = 1 << (input - dataInputs);
+        m_selected = level ? (m_selected | bit) : (m_selected & ~bit);
+    }
+
+    updateOutputs();
+}
+
+void Multiplexer::evaluateAll()
+{
+    m_selected = 0;
+    for (int bit = 0; bit < m_selectBits; ++bit) {
+        if (getInput(selectTerminal(bit))) {
+            m_selected |= 1 << bit;
+        }
+    }
+    updateOutputs();
+}
+
+void Multiplexer::restoreState(QDataStream &in)
+{
+    DigitalComponent::restoreState(in);
+    evaluateAll();
+    commitOutputs();
+}
@@ -1,4 +1,5 @@
 #include "core/Resistor.h"
+#include <QDataStream>
 
 Resistor::Resistor(double resistance, QObject *parent)
     : ElectricalComponent("Resistor", 2, parent)
@@ -13,3 +14,15 @@ void Resistor::setResistance(double resistance)
         emit componentChanged();
     }
 }
+
+void Resistor::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_resistance;
+}
+
+void Resistor::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_resistance;
+}
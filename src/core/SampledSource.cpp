@@ -0,0 +1,113 @@
+#include "core/SampledSource.h"
+#include <QDataStream>
+#include <QDebug>
+#include <cmath>
+
+SampledSource::SampledSource(Mode mode, QObject *parent)
+    : ElectricalComponent(mode == VoltageSource ? "SampledVoltageSource" : "SampledResistor", 2, parent)
+    , m_mode(mode)
+    , m_scale(1.0)
+    , m_offset(mode == VoltageSource ? 0.0 : 10000.0)
+    , m_looping(false)
+    , m_sourceResistance(1.0)
+    , m_time(0.0)
+    , m_value(0.0)
+{
+    m_value = sampleAt(m_time);
+}
+
+bool SampledSource::load(const QString &fileName)
+{
+    if (!m_stream.open(fileName)) {
+        return false;
+    }
+
+    m_value = sampleAt(m_time);
+    emit componentChanged();
+    return true;
+}
+
+void SampledSource::unload()
+{
+    m_stream.close();
+    m_value = sampleAt(m_time);
+    emit componentChanged();
+}
+
+void SampledSource::setScale(double scale)
+{
+    m_scale = scale;
+    m_value = sampleAt(m_time);
+    emit componentChanged();
+}
+
+void SampledSource::setOffset(double offset)
+{
+    m_offset = offset;
+    m_value = sampleAt(m_time);
+    emit componentChanged();
+}
+
+bool SampledSource::setTime(double time)
+{
+    m_time = time;
+    double value = sampleAt(time);
+    if (value == m_value) {
+        return false;
+    }
+
+    m_value = value;
+    return true;
+}
+
+double SampledSource::sampleAt(double time)
+{
+    if (!m_stream.isOpen()) {
+        return m_offset;
+    }
+
+    double duration = m_stream.getDuration();
+    if (m_looping && duration > 0.0 && time > m_stream.getEndTime()) {
+        time = m_stream.getStartTime() + std::fmod(time - m_stream.getStartTime(), duration);
+    }
+
+    double value = m_stream.valueAt(time) * m_scale + m_offset;
+    return m_mode == VariableResistor ? qMax(value, MinimumResistance) : value;
+}
+
+double SampledSource::getResistance() const
+{
+    return m_mode == VoltageSource ? m_sourceResistance : m_value;
+}
+
+void SampledSource::setSourceResistance(double resistance)
+{
+    if (resistance > 0.0) {
+        m_sourceResistance = resistance;
+        emit componentChanged();
+    }
+}
+
+double SampledSource::getSourceCurrent() const
+{
+    return m_mode == VoltageSource ? m_value / m_sourceResistance : 0.0;
+}
+
+void SampledSource::reset()
+{
+    ElectricalComponent::reset();
+    m_time = 0.0;
+    m_value = sampleAt(m_time);
+}
+
+void SampledSource::saveState(QDataStream &out) const
+{
+    ElectricalComponent::saveState(out);
+    out << m_time << m_value;
+}
+
+void SampledSource::restoreState(QDataStream &in)
+{
+    ElectricalComponent::restoreState(in);
+    in >> m_time >> m_value;
+}
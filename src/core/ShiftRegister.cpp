@@ -0,0 +1,77 @@
+#include "core/ShiftRegister.h"
+#include <QDataStream>
+
+ShiftRegister::ShiftRegister(QObject *parent)
+    : DigitalComponent("74HC595", 5, Bits + 1, parent)
+    , m_shift(0)
+    , m_storage(0)
+{
+    // Unconnected control inputs: not clearing, outputs enabled
+    setInputDefault(Clear, true);
+    setInputDefault(OutputEnable, false);
+    evaluateAll();
+    commitOutputs();
+}
+
+bool ShiftRegister::isOutputEnabled(int output) const
+{
+    return output == SerialOut || !getInput(OutputEnable);
+}
+
+void ShiftRegister::evaluate(int input, bool level)
+{
+    switch (input) {
+        case ShiftClock:
+            if (level && getInput(Clear)) {
+                m_shift = quint8((m_shift << 1) | (getInput(SerialIn) ? 1 : 0));
+                setOutput(SerialOut, m_shift & 0x80);
+            }
+            break;
+
+        case LatchClock:
+            if (level) {
+                m_storage = m_shift;
+                for (int bit = 0; bit < Bits; ++bit) {
+                    setOutput(bit, m_storage & (1 << bit));
+                }
+            }
+            break;
+
+        case Clear:
+            if (!level) {
+                m_shift = 0;
+                setOutput(SerialOut, false);
+            }
+            break;
+
+        case OutputEnable:
+            // Levels are unchanged but Q0..Q7 switch between driving and
+            // high-Z, which the simulator has to see
+            emit componentChanged();
+            break;
+
+        default:
+            break;  // SER is only sampled on SRCLK
+    }
+}
+
+void ShiftRegister::evaluateAll()
+{
+    m_shift = 0;
+    m_storage = 0;
+    for (int output = 0; output <= SerialOut; ++output) {
+        setOutput(output, false);
+    }
+}
+
+void ShiftRegister::saveState(QDataStream &out) const
+{
+    DigitalComponent::saveState(out);
+    out << m_shift << m_storage;
+}
+
+void ShiftRegister::restoreState(QDataStream &in)
+{
+    DigitalComponent::restoreState(in);
+    in >> m_shift >> m_storage;
+}
@@ -9,6 +9,7 @@
 
 #include "simulation/Circuit.h"
 #include "simulation/CircuitSimulator.h"
+#include "simulation/StimulusRecorder.h"
 #include "core/Arduino.h"
 #include "core/LED.h"
 #include "core/Resistor.h"
@@ -17,6 +18,7 @@
 // Global pointers so we can access these from UI
 Circuit* g_circuit = nullptr;
 CircuitSimulator* g_simulator = nullptr;
+StimulusRecorder* g_recorder = nullptr;    // Every user input goes through it
 Arduino* g_arduino = nullptr;
 LED* g_led = nullptr;
 Resistor* g_resistor = nullptr;
@@ -83,6 +85,7 @@ bool setupArduinoLEDCircuit()
     // Create and configure simulator
     g_simulator = new CircuitSimulator(g_circuit);
     g_circuit->setSimulator(g_simulator);
+    g_recorder = new StimulusRecorder(g_simulator);
     
     // Connect simulator signals for debugging and UI updates
     QObject::connect(g_simulator, &CircuitSimulator::simulationStarted, []() {
@@ -125,8 +128,8 @@ bool setupArduinoLEDCircuit()
     });
     
     // Power on Arduino and configure pin
-    g_arduino->powerOn();
-    g_arduino->pinMode(13, Arduino::OUTPUT);
+    g_recorder->setPowered(g_arduino, true);
+    g_recorder->pinMode(g_arduino, 13, Arduino::OUTPUT);
     
     // Check connection validity
     QStringList issues = g_circuit->getConnectionIssues();
@@ -154,6 +157,9 @@ void cleanupCircuit()
     }
     
     try {
+        delete g_recorder;
+        g_recorder = nullptr;
+        
         // Stop simulator first
         if (g_simulator) {
             g_simulator->stop();
@@ -283,7 +289,7 @@ int main(int argc, char *argv[])
     QObject::connect(ledOnButton, &QPushButton::clicked, [=]() {
         if (g_arduino) {
             qDebug() << "\n--- User clicked LED ON ---";
-            g_arduino->digitalWrite(13, Arduino::HIGH);
+            g_recorder->digitalWrite(g_arduino, 13, Arduino::HIGH);
             g_statusLabel->setText("digitalWrite(13, HIGH) - LED should turn ON");
             
             // Update will happen automatically via simulation signals
@@ -293,7 +299,7 @@ int main(int argc, char *argv[])
     QObject::connect(ledOffButton, &QPushButton::clicked, [=]() {
         if (g_arduino) {
             qDebug() << "\n--- User clicked LED OFF ---";
-            g_arduino->digitalWrite(13, Arduino::LOW);
+            g_recorder->digitalWrite(g_arduino, 13, Arduino::LOW);
             g_statusLabel->setText("digitalWrite(13, LOW) - LED should turn OFF");
         }
     });
@@ -303,7 +309,7 @@ int main(int argc, char *argv[])
             qDebug() << "\n--- User clicked PWM 50% ---";
             ArduinoPin* pin13 = g_arduino->getPin(13);
             if (pin13 && pin13->supportsPWM()) {
-                pin13->analogWrite(127); // 50% duty cycle
+                g_recorder->analogWrite(g_arduino, 13, 127); // 50% duty cycle
                 g_statusLabel->setText("analogWrite(13, 127) - LED at 50% brightness");
             } else {
                 g_statusLabel->setText("Pin 13 does not support PWM");
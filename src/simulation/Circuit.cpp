@@ -6,16 +6,21 @@
 #include "core/LED.h"
 #include "core/Resistor.h"
 #include "core/Wire.h"
+#include "core/Bus.h"
 #include "simulation/Node.h"
 #include <QDebug>
+#include <utility>
 
 Circuit::Circuit(QObject *parent)
     : QObject(parent)
+    , m_componentRevision(0)
     , m_simulator(nullptr)
     , m_simulationRunning(false)
     , m_groundNode(nullptr)
     , m_nodeCounter(1)
     , m_externalComponents()
+    , m_updateDepth(0)
+    , m_changePending(false)
 {
     // Create ground node by default
     m_groundNode = createNode();
@@ -32,29 +37,85 @@ Circuit::~Circuit()
         m_simulator->stop();
     }
     
-    qDeleteAll(m_components);
+    // Arduino pins belong to their board; wires and buses are components
+    // and go with the rest
+    for (Component* component : m_components) {
+        if (!m_externalComponents.contains(component)) {
+            delete component;
+        }
+    }
     qDeleteAll(m_nodes);
-    qDeleteAll(m_wires);
 }
 
 void Circuit::addComponent(Component *component)
 {
-    if (component && !m_components.contains(component)) {
-        // If component belongs to Arduino, mark as external
-        ArduinoPin* pin = qobject_cast<ArduinoPin*>(component);
-        if (pin && pin->getArduino()) {
-            m_externalComponents.insert(component);
-        }
-        
-        m_components.append(component);
-        component->setCircuit(this);
-        
-        // Connect component change signals to trigger simulation updates
-        connect(component, &Component::componentChanged, 
-                this, [this, component]() {
-                    this->componentChanged(component);
-                });
-        
+    if (insertComponent(component)) {
+        notifyCircuitChanged();
+    }
+}
+
+void Circuit::addComponents(const QVector<Component*> &components)
+{
+    m_components.reserve(m_components.size() + components.size());
+    
+    bool added = false;
+    for (Component* component : components) {
+        added |= insertComponent(component);
+    }
+    
+    if (added) {
+        notifyCircuitChanged();
+    }
+}
+
+bool Circuit::insertComponent(Component *component)
+{
+    if (!component || isComponentInCircuit(component)) {
+        return false;
+    }
+    
+    // If component belongs to Arduino, mark as external
+    ArduinoPin* pin = qobject_cast<ArduinoPin*>(component);
+    if (pin && pin->getArduino()) {
+        m_externalComponents.insert(component);
+    }
+    
+    m_components.append(component);
+    m_componentRevision++;
+    component->setCircuit(this);
+    
+    // Buses are listed like wires, whichever way they were added
+    Bus* bus = qobject_cast<Bus*>(component);
+    if (bus) {
+        m_buses.append(bus);
+    }
+    
+    // Connect component change signals to trigger simulation updates
+    connect(component, &Component::componentChanged, 
+            this, [this, component]() {
+                this->componentChanged(component);
+            });
+    return true;
+}
+
+void Circuit::beginUpdate()
+{
+    m_updateDepth++;
+}
+
+void Circuit::endUpdate()
+{
+    if (m_updateDepth > 0 && --m_updateDepth == 0 && m_changePending) {
+        m_changePending = false;
+        emit circuitChanged();
+    }
+}
+
+void Circuit::notifyCircuitChanged()
+{
+    if (m_updateDepth > 0) {
+        m_changePending = true;
+    } else {
         emit circuitChanged();
     }
 }
@@ -68,12 +129,15 @@ Node *Circuit::createNode()
 {
     Node *node = new Node(this);
     m_nodes.append(node);
+    emit nodeAdded(node);
     return node;
 }
 
 void Circuit::removeNode(Node *node)
 {
     if (m_nodes.removeOne(node)) {
+        emit nodeRemoved(node);
+        
         // Remove from named nodes if it exists there
         auto it = m_namedNodes.begin();
         while (it != m_namedNodes.end()) {
@@ -90,10 +154,9 @@ void Circuit::removeNode(Node *node)
 
 void Circuit::componentChanged(Component *component)
 {
-    Q_UNUSED(component)
-    
-    // Notify that circuit has changed
-    emit circuitChanged();
+    // Value and state changes keep the topology, so they don't need the
+    // simulator to rebuild its node indexing
+    emit componentValueChanged(component);
 }
 
 void Circuit::startSimulation()
@@ -114,11 +177,11 @@ void Circuit::stopSimulation()
 
 void Circuit::onSimulationStep(int step, double time)
 {
-    // Called by CircuitSimulator after each simulation step
-    qDebug() << "Simulation step" << step << "completed at time" << time;
-    
-    // Here you could emit signals to update UI or perform other step-specific actions
-    // For now, we just log the step completion
+    // Called by CircuitSimulator after each simulation step. This runs on
+    // the solver path, so it must stay cheap; step timing is traced by the
+    // simulator itself.
+    Q_UNUSED(step)
+    Q_UNUSED(time)
 }
 
 // Enhanced node management methods
@@ -164,7 +227,7 @@ void Circuit::setGroundNode(Node* node)
         }
         
         qDebug() << "Ground node changed to node" << m_groundNode->getId();
-        emit circuitChanged();
+        notifyCircuitChanged();
     }
 }
 
@@ -173,9 +236,6 @@ void Circuit::setGroundNode(Node* node)
 bool Circuit::connectComponents(Component* comp1, int terminal1, 
                                Component* comp2, int terminal2)
 {
-
-    bool changed = false;
-
     if (!comp1 || !comp2) {
         qWarning() << "Cannot connect null components";
         return false;
@@ -206,7 +266,7 @@ bool Circuit::connectComponents(Component* comp1, int terminal1,
                  << "to" << comp2->getName() << "terminal" << terminal2
                  << "via new node" << node->getId();
         
-        changed = true;
+        notifyCircuitChanged();
         return true;
     }
     
@@ -214,19 +274,24 @@ bool Circuit::connectComponents(Component* comp1, int terminal1,
     if (node1 && !node2) {
         comp2->connectToNode(node1, terminal2);
         qDebug() << "Connected" << comp2->getName() << "to existing node" << node1->getId();
-        changed = true;
+        notifyCircuitChanged();
         return true;
     }
     
     if (node2 && !node1) {
         comp1->connectToNode(node2, terminal1);
         qDebug() << "Connected" << comp1->getName() << "to existing node" << node2->getId();
-        changed = true;
+        notifyCircuitChanged();
         return true;
     }
     
     // Both components are connected to different nodes - merge the nodes
     if (node1 && node2 && node1 != node2) {
+        // Never merge the ground node away
+        if (node2 == m_groundNode) {
+            std::swap(node1, node2);
+        }
+        
         // Move all connections from node2 to node1
         QVector<QPair<Component*, int>> connections = node2->getConnections();
         for (const auto& connection : connections) {
@@ -238,15 +303,10 @@ bool Circuit::connectComponents(Component* comp1, int terminal1,
         removeNode(node2);
         
         qDebug() << "Merged nodes" << node1->getId() << "and" << node2->getId();
-        changed = true;
+        notifyCircuitChanged();
         return true;
     }
 
-    if (changed)
-    {
-        emit circuitChanged();
-    }
-    
     return false;
 }
 
@@ -266,7 +326,7 @@ bool Circuit::connectComponentToNode(Component* component, int terminal, Node* n
     qDebug() << "Connected" << component->getName() << "terminal" << terminal
              << "to node" << node->getId();
     
-    emit circuitChanged();
+    notifyCircuitChanged();
     return true;
 }
 
@@ -294,7 +354,7 @@ void Circuit::disconnectComponent(Component* component, int terminal)
             removeNode(node);
         }
         
-        emit circuitChanged();
+        notifyCircuitChanged();
     }
 }
 
@@ -310,7 +370,7 @@ void Circuit::disconnectComponent(Component* component)
         }
     }
     
-    emit circuitChanged();
+    notifyCircuitChanged();
 }
 
 // Wire management
@@ -363,6 +423,148 @@ void Circuit::removeWire(Wire* wire)
     qDebug() << "Removed wire";
 }
 
+Bus* Circuit::addBus(const QVector<Node*>& fromNodes, const QVector<Node*>& toNodes)
+{
+    if (fromNodes.isEmpty() || fromNodes.size() != toNodes.size()) {
+        qWarning() << "Cannot create bus: both ends need the same, non-zero number of nodes";
+        return nullptr;
+    }
+    
+    for (int line = 0; line < fromNodes.size(); ++line) {
+        if (!fromNodes[line] || !toNodes[line]) {
+            qWarning() << "Cannot create bus with null nodes";
+            return nullptr;
+        }
+    }
+    
+    Bus* bus = new Bus(fromNodes.size(), this);
+    for (int line = 0; line < fromNodes.size(); ++line) {
+        bus->connectToNode(fromNodes[line], bus->fromTerminal(line));
+        bus->connectToNode(toNodes[line], bus->toTerminal(line));
+    }
+    
+    addComponent(bus);
+    
+    qDebug() << "Created" << bus->getWidth() << "line bus";
+    return bus;
+}
+
+void Circuit::removeBus(Bus* bus)
+{
+    if (!bus) return;
+    
+    removeComponent(bus);
+    
+    qDebug() << "Removed bus";
+}
+
+bool Circuit::connectBus(Component* comp1, int terminal1,
+                         Component* comp2, int terminal2, int width)
+{
+    if (!comp1 || !comp2 || width < 1) {
+        qWarning() << "Cannot connect bus: null components or empty bus";
+        return false;
+    }
+    
+    if (terminal1 < 0 || terminal1 + width > comp1->getTerminalCount() ||
+        terminal2 < 0 || terminal2 + width > comp2->getTerminalCount()) {
+        qWarning() << "Invalid terminal range for" << width << "line bus connection";
+        return false;
+    }
+    
+    bool connected = true;
+    beginUpdate();
+    for (int line = 0; line < width; ++line) {
+        connected &= connectComponents(comp1, terminal1 + line, comp2, terminal2 + line);
+    }
+    endUpdate();
+    
+    return connected;
+}
+
+SubcircuitInstance Circuit::instantiate(SubcircuitTemplate& subcircuit,
+                                        const QVector<Node*>& ports, const QString& name)
+{
+    SubcircuitInstance instance;
+    instance.subcircuit = &subcircuit;
+    instance.name = name;
+    if ((subcircuit.isCompiled() || subcircuit.compile()) &&
+        placeInstance(subcircuit, ports, instance)) {
+        notifyCircuitChanged();
+    }
+    
+    return instance;
+}
+
+QVector<SubcircuitInstance> Circuit::instantiate(SubcircuitTemplate& subcircuit,
+                                                 const QVector<QVector<Node*>>& ports,
+                                                 const QString& namePrefix)
+{
+    const int count = ports.size();
+    QVector<SubcircuitInstance> instances(count);
+    for (int i = 0; i < count; ++i) {
+        instances[i].subcircuit = &subcircuit;
+        instances[i].name = namePrefix + QString::number(i + 1);
+    }
+    
+    if (!subcircuit.isCompiled() && !subcircuit.compile()) {
+        return instances;
+    }
+    
+    m_components.reserve(m_components.size() + count * subcircuit.getElementCount());
+    m_nodes.reserve(m_nodes.size() + count * subcircuit.getInternalNetCount());
+    
+    beginUpdate();
+    for (int i = 0; i < count; ++i) {
+        if (placeInstance(subcircuit, ports[i], instances[i])) {
+            notifyCircuitChanged();
+        }
+    }
+    endUpdate();
+    
+    return instances;
+}
+
+bool Circuit::placeInstance(const SubcircuitTemplate &subcircuit, const QVector<Node*> &ports,
+                            SubcircuitInstance &instance)
+{
+    if (ports.size() != subcircuit.m_ports.size() || ports.contains(nullptr)) {
+        qWarning() << "Cannot instantiate" << subcircuit.m_name << "as" << instance.name
+                   << ": expected" << subcircuit.m_ports.size() << "port nodes";
+        return false;
+    }
+    
+    // Slot -> node for this instance: ports, then fresh internal nets
+    QVector<Node*> nets = ports;
+    nets.reserve(ports.size() + subcircuit.m_internalNets.size());
+    instance.nodes.reserve(subcircuit.m_internalNets.size());
+    for (int net = 0; net < subcircuit.m_internalNets.size(); ++net) {
+        Node* node = createNode();
+        nets.append(node);
+        instance.nodes.append(node);
+    }
+    
+    // Terminals are wired from the compiled slot table directly, without
+    // the per-connection checks and merging of connectComponentToNode()
+    const int* slotTable = subcircuit.m_slots.constData();
+    instance.components.reserve(subcircuit.m_elements.size());
+    for (const SubcircuitTemplate::Element& element : subcircuit.m_elements) {
+        Component* component = element.factory(this);
+        component->setName(instance.name + "." + element.name);
+        for (int terminal = 0; terminal < element.terminalCount; ++terminal) {
+            int slot = slotTable[element.firstTerminal + terminal];
+            if (slot != SubcircuitTemplate::UnconnectedSlot) {
+                component->connectToNode(slot == SubcircuitTemplate::GroundSlot ? m_groundNode : nets[slot],
+                                         terminal);
+            }
+        }
+        insertComponent(component);
+        instance.components.append(component);
+    }
+    
+    return true;
+}
+
 // Arduino integration methods
 bool Circuit::connectArduinoPin(Arduino* arduino, int pinNumber, Node* node)
 {
@@ -382,7 +584,7 @@ bool Circuit::connectArduinoPin(Arduino* arduino, int pinNumber, Node* node)
     }
     
     // Add Arduino pin to circuit if not already added
-    if (!m_components.contains(pin)) {
+    if (!isComponentInCircuit(pin)) {
         addComponent(pin);
     }
     
@@ -436,7 +638,7 @@ bool Circuit::connectArduinoPinByName(Arduino* arduino, const QString& pinName,
     }
     
     // Add Arduino pin to circuit if not already added
-    if (!m_components.contains(pin)) {
+    if (!isComponentInCircuit(pin)) {
         addComponent(pin);
     }
     
@@ -465,6 +667,21 @@ void Circuit::disconnectArduinoPin(Arduino* arduino, int pinNumber)
     qDebug() << "Disconnected Arduino pin" << pinNumber;
 }
 
+QVector<Arduino*> Circuit::getArduinos() const
+{
+    // Arduinos are not components themselves; find them through their pins
+    QVector<Arduino*> arduinos;
+    
+    for (Component* component : m_components) {
+        ArduinoPin* pin = qobject_cast<ArduinoPin*>(component);
+        if (pin && pin->getArduino() && !arduinos.contains(pin->getArduino())) {
+            arduinos.append(pin->getArduino());
+        }
+    }
+    
+    return arduinos;
+}
+
 // Circuit validation methods
 bool Circuit::validateConnections() const
 {
@@ -562,7 +779,8 @@ bool Circuit::createSimpleArduinoLEDCircuit(Arduino* arduino, LED* led, Resistor
 
 bool Circuit::isComponentInCircuit(Component* component) const
 {
-    return m_components.contains(component);
+    // Components point back at the circuit they were added to
+    return component && component->getCircuit() == this;
 }
 
 void Circuit::removeComponentSafely(Component* component)
@@ -577,7 +795,9 @@ void Circuit::removeComponentSafely(Component* component)
                this, nullptr); // Disconnect all connections from this signal to this object
     
     // Then remove from components list
+    m_buses.removeOne(qobject_cast<Bus*>(component));
     if (m_components.removeOne(component)) {
+        m_componentRevision++;
         component->setCircuit(nullptr);
         
         // If this is not an external component, delete it
@@ -587,8 +807,35 @@ void Circuit::removeComponentSafely(Component* component)
             m_externalComponents.remove(component);
         }
         
-        emit circuitChanged();
+        notifyCircuitChanged();
+    }
+}
+
+void Circuit::detachComponent(Component* component)
+{
+    if (!isComponentInCircuit(component)) return;
+    
+    // Disconnect every terminal, dropping nodes that are left empty
+    for (int i = 0; i < component->getTerminalCount(); i++) {
+        Node* node = component->getNode(i);
+        if (node) {
+            component->disconnectFromNode(i);
+            if (node->getConnections().isEmpty() && node != m_groundNode) {
+                removeNode(node);
+            }
+        }
     }
+    
+    disconnect(component, &Component::componentChanged, this, nullptr);
+    
+    m_components.removeOne(component);
+    m_componentRevision++;
+    m_externalComponents.remove(component);
+    m_buses.removeOne(qobject_cast<Bus*>(component));
+    component->setCircuit(nullptr);
+    
+    qDebug() << "Detached component" << component->getName();
+    notifyCircuitChanged();
 }
 
 void Circuit::removeAllComponents()
@@ -603,6 +850,7 @@ void Circuit::removeAllComponents()
     
     // Make sure lists are clear
     m_components.clear();
+    m_componentRevision++;
     m_externalComponents.clear();
 }
 
@@ -0,0 +1,309 @@
+#include "simulation/CircuitGenerator.h"
+#include "simulation/Circuit.h"
+#include "simulation/Node.h"
+#include "core/LED.h"
+#include "core/LedMatrix.h"
+#include "core/Resistor.h"
+#include <QDebug>
+#include <cmath>
+
+namespace {
+// Digital pins 0 and 1 are the serial port
+const int FirstFreePin = 2;
+const double MatrixColumnResistance = 220.0;
+const double IslandResistance = 220.0;
+}
+
+CircuitGenerator::CircuitGenerator(quint32 seed)
+    : m_seed(seed)
+    , m_tolerance(0.05)
+    , m_random(seed)
+{
+}
+
+void CircuitGenerator::reseed()
+{
+    m_random.seed(m_seed);
+}
+
+double CircuitGenerator::spread(double value)
+{
+    return value * (1.0 + m_tolerance * (2.0 * m_random.generateDouble() - 1.0));
+}
+
+double CircuitGenerator::logUniform(double minimum, double maximum)
+{
+    return minimum * std::pow(maximum / minimum, m_random.generateDouble());
+}
+
+Arduino *CircuitGenerator::createBoard(Circuit *circuit, Arduino::BoardType boardType)
+{
+    Arduino *arduino = new Arduino(boardType, circuit);
+    arduino->powerOn();
+    circuit->connectArduinoPinByName(arduino, "GND", circuit->getGroundNode());
+    return arduino;
+}
+
+void CircuitGenerator::drivePin(Circuit *circuit, Arduino *arduino, int pin, bool level, Node *node)
+{
+    arduino->pinMode(pin, Arduino::OUTPUT);
+    arduino->digitalWrite(pin, level ? Arduino::HIGH : Arduino::LOW);
+    circuit->connectArduinoPin(arduino, pin, node);
+}
+
+QVector<Node*> CircuitGenerator::createNodes(Circuit *circuit, int count)
+{
+    QVector<Node*> nodes;
+    nodes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        nodes.append(circuit->createNode());
+    }
+    return nodes;
+}
+
+bool CircuitGenerator::buildResistorMesh(Circuit *circuit, int size, double resistance)
+{
+    if (!circuit || size < 2) {
+        qWarning() << "Cannot build resistor mesh: need a circuit and size >= 2";
+        return false;
+    }
+
+    reseed();
+    circuit->beginUpdate();
+
+    // The far corner is the ground node itself
+    QVector<Node*> nodes = createNodes(circuit, size * size - 1);
+    nodes.append(circuit->getGroundNode());
+
+    QVector<Component*> resistors;
+    resistors.reserve(2 * size * (size - 1));
+    for (int i = 0; i < 2 * size * (size - 1); ++i) {
+        resistors.append(new Resistor(spread(resistance), circuit));
+    }
+    circuit->addComponents(resistors);
+
+    int next = 0;
+    for (int row = 0; row < size; ++row) {
+        for (int column = 0; column < size; ++column) {
+            Node *node = nodes[row * size + column];
+            if (column + 1 < size) {
+                circuit->connectComponentToNode(resistors[next], 0, node);
+                circuit->connectComponentToNode(resistors[next], 1, nodes[row * size + column + 1]);
+                next++;
+            }
+            if (row + 1 < size) {
+                circuit->connectComponentToNode(resistors[next], 0, node);
+                circuit->connectComponentToNode(resistors[next], 1, nodes[(row + 1) * size + column]);
+                next++;
+            }
+        }
+    }
+
+    drivePin(circuit, createBoard(circuit, Arduino::UNO), 13, true, nodes.first());
+
+    circuit->endUpdate();
+    return true;
+}
+
+bool CircuitGenerator::buildLedMatrix(Circuit *circuit, int rows, int columns, bool aggregate)
+{
+    if (!circuit || rows < 1 || columns < 1) {
+        qWarning() << "Cannot build LED matrix: need a circuit and at least one row and column";
+        return false;
+    }
+
+    reseed();
+    circuit->beginUpdate();
+
+    Arduino *arduino = createBoard(circuit, Arduino::MEGA);
+    if (FirstFreePin + rows + columns > arduino->getDigitalPinCount()) {
+        qWarning() << "LED matrix" << rows << "x" << columns << "needs more pins than"
+                   << arduino->getBoardName() << "has";
+        circuit->endUpdate();
+        return false;
+    }
+
+    QVector<Node*> rowNodes = createNodes(circuit, rows);
+    QVector<Node*> cathodeNodes = createNodes(circuit, columns);
+    QVector<Node*> columnPinNodes = createNodes(circuit, columns);
+
+    // Anodes of a row share the row driver; cathodes of a column share the
+    // column resistor
+    const int ledCount = aggregate ? 1 : rows * columns;
+    QVector<Component*> components;
+    components.reserve(ledCount + columns);
+    if (aggregate) {
+        components.append(new LedMatrix(rows, columns, Qt::red, circuit));
+    } else {
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                components.append(LED::createStandardLED("red", circuit));
+            }
+        }
+    }
+    for (int column = 0; column < columns; ++column) {
+        components.append(new Resistor(spread(MatrixColumnResistance), circuit));
+    }
+    circuit->addComponents(components);
+
+    if (aggregate) {
+        LedMatrix *matrix = static_cast<LedMatrix*>(components.first());
+        for (int row = 0; row < rows; ++row) {
+            circuit->connectComponentToNode(matrix, matrix->rowTerminal(row), rowNodes[row]);
+        }
+        for (int column = 0; column < columns; ++column) {
+            circuit->connectComponentToNode(matrix, matrix->columnTerminal(column), cathodeNodes[column]);
+        }
+    } else {
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                Component *led = components[row * columns + column];
+                circuit->connectComponentToNode(led, 0, rowNodes[row]);
+                circuit->connectComponentToNode(led, 1, cathodeNodes[column]);
+            }
+        }
+    }
+    for (int column = 0; column < columns; ++column) {
+        Component *resistor = components[ledCount + column];
+        circuit->connectComponentToNode(resistor, 0, cathodeNodes[column]);
+        circuit->connectComponentToNode(resistor, 1, columnPinNodes[column]);
+    }
+
+    // Enabled rows are driven high, enabled columns sink low
+    for (int row = 0; row < rows; ++row) {
+        bool enabled = m_random.bounded(2) == 1;
+        drivePin(circuit, arduino, FirstFreePin + row, enabled, rowNodes[row]);
+    }
+    for (int column = 0; column < columns; ++column) {
+        bool enabled = m_random.bounded(2) == 1;
+        drivePin(circuit, arduino, FirstFreePin + rows + column, !enabled, columnPinNodes[column]);
+    }
+
+    circuit->endUpdate();
+    return true;
+}
+
+bool CircuitGenerator::buildResistorLadder(Circuit *circuit, int stages, double resistance)
+{
+    if (!circuit || stages < 1) {
+        qWarning() << "Cannot build resistor ladder: need a circuit and at least one stage";
+        return false;
+    }
+
+    reseed();
+    circuit->beginUpdate();
+
+    QVector<Node*> nodes = createNodes(circuit, stages + 1);
+    Node *ground = circuit->getGroundNode();
+
+    // Series R and shunt 2R per stage
+    QVector<Component*> resistors;
+    resistors.reserve(2 * stages);
+    for (int stage = 0; stage < stages; ++stage) {
+        resistors.append(new Resistor(spread(resistance), circuit));
+        resistors.append(new Resistor(spread(2.0 * resistance), circuit));
+    }
+    circuit->addComponents(resistors);
+
+    for (int stage = 0; stage < stages; ++stage) {
+        Component *series = resistors[2 * stage];
+        Component *shunt = resistors[2 * stage + 1];
+        circuit->connectComponentToNode(series, 0, nodes[stage]);
+        circuit->connectComponentToNode(series, 1, nodes[stage + 1]);
+        circuit->connectComponentToNode(shunt, 0, nodes[stage + 1]);
+        circuit->connectComponentToNode(shunt, 1, ground);
+    }
+
+    drivePin(circuit, createBoard(circuit, Arduino::UNO), 13, true, nodes.first());
+
+    circuit->endUpdate();
+    return true;
+}
+
+bool CircuitGenerator::buildRandomGraph(Circuit *circuit, int nodeCount, double averageDegree)
+{
+    if (!circuit || nodeCount < 1) {
+        qWarning() << "Cannot build random graph: need a circuit and at least one node";
+        return false;
+    }
+
+    reseed();
+    circuit->beginUpdate();
+
+    // Vertex 0 is ground, vertex 1 is driven by the source
+    QVector<Node*> vertices;
+    vertices.reserve(nodeCount + 1);
+    vertices.append(circuit->getGroundNode());
+    vertices += createNodes(circuit, nodeCount);
+
+    int edgeCount = qMax(nodeCount, qRound((nodeCount + 1) * averageDegree / 2.0));
+
+    QVector<Component*> resistors;
+    resistors.reserve(edgeCount);
+    for (int i = 0; i < edgeCount; ++i) {
+        resistors.append(new Resistor(logUniform(100.0, 100000.0), circuit));
+    }
+    circuit->addComponents(resistors);
+
+    // Spanning tree first: each vertex joins one vertex before it
+    for (int i = 1; i <= nodeCount; ++i) {
+        Component *resistor = resistors[i - 1];
+        circuit->connectComponentToNode(resistor, 0, vertices[i]);
+        circuit->connectComponentToNode(resistor, 1, vertices[m_random.bounded(i)]);
+    }
+
+    // Remaining edges between random distinct vertices
+    for (int i = nodeCount; i < edgeCount; ++i) {
+        int from = m_random.bounded(nodeCount + 1);
+        int to = m_random.bounded(nodeCount);
+        if (to >= from) {
+            to++;
+        }
+        circuit->connectComponentToNode(resistors[i], 0, vertices[from]);
+        circuit->connectComponentToNode(resistors[i], 1, vertices[to]);
+    }
+
+    drivePin(circuit, createBoard(circuit, Arduino::UNO), 13, true, vertices[1]);
+
+    circuit->endUpdate();
+    return true;
+}
+
+bool CircuitGenerator::buildArduinoIslands(Circuit *circuit, int count)
+{
+    if (!circuit || count < 1) {
+        qWarning() << "Cannot build Arduino islands: need a circuit and at least one island";
+        return false;
+    }
+
+    reseed();
+    circuit->beginUpdate();
+
+    Node *ground = circuit->getGroundNode();
+
+    QVector<Component*> components;
+    components.reserve(2 * count);
+    for (int i = 0; i < count; ++i) {
+        components.append(LED::createStandardLED("red", circuit));
+        components.append(new Resistor(spread(IslandResistance), circuit));
+    }
+    circuit->addComponents(components);
+
+    for (int i = 0; i < count; ++i) {
+        Component *led = components[2 * i];
+        Component *resistor = components[2 * i + 1];
+        Node *pinNode = circuit->createNode();
+        Node *middle = circuit->createNode();
+
+        circuit->connectComponentToNode(led, 0, pinNode);
+        circuit->connectComponentToNode(led, 1, middle);
+        circuit->connectComponentToNode(resistor, 0, middle);
+        circuit->connectComponentToNode(resistor, 1, ground);
+
+        bool level = m_random.bounded(2) == 1;
+        drivePin(circuit, createBoard(circuit, Arduino::UNO), 13, level, pinNode);
+    }
+
+    circuit->endUpdate();
+    return true;
+}
@@ -2,21 +2,67 @@
 #include "simulation/Circuit.h"
 #include "simulation/MatrixSolver.h"
 #include "simulation/Node.h"
+#include "simulation/Tracing.h"
 #include "core/Component.h"
 #include "core/ElectricalComponent.h"
+#include "core/DigitalComponent.h"
+#include "core/LedStrip.h"
+#include "core/LedMatrix.h"
+#include "core/Bus.h"
+#include "core/Breadboard.h"
+#include "core/SampledSource.h"
 #include "core/ArduinoPin.h"
+#include "core/Arduino.h"
+#include "core/LED.h"
 #include <QDebug>
+#include <QDataStream>
+#include <QFile>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QSet>
 #include <algorithm>
 #include <QtMath>
 
+namespace {
+
+// A net joined only through passive terminals (breadboard strips with
+// no lead on them) has nothing stamped on it
+bool isPassiveOnly(Node *node)
+{
+    for (const QPair<Component*, int> &connection : node->getConnections()) {
+        ElectricalComponent *component = qobject_cast<ElectricalComponent*>(connection.first);
+        if (!component || component->getTerminalRole(connection.second) != ElectricalComponent::PassiveTerminal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// An output pin at a level above 0 V is stamped as a voltage source; at 0 V
+// it stays a conductance (threshold avoids floating point issues)
+bool isDrivingPin(const ArduinoPin *pin)
+{
+    return pin->isOutput() && pin->getVoltage() > 0.01;
+}
+
+}
+
 CircuitSimulator::CircuitSimulator(Circuit *circuit, QObject *parent)
     : QObject(parent)
     , m_circuit(circuit)
     , m_matrixSolver(new MatrixSolver(this))
+    , m_indexCount(0)
+    , m_maxFragmentation(0.25)
+    , m_fullRebuildCount(0)
+    , m_incrementalEditCount(0)
+    , m_classifiedRevision(0)
+    , m_classified(false)
     , m_maxIterations(100)
     , m_convergenceTolerance(1e-6)
     , m_timeStep(0.001)
-    , m_minUpdateIntervalMs(10)
+    , m_iterationBudget(0)
+    , m_budgetExhausted(false)
+    , m_boundaryPending(false)
     , m_running(false)
     , m_initialized(false)
     , m_iterationCount(0)
@@ -30,13 +76,22 @@ CircuitSimulator::CircuitSimulator(Circuit *circuit, QObject *parent)
     m_updateTimer.setSingleShot(true);
     connect(&m_updateTimer, &QTimer::timeout, this, &CircuitSimulator::doUpdate);
     
+    connect(&m_metricsDumpTimer, &QTimer::timeout, this, &CircuitSimulator::writeMetricsDump);
+    
     m_lastUpdateTime.start();
+    m_scheduler.setTimeStep(m_timeStep);
     
     // Connect to circuit signals
     if (m_circuit) {
         qDebug() << "DEBUG: Connecting circuit signals";
         connect(m_circuit, &Circuit::circuitChanged, 
                 this, &CircuitSimulator::onCircuitChanged);
+        connect(m_circuit, &Circuit::componentValueChanged,
+                this, &CircuitSimulator::onComponentValueChanged);
+        connect(m_circuit, &Circuit::nodeAdded,
+                this, &CircuitSimulator::onNodeAdded);
+        connect(m_circuit, &Circuit::nodeRemoved,
+                this, &CircuitSimulator::onNodeRemoved);
                 
         // Connect simulator signals back to circuit slots (assuming the circuit has corresponding slots)
         connect(this, &CircuitSimulator::simulationStarted, 
@@ -58,127 +113,153 @@ CircuitSimulator::~CircuitSimulator()
 
 bool CircuitSimulator::initialize()
 {
-    qDebug() << "DEBUG: CircuitSimulator::initialize() starting";
-    
     if (!m_circuit) {
-        qDebug() << "DEBUG: No circuit to simulate";
         emit simulationError("No circuit to simulate");
         return false;
     }
     
     qDebug() << "Initializing circuit simulation";
     
+    // Split off digital nets before indexing; they get no matrix rows
+    m_partition.build(m_circuit);
+    
     // Assign IDs to nodes for matrix indexing
-    qDebug() << "DEBUG: Assigning node IDs";
     assignNodeIds();
     
     // Clear previous state
-    qDebug() << "DEBUG: Clearing previous values";
     m_prevValues.clear();
     
     // Initialize matrix solver
     int nodeCount = getNodeCount();
-    qDebug() << "DEBUG: Node count:" << nodeCount;
     
     if (nodeCount <= 0) {
-        qDebug() << "DEBUG: Circuit has no nodes to simulate";
         emit simulationError("Circuit has no nodes to simulate");
         return false;
     }
     
-    qDebug() << "DEBUG: Setting matrix solver dimension to" << nodeCount;
     m_matrixSolver->setDimension(nodeCount);
     m_matrixSolver->clear();
     
-    // Store initial component values
-    const QVector<Component*> &components = m_circuit->getComponents();
-    qDebug() << "DEBUG: Storing initial values for" << components.size() << "components";
-    
-    for (Component* comp : components) {
-        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
-        if (elecComp) {
-            m_prevValues[elecComp] = qMakePair(elecComp->getVoltage(), elecComp->getCurrent());
-            qDebug() << "DEBUG: Initial values for" << elecComp->getName() 
-                     << "V:" << elecComp->getVoltage() << "I:" << elecComp->getCurrent();
-        }
+    // Sort the components for stamping, and store their initial values
+    classifyComponents();
+    for (ElectricalComponent* elecComp : m_electricalComponents) {
+        m_prevValues[elecComp] = qMakePair(elecComp->getVoltage(), elecComp->getCurrent());
     }
     
+    m_indexCount = nodeCount;
+    m_freeIndices.clear();
+    m_fullRebuildCount++;
+    
     m_initialized = true;
     m_iterationCount = 0;
-    m_simulationTime = 0.0;
     
-    qDebug() << "DEBUG: CircuitSimulator::initialize() completed successfully";
+    // Settle the digital nets from their drivers' current levels
+    m_partition.propagate();
+    
+    // Virtual time keeps running across re-initialization (topology or
+    // component changes); only reset() rewinds it, so time-stamped outputs
+    // such as VCD traces stay monotonic.
+    
     return true;
 }
 
 bool CircuitSimulator::solve()
 {
-    qDebug() << "DEBUG: CircuitSimulator::solve() starting";
+    TRACE_SCOPE("CircuitSimulator::solve");
     
     // Note: No mutex lock here since solve() is always called from functions 
     // that already hold the mutex (doUpdate, step)
     
     if (!m_initialized) {
-        qDebug() << "DEBUG: Not initialized, calling initialize()";
         if (!initialize()) {
-            qDebug() << "DEBUG: Initialize failed";
             return false;
         }
     }
     
+    // Nodes added since the last step only grew the index map; bring the
+    // solver up to size once here rather than once per added node
+    if (m_matrixSolver->getDimension() != m_indexCount) {
+        m_matrixSolver->setDimension(m_indexCount);
+    }
+    
+    // Recorded waveforms follow the virtual clock
+    classifyComponents();
+    for (SampledSource* source : m_sampledSources) {
+        source->setTime(m_simulationTime);
+    }
+    
     // Start a new simulation step
     m_iterationCount = 0;
     bool converged = false;
+    int iterationLimit = m_iterationBudget > 0 ? qMin(m_iterationBudget, m_maxIterations)
+                                               : m_maxIterations;
     
-    qDebug() << "DEBUG: Starting iteration loop, max iterations:" << m_maxIterations;
+    QElapsedTimer stepTimer;
+    QElapsedTimer phaseTimer;
+    stepTimer.start();
     
     // Iterative solving for non-linear components
-    while (m_iterationCount < m_maxIterations && !converged) {
-        qDebug() << "DEBUG: Iteration" << m_iterationCount + 1 << "of" << m_maxIterations;
+    while (m_iterationCount < iterationLimit && !converged) {
+        TRACE_SCOPE("NewtonIteration");
         
         // Build system matrices
-        qDebug() << "DEBUG: Building matrices";
-        if (!buildMatrices()) {
-            qDebug() << "DEBUG: Failed to build circuit matrices";
+        phaseTimer.start();
+        bool built = buildMatrices();
+        m_metrics.addPhaseTime(SimulationMetricsSnapshot::Stamping, phaseTimer.nsecsElapsed());
+        if (!built) {
+            publishMetrics(false, stepTimer.nsecsElapsed());
             emit simulationError("Failed to build circuit matrices");
             return false;
         }
-        qDebug() << "DEBUG: Matrices built successfully";
         
         // Solve the system
-        qDebug() << "DEBUG: Solving matrix system";
-        if (!m_matrixSolver->solve()) {
-            qDebug() << "DEBUG: Failed to solve circuit equations";
+        bool solved = m_matrixSolver->solve();
+        m_metrics.addPhaseTime(SimulationMetricsSnapshot::Factorization,
+                               m_matrixSolver->getLastFactorizationNs());
+        m_metrics.addPhaseTime(SimulationMetricsSnapshot::Substitution,
+                               m_matrixSolver->getLastSubstitutionNs());
+        if (!solved) {
+            publishMetrics(false, stepTimer.nsecsElapsed());
             emit simulationError("Failed to solve circuit equations");
             return false;
         }
-        qDebug() << "DEBUG: Matrix system solved successfully";
         
         // Update component states
-        qDebug() << "DEBUG: Updating component states";
-        if (!updateComponentStates()) {
-            qDebug() << "DEBUG: Failed to update component states";
+        phaseTimer.start();
+        bool updated = updateComponentStates();
+        m_metrics.addPhaseTime(SimulationMetricsSnapshot::StateUpdate, phaseTimer.nsecsElapsed());
+        if (!updated) {
+            publishMetrics(false, stepTimer.nsecsElapsed());
             emit simulationError("Failed to update component states");
             return false;
         }
-        qDebug() << "DEBUG: Component states updated successfully";
         
         // Check for convergence
-        qDebug() << "DEBUG: Checking convergence";
+        phaseTimer.start();
         converged = hasConverged();
-        qDebug() << "DEBUG: Convergence check result:" << (converged ? "CONVERGED" : "NOT CONVERGED");
+        m_metrics.addPhaseTime(SimulationMetricsSnapshot::ConvergenceCheck, phaseTimer.nsecsElapsed());
         
         // Increment iteration counter
         m_iterationCount++;
-        qDebug() << "DEBUG: Completed iteration" << m_iterationCount << "converged:" << converged;
+    }
+    
+    // Out of this update's Newton budget: the next update continues from
+    // the current operating point, so this is not a convergence failure
+    m_budgetExhausted = !converged && iterationLimit < m_maxIterations;
+    
+    publishMetrics(converged || m_budgetExhausted, stepTimer.nsecsElapsed());
+    TRACE_COUNTER("CircuitSimulator.iterations", m_iterationCount);
+    
+    if (m_budgetExhausted) {
+        return false;
     }
     
     // Check if convergence was achieved
     if (converged) {
-        qDebug() << "DEBUG: ✓ Simulation converged after" << m_iterationCount << "iterations";
+        // Digital inputs on analog nets see the settled operating point
+        m_partition.sampleBoundaries([this](Node *node) { return getNodeVoltage(node); });
         emit convergenceAchieved();
     } else {
-        qDebug() << "DEBUG: ✗ Simulation failed to converge after" << m_iterationCount << "iterations";
         emit convergenceFailed(m_iterationCount);
     }
     
@@ -186,10 +267,8 @@ bool CircuitSimulator::solve()
     m_simulationTime += m_timeStep;
     
     // Emit step completed signal
-    qDebug() << "DEBUG: Emitting simulationStepCompleted signal";
     emit simulationStepCompleted(m_iterationCount, m_simulationTime);
     
-    qDebug() << "DEBUG: CircuitSimulator::solve() completed, result:" << converged;
     return converged;
 }
 
@@ -261,82 +340,90 @@ void CircuitSimulator::reset()
     emit simulationReset();
 }
 
-void CircuitSimulator::step()
+bool CircuitSimulator::step()
 {
-    qDebug() << "DEBUG: CircuitSimulator::step() called";
-    
     if (!m_running) {
         // Initialize if needed
         if (!m_initialized) {
-            qDebug() << "DEBUG: Not initialized in step(), calling initialize()";
             if (!initialize()) {
-                qDebug() << "DEBUG: Initialize failed in step()";
-                return;
+                return false;
             }
         }
     }
     
-    // Perform a single simulation step
-    qDebug() << "DEBUG: Calling solve() from step()";
+    // Perform a single simulation step. State changes it makes must not
+    // trigger a nested update, same as in doUpdate(). A step that does not
+    // converge still advances time; one that fails to solve does not.
+    double before = m_simulationTime;
+    bool wasUpdating = m_isUpdating;
+    m_isUpdating = true;
     solve();
+    m_isUpdating = wasUpdating;
+    return m_simulationTime > before;
 }
 
 void CircuitSimulator::triggerUpdate()
 {
-    qDebug() << "DEBUG: CircuitSimulator::triggerUpdate() called";
-    qDebug() << "DEBUG: isUpdating:" << m_isUpdating << "updatePending:" << m_updatePending;
-    
     // Prevent recursive simulation
     if (m_isUpdating) {
         // Already in an update cycle, do nothing
-        qDebug() << "DEBUG: Ignoring recursive simulation update request";
         return;
     }
     
     // Throttle updates to avoid excessive calculations
     int elapsed = m_lastUpdateTime.elapsed();
-    qDebug() << "DEBUG: Time since last update:" << elapsed << "ms, minimum interval:" << m_minUpdateIntervalMs << "ms";
+    int interval = m_scheduler.getUpdateInterval();
     
-    if (elapsed < m_minUpdateIntervalMs) {
+    if (elapsed < interval) {
         // If update is already pending, do nothing
         if (!m_updatePending) {
-            int delay = m_minUpdateIntervalMs - elapsed;
-            qDebug() << "DEBUG: Throttling simulation update, scheduled in" << delay << "ms";
+            int delay = interval - elapsed;
             m_updateTimer.start(std::max(1, delay));
             m_updatePending = true;
-        } else {
-            qDebug() << "DEBUG: Update already pending, not scheduling another";
         }
         return;
     }
     
     // Start immediate update
-    qDebug() << "DEBUG: Starting immediate update";
     doUpdate();
 }
 
 void CircuitSimulator::doUpdate()
 {
-    qDebug() << "DEBUG: CircuitSimulator::doUpdate() called";
-    
     QMutexLocker locker(&m_simulationMutex);
     
     m_isUpdating = true;
     m_updatePending = false;
+    qint64 periodNs = m_lastUpdateTime.nsecsElapsed();
     m_lastUpdateTime.restart();
     
-    qDebug() << "DEBUG: Set isUpdating=true, running=" << m_running;
-    
     if (m_running) {
         // Solve the circuit equations
-        qDebug() << "DEBUG: Calling solve() from doUpdate()";
+        m_iterationBudget = m_scheduler.getIterationBudget(m_maxIterations);
+        double timeBefore = m_simulationTime;
+        
+        m_responseLatency.beginUpdate(ResponseLatency::now());
+        QElapsedTimer solveTimer;
+        solveTimer.start();
         solve();
-    } else {
-        qDebug() << "DEBUG: Not running, skipping solve()";
+        qint64 solveNs = solveTimer.nsecsElapsed();
+        m_responseLatency.endUpdate(ResponseLatency::now());
+        
+        m_iterationBudget = 0;
+        m_scheduler.recordUpdate(periodNs, solveNs, m_iterationCount, m_simulationTime - timeBefore);
+        
+        // Finish an interrupted Newton solve after letting the GUI run, or
+        // re-solve for digital outputs that switched on analog nets.
+        // Recordings advance with simulation time, which is paced by the
+        // SpeedController or explicit step() calls, not by this timer.
+        if (m_budgetExhausted || m_boundaryPending) {
+            m_updateTimer.start(qMax(1, m_scheduler.getUpdateInterval()));
+            m_updatePending = true;
+        }
     }
     
+    m_boundaryPending = false;
     m_isUpdating = false;
-    qDebug() << "DEBUG: CircuitSimulator::doUpdate() completed, isUpdating=false";
 }
 
 // void CircuitSimulator::onComponentChanged()
@@ -356,175 +443,453 @@ void CircuitSimulator::doUpdate()
 //     }
 // }
 
+void CircuitSimulator::onComponentValueChanged(Component *component)
+{
+    if (m_isUpdating) {
+        // State changes made by the solve itself; the first LED among them
+        // is the response to the stimulus being carried
+        if (m_responseLatency.isAwaitingResponse() && qobject_cast<LED*>(component)) {
+            m_responseLatency.response(ResponseLatency::now());
+        }
+        
+        // Logic reacting to an A/D edge: its digital nets follow at once,
+        // its analog-facing outputs need another solve
+        ElectricalComponent *elecComp = qobject_cast<ElectricalComponent*>(component);
+        if (elecComp && m_partition.rolesChanged(elecComp)) {
+            // Output switched to or from high-Z; re-partition and re-solve
+            m_initialized = false;
+            m_boundaryPending = true;
+        } else if (elecComp && m_partition.hasDigitalOutputs(elecComp)) {
+            m_partition.driverChanged(elecComp);
+            if (!m_partition.isDigitalOnly(elecComp)) {
+                m_boundaryPending = true;
+            }
+        }
+        return;
+    }
+    
+    ElectricalComponent *elecComp = qobject_cast<ElectricalComponent*>(component);
+    if (elecComp && m_initialized) {
+        if (m_partition.rolesChanged(elecComp)) {
+            // Pin mode change or PWM start/stop moves nets between the
+            // digital and analog partitions
+            m_initialized = false;
+        } else if (m_running && m_partition.hasDigitalOutputs(elecComp)) {
+            m_partition.driverChanged(elecComp);
+            
+            // Nothing analog to re-solve; the loads already have the level
+            if (m_partition.isDigitalOnly(elecComp)) {
+                return;
+            }
+        }
+    }
+    
+    // Matrices are rebuilt from component state on every iteration, so a
+    // value change only needs a new solve, not a re-initialization
+    if (m_running) {
+        ArduinoPin *pin = qobject_cast<ArduinoPin*>(component);
+        qint64 writtenNs = pin ? pin->takeWriteTimestamp() : 0;
+        if (writtenNs > 0) {
+            m_responseLatency.stimulus(writtenNs, ResponseLatency::now());
+        }
+        triggerUpdate();
+    }
+}
+
+void CircuitSimulator::onNodeAdded(Node *node)
+{
+    if (!m_initialized) {
+        return; // Picked up by the next full initialization
+    }
+    
+    // Reuse a hole left by a removed node before growing the matrix
+    int index = m_freeIndices.isEmpty() ? m_indexCount++ : m_freeIndices.takeLast();
+    m_nodeIndices[node] = index;
+    m_incrementalEditCount++;
+}
+
+void CircuitSimulator::onNodeRemoved(Node *node)
+{
+    if (!m_initialized) {
+        return;
+    }
+    
+    if (m_partition.isDigital(node)) {
+        // Digital nets hold node pointers; rebuild before they dangle
+        m_partition.clear();
+        m_initialized = false;
+        return;
+    }
+    
+    int index = m_nodeIndices.value(node, -1);
+    if (index < 0) {
+        return;
+    }
+    m_nodeIndices.remove(node);
+    
+    if (index == 0) {
+        // Ground row is special; rebuild rather than leave a hole there
+        m_initialized = false;
+        return;
+    }
+    
+    m_freeIndices.append(index);
+    m_incrementalEditCount++;
+    
+    if (m_freeIndices.size() > m_maxFragmentation * m_indexCount) {
+        qDebug() << "Node indexing fragmented," << m_freeIndices.size() << "of"
+                 << m_indexCount << "rows unused; scheduling full rebuild";
+        m_initialized = false;
+    }
+}
+
 void CircuitSimulator::onCircuitChanged()
 {
-    qDebug() << "DEBUG: CircuitSimulator::onCircuitChanged() called";
+    // Node additions, removals and merges have already been applied to the
+    // index map; component (branch) changes need nothing since matrices are
+    // re-stamped from the components on every iteration. Only a new ground
+    // node requires a full rebuild.
+    if (m_initialized && m_nodeIndices.value(m_circuit->getGroundNode(), -1) != 0) {
+        qDebug() << "Ground node changed, reinitializing simulation";
+        m_initialized = false;
+    }
     
-    // Circuit topology has changed - reinitialize and trigger update
-    qDebug() << "Circuit topology changed, reinitializing simulation";
-    m_initialized = false;
+    // A digital net gained or lost a connection; it may no longer be
+    // digital (analog load added) or may have become one
+    if (m_initialized && m_partition.isStale()) {
+        m_initialized = false;
+    }
+    
+    // Forget convergence history of components that left the circuit
+    if (m_initialized) {
+        QSet<Component*> present;
+        present.reserve(m_circuit->getComponents().size());
+        for (Component* comp : m_circuit->getComponents()) {
+            present.insert(comp);
+        }
+        for (auto it = m_prevValues.begin(); it != m_prevValues.end(); ) {
+            if (!present.contains(it.key())) {
+                it = m_prevValues.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
     
     if (m_running) {
-        qDebug() << "DEBUG: Circuit changed and running, triggering update";
-        if(m_running)
-        {
-            triggerUpdate();
+        triggerUpdate();
+    }
+}
+
+void CircuitSimulator::classifyComponents()
+{
+    if (m_classified && m_classifiedRevision == m_circuit->getComponentRevision()) {
+        return;
+    }
+    
+    m_electricalComponents.clear();
+    m_digitalComponents.clear();
+    m_ledStrips.clear();
+    m_breadboards.clear();
+    m_buses.clear();
+    m_ledMatrices.clear();
+    m_leds.clear();
+    m_sampledSources.clear();
+    m_arduinoPins.clear();
+    m_linearComponents.clear();
+    
+    for (Component* comp : m_circuit->getComponents()) {
+        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
+        if (!elecComp) {
+            continue;
+        }
+        m_electricalComponents.append(elecComp);
+        
+        if (DigitalComponent* digital = qobject_cast<DigitalComponent*>(elecComp)) {
+            m_digitalComponents.append(digital);
+        } else if (LedStrip* strip = qobject_cast<LedStrip*>(elecComp)) {
+            m_ledStrips.append(strip);
+        } else if (Breadboard* board = qobject_cast<Breadboard*>(elecComp)) {
+            m_breadboards.append(board);
+        } else if (Bus* bus = qobject_cast<Bus*>(elecComp)) {
+            m_buses.append(bus);
+        } else if (LedMatrix* matrix = qobject_cast<LedMatrix*>(elecComp)) {
+            m_ledMatrices.append(matrix);
+        } else if (LED* led = qobject_cast<LED*>(elecComp)) {
+            m_leds.append(led);
+        } else if (SampledSource* sampled = qobject_cast<SampledSource*>(elecComp)) {
+            m_sampledSources.append(sampled);
+        } else if (ArduinoPin* pin = qobject_cast<ArduinoPin*>(elecComp)) {
+            m_arduinoPins.append(pin);
+        } else {
+            m_linearComponents.append(elecComp);
         }
-    } else {
-        qDebug() << "DEBUG: Circuit changed but not running";
     }
+    
+    m_classifiedRevision = m_circuit->getComponentRevision();
+    m_classified = true;
 }
 
 bool CircuitSimulator::buildMatrices()
 {
-    qDebug() << "DEBUG: CircuitSimulator::buildMatrices() starting";
+    TRACE_SCOPE("CircuitSimulator::buildMatrices");
     
     if (!m_circuit || !m_matrixSolver) {
-        qDebug() << "DEBUG: No circuit or matrix solver";
         return false;
     }
     
+    // Components added or removed since the last iteration
+    classifyComponents();
+    
     // Clear the matrix for a fresh build
-    qDebug() << "DEBUG: Clearing matrix solver";
     m_matrixSolver->clear();
+    m_ledBatch.clear();
     
-    // Process each electrical component
-    const QVector<Component*> &components = m_circuit->getComponents();
-    qDebug() << "DEBUG: Processing" << components.size() << "components for matrix building";
+    // Behavioral logic: every terminal is a Norton equivalent to ground
+    for (DigitalComponent* digital : m_digitalComponents) {
+        for (int terminal = 0; terminal < digital->getTerminalCount(); ++terminal) {
+            int nodeIndex = m_nodeIndices.value(digital->getNode(terminal), -1);
+            if (nodeIndex < 0) {
+                continue;
+            }
+            m_matrixSolver->addConductance(nodeIndex, -1, digital->getTerminalConductance(terminal));
+            m_matrixSolver->addCurrentSource(-1, nodeIndex, digital->getTerminalCurrent(terminal));
+        }
+    }
     
-    int processedComponents = 0;
+    // LED strip: the supply draw of all pixels is one conductance;
+    // DIN and DOUT only need to keep their nets solvable
+    for (LedStrip* strip : m_ledStrips) {
+        int supply = m_nodeIndices.value(strip->getNode(LedStrip::Supply), -1);
+        int ground = m_nodeIndices.value(strip->getNode(LedStrip::Ground), -1);
+        if (supply >= 0 && ground >= 0) {
+            m_matrixSolver->addConductance(supply, ground, strip->getSupplyConductance());
+        }
+        
+        int dataIn = m_nodeIndices.value(strip->getNode(LedStrip::DataIn), -1);
+        if (dataIn >= 0) {
+            m_matrixSolver->addConductance(dataIn, -1, 1.0 / LedStrip::DataInputResistance);
+        }
+        int dataOut = m_nodeIndices.value(strip->getNode(LedStrip::DataOut), -1);
+        if (dataOut >= 0) {
+            m_matrixSolver->addConductance(dataOut, -1, 1.0 / LedStrip::DataOutputResistance);
+        }
+    }
     
-    for (Component* comp : components) {
-        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
-        if (!elecComp) {
-            qDebug() << "DEBUG: Skipping non-electrical component:" << comp->getName();
+    // Bus: every line is an ideal wire between its two ends
+    for (Bus* bus : m_buses) {
+        const double lineConductance = 1.0 / bus->getResistance();
+        for (int line = 0; line < bus->getWidth(); ++line) {
+            int from = m_nodeIndices.value(bus->getNode(bus->fromTerminal(line)), -1);
+            int to = m_nodeIndices.value(bus->getNode(bus->toTerminal(line)), -1);
+            if (from >= 0 && to >= 0) {
+                m_matrixSolver->addConductance(from, to, lineConductance);
+            }
+        }
+    }
+    
+    // LED matrix: one conductance per diode, stamped as a block between
+    // its row and column nets
+    for (LedMatrix* matrix : m_ledMatrices) {
+        const int columns = matrix->getColumns();
+        const double* conductances = matrix->getConductances().constData();
+        m_matrixColumnIndices.resize(columns);
+        int* columnIndices = m_matrixColumnIndices.data();
+        for (int column = 0; column < columns; ++column) {
+            columnIndices[column] = m_nodeIndices.value(matrix->getNode(matrix->columnTerminal(column)), -1);
+        }
+        for (int row = 0; row < matrix->getRows(); ++row) {
+            int rowIndex = m_nodeIndices.value(matrix->getNode(matrix->rowTerminal(row)), -1);
+            if (rowIndex < 0) {
+                continue;
+            }
+            for (int column = 0; column < columns; ++column) {
+                if (columnIndices[column] >= 0) {
+                    m_matrixSolver->addConductance(rowIndex, columnIndices[column],
+                                                   conductances[row * columns + column]);
+                }
+            }
+        }
+    }
+    
+    // Discrete LEDs are collected and stamped together below
+    for (LED* led : m_leds) {
+        int anode = m_nodeIndices.value(led->getNode(0), -1);
+        int cathode = m_nodeIndices.value(led->getNode(1), -1);
+        if (anode >= 0 && cathode >= 0) {
+            m_ledBatch.add(led, anode, cathode);
+        }
+    }
+    
+    // Recorded source: a Norton equivalent as a voltage source, a
+    // plain conductance as a variable resistor
+    for (SampledSource* sampled : m_sampledSources) {
+        int positive = m_nodeIndices.value(sampled->getNode(SampledSource::Positive), -1);
+        int negative = m_nodeIndices.value(sampled->getNode(SampledSource::Negative), -1);
+        if (positive >= 0 && negative >= 0) {
+            m_matrixSolver->addConductance(positive, negative, 1.0 / sampled->getResistance());
+            m_matrixSolver->addCurrentSource(negative, positive, sampled->getSourceCurrent());
+        }
+    }
+    
+    // Arduino pins: an output driving a level is a voltage source (pinned
+    // below), anything else a conductance to ground
+    for (ArduinoPin* pin : m_arduinoPins) {
+        int nodeIndex = m_nodeIndices.value(pin->getNode(0), -1);
+        if (nodeIndex < 0 || isDrivingPin(pin)) {
             continue;
         }
         
-        processedComponents++;
-        qDebug() << "DEBUG: Processing electrical component" << processedComponents << ":" << elecComp->getName();
-        
+        double resistance = pin->getResistance();
+        m_matrixSolver->addConductance(nodeIndex, -1, 1.0 / (resistance > 0.0 ? resistance : 1e-6));
+    }
+    
+    for (ElectricalComponent* elecComp : m_linearComponents) {
         // Get component resistance/conductance
         double resistance = elecComp->getResistance();
-        qDebug() << "DEBUG: Component resistance:" << resistance << "ohms";
         
         if (resistance <= 0.0) {
             // For ideal voltage sources, use a very small resistance
             // to avoid division by zero
             resistance = 1e-6;
-            qDebug() << "DEBUG: Zero/negative resistance, using" << resistance;
         }
         double conductance = 1.0 / resistance;
-        qDebug() << "DEBUG: Component conductance:" << conductance << "siemens";
         
         // Process based on terminal count
         int terminalCount = elecComp->getTerminalCount();
-        qDebug() << "DEBUG: Component has" << terminalCount << "terminals";
         
         if (terminalCount == 1) {
-            // Single terminal components (e.g., Arduino pins)
-            Node* node = elecComp->getNode(0);
-            if (!node) {
-                qDebug() << "DEBUG: Single terminal component has no connected node";
-                continue;
-            }
-            
-            int nodeIndex = m_nodeIndices.value(node, -1);
-            qDebug() << "DEBUG: Single terminal connected to node" << node->getId() << "matrix index" << nodeIndex;
-            
-            if (nodeIndex < 0) {
-                qDebug() << "DEBUG: Invalid node index for single terminal";
-                continue;
-            }
-            
-            // Check if this is an Arduino pin in output mode
-            ArduinoPin* pin = qobject_cast<ArduinoPin*>(elecComp);
-            if (pin && pin->isOutput()) {
-                double outputVoltage = pin->getVoltage();
-                qDebug() << "DEBUG: Arduino output pin" << pin->getPinNumber() 
-                         << "output voltage:" << outputVoltage << "V";
-                
-                if (outputVoltage > 0.01) { // Threshold to avoid floating point issues
-                    // Add as voltage source
-                    qDebug() << "DEBUG: Adding voltage source for Arduino pin";
-                    m_matrixSolver->addVoltageSource(nodeIndex, -1, outputVoltage);
-                } else {
-                    // Pin is OUTPUT but at 0V, still add conductance
-                    qDebug() << "DEBUG: Adding conductance for 0V Arduino output pin";
-                    m_matrixSolver->addConductance(nodeIndex, -1, conductance);
-                }
-            } else {
-                // Add as conductance to ground for input pins or non-Arduino components
-                qDebug() << "DEBUG: Adding conductance to ground for single terminal";
+            // Single terminal components: conductance to ground
+            int nodeIndex = m_nodeIndices.value(elecComp->getNode(0), -1);
+            if (nodeIndex >= 0) {
                 m_matrixSolver->addConductance(nodeIndex, -1, conductance);
             }
         }
         else if (terminalCount == 2) {
-            // Two terminal components (e.g., resistors, LEDs)
-            Node* node1 = elecComp->getNode(0);
-            Node* node2 = elecComp->getNode(1);
-            
-            if (!node1 || !node2) {
-                qDebug() << "DEBUG: Two terminal component missing node connections";
-                continue;
-            }
-            
-            int nodeIndex1 = m_nodeIndices.value(node1, -1);
-            int nodeIndex2 = m_nodeIndices.value(node2, -1);
-            
-            qDebug() << "DEBUG: Two terminal connected to nodes" << node1->getId() 
-                     << "(index" << nodeIndex1 << ") and" << node2->getId() << "(index" << nodeIndex2 << ")";
+            // Two terminal components (e.g., resistors)
+            int nodeIndex1 = m_nodeIndices.value(elecComp->getNode(0), -1);
+            int nodeIndex2 = m_nodeIndices.value(elecComp->getNode(1), -1);
             
             if (nodeIndex1 < 0 || nodeIndex2 < 0) {
-                qDebug() << "DEBUG: Invalid node indices for two terminal component";
                 continue;
             }
             
             // Add conductance between the two nodes
-            qDebug() << "DEBUG: Adding conductance between nodes";
             m_matrixSolver->addConductance(nodeIndex1, nodeIndex2, conductance);
         }
-        else {
-            qDebug() << "DEBUG: Unsupported terminal count:" << terminalCount;
+    }
+    
+    m_ledBatch.stamp(m_matrixSolver);
+    
+    // Voltage constraints replace their node's row, so they go in only
+    // after every conductance and current source has been stamped; a
+    // conductance added afterwards would write back into the pinned row.
+    
+    // Output pins driving a level
+    for (ArduinoPin* pin : m_arduinoPins) {
+        int nodeIndex = m_nodeIndices.value(pin->getNode(0), -1);
+        if (nodeIndex >= 0 && isDrivingPin(pin)) {
+            m_matrixSolver->addVoltageSource(nodeIndex, -1, pin->getVoltage());
+        }
+    }
+    
+    // Breadboard strips are the nets themselves and stamp nothing. A net
+    // left with only strips on it since the last full rebuild is pinned
+    // so the system stays solvable.
+    for (Breadboard* board : m_breadboards) {
+        for (int terminal = 0; terminal < board->getTerminalCount(); ++terminal) {
+            Node* node = board->getNode(terminal);
+            int nodeIndex = node ? m_nodeIndices.value(node, -1) : -1;
+            if (nodeIndex > 0 && isPassiveOnly(node)) {
+                m_matrixSolver->setNodeVoltage(nodeIndex, 0.0);
+            }
         }
     }
     
-    qDebug() << "DEBUG: Processed" << processedComponents << "electrical components";
-    qDebug() << "DEBUG: CircuitSimulator::buildMatrices() completed successfully";
+    // Rows of removed nodes have nothing stamped; pin them so the system
+    // stays solvable until the next full rebuild compacts them away
+    for (int index : m_freeIndices) {
+        m_matrixSolver->setNodeVoltage(index, 0.0);
+    }
+    
     return true;
 }
 
 bool CircuitSimulator::updateComponentStates()
 {
-    qDebug() << "DEBUG: CircuitSimulator::updateComponentStates() starting";
+    TRACE_SCOPE("CircuitSimulator::updateComponentStates");
     
     if (!m_circuit || !m_matrixSolver) {
-        qDebug() << "DEBUG: No circuit or matrix solver for state update";
         return false;
     }
     
-    // Process each electrical component
-    const QVector<Component*> &components = m_circuit->getComponents();
-    qDebug() << "DEBUG: Updating states for" << components.size() << "components";
+    // Logic ICs read their inputs through the A/D boundary sampling, and
+    // breadboard strips carry no state of their own
     
-    int updatedComponents = 0;
+    for (LedStrip* strip : m_ledStrips) {
+        int supply = m_nodeIndices.value(strip->getNode(LedStrip::Supply), -1);
+        int ground = m_nodeIndices.value(strip->getNode(LedStrip::Ground), -1);
+        if (supply < 0 || ground < 0) continue;
+        
+        double voltage = m_matrixSolver->getNodeVoltage(supply) - m_matrixSolver->getNodeVoltage(ground);
+        strip->updateState(voltage, voltage * strip->getSupplyConductance());
+    }
     
-    for (Component* comp : components) {
-        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
-        if (!elecComp) continue;
+    for (Bus* bus : m_buses) {
+        m_busDrops.fill(0.0, bus->getWidth());
+        for (int line = 0; line < bus->getWidth(); ++line) {
+            int from = m_nodeIndices.value(bus->getNode(bus->fromTerminal(line)), -1);
+            int to = m_nodeIndices.value(bus->getNode(bus->toTerminal(line)), -1);
+            if (from >= 0 && to >= 0) {
+                m_busDrops[line] = m_matrixSolver->getNodeVoltage(from) - m_matrixSolver->getNodeVoltage(to);
+            }
+        }
+        bus->updateLines(m_busDrops.constData());
+    }
+    
+    for (SampledSource* sampled : m_sampledSources) {
+        int positive = m_nodeIndices.value(sampled->getNode(SampledSource::Positive), -1);
+        int negative = m_nodeIndices.value(sampled->getNode(SampledSource::Negative), -1);
+        if (positive < 0 || negative < 0) continue;
         
-        updatedComponents++;
-        qDebug() << "DEBUG: Updating component" << updatedComponents << ":" << elecComp->getName();
+        // Passive convention like the other components: a source
+        // delivering power carries a negative current
+        double voltage = m_matrixSolver->getNodeVoltage(positive) - m_matrixSolver->getNodeVoltage(negative);
+        double current = voltage / sampled->getResistance() - sampled->getSourceCurrent();
+        sampled->updateState(voltage, current);
+    }
+    
+    for (LedMatrix* matrix : m_ledMatrices) {
+        // resize() keeps the capacity, so this only allocates for a matrix
+        // larger than any seen before
+        m_matrixRowVoltages.resize(matrix->getRows());
+        m_matrixColumnVoltages.resize(matrix->getColumns());
+        for (int row = 0; row < m_matrixRowVoltages.size(); ++row) {
+            int index = m_nodeIndices.value(matrix->getNode(matrix->rowTerminal(row)), -1);
+            m_matrixRowVoltages[row] = index >= 0 ? m_matrixSolver->getNodeVoltage(index) : 0.0;
+        }
+        for (int column = 0; column < m_matrixColumnVoltages.size(); ++column) {
+            int index = m_nodeIndices.value(matrix->getNode(matrix->columnTerminal(column)), -1);
+            m_matrixColumnVoltages[column] = index >= 0 ? m_matrixSolver->getNodeVoltage(index) : 0.0;
+        }
+        matrix->evaluate(m_matrixRowVoltages.constData(), m_matrixColumnVoltages.constData());
+    }
+    
+    // Single terminal components (e.g., Arduino pins)
+    for (ArduinoPin* pin : m_arduinoPins) {
+        int nodeIndex = m_nodeIndices.value(pin->getNode(0), -1);
+        if (nodeIndex < 0) continue;
         
+        double voltage = m_matrixSolver->getNodeVoltage(nodeIndex);
+        pin->updateState(voltage, voltage / pin->getResistance());
+    }
+    
+    for (ElectricalComponent* elecComp : m_linearComponents) {
         // Process based on terminal count
         int terminalCount = elecComp->getTerminalCount();
         
         if (terminalCount == 1) {
-            // Single terminal components (e.g., Arduino pins)
-            Node* node = elecComp->getNode(0);
-            if (!node) continue;
-            
-            int nodeIndex = m_nodeIndices.value(node, -1);
+            int nodeIndex = m_nodeIndices.value(elecComp->getNode(0), -1);
             if (nodeIndex < 0) continue;
             
             // Get the node voltage
@@ -533,21 +898,13 @@ bool CircuitSimulator::updateComponentStates()
             // Calculate current (voltage / resistance)
             double current = voltage / elecComp->getResistance();
             
-            qDebug() << "DEBUG: Single terminal" << elecComp->getName() 
-                     << "V:" << voltage << "I:" << current;
-            
             // Update component with new values but don't trigger recursive update
             elecComp->updateState(voltage, current);
         }
         else if (terminalCount == 2) {
-            // Two terminal components (e.g., resistors, LEDs)
-            Node* node1 = elecComp->getNode(0);
-            Node* node2 = elecComp->getNode(1);
-            
-            if (!node1 || !node2) continue;
-            
-            int nodeIndex1 = m_nodeIndices.value(node1, -1);
-            int nodeIndex2 = m_nodeIndices.value(node2, -1);
+            // Two terminal components (e.g., resistors)
+            int nodeIndex1 = m_nodeIndices.value(elecComp->getNode(0), -1);
+            int nodeIndex2 = m_nodeIndices.value(elecComp->getNode(1), -1);
             
             if (nodeIndex1 < 0 || nodeIndex2 < 0) continue;
             
@@ -559,46 +916,31 @@ bool CircuitSimulator::updateComponentStates()
             // Get the current through the component
             double current = voltage / elecComp->getResistance();
             
-            qDebug() << "DEBUG: Two terminal" << elecComp->getName() 
-                     << "V1:" << v1 << "V2:" << v2 << "V_diff:" << voltage << "I:" << current;
-            
             // Update component with new values but don't trigger recursive update
             elecComp->updateState(voltage, current);
         }
     }
     
-    qDebug() << "DEBUG: Updated" << updatedComponents << "electrical components";
-    qDebug() << "DEBUG: CircuitSimulator::updateComponentStates() completed successfully";
+    m_ledBatch.evaluate(m_matrixSolver);
+    
     return true;
 }
 
 bool CircuitSimulator::hasConverged()
 {
-    qDebug() << "DEBUG: CircuitSimulator::hasConverged() starting";
+    TRACE_SCOPE("CircuitSimulator::hasConverged");
     
     if (m_prevValues.isEmpty()) {
-        qDebug() << "DEBUG: No previous values, not converged";
         return false;
     }
     
     // Check each electrical component for change in voltage/current
-    const QVector<Component*> &components = m_circuit->getComponents();
-    qDebug() << "DEBUG: Checking convergence for" << components.size() << "components";
-    
-    int checkedComponents = 0;
-    
-    for (Component* comp : components) {
-        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
-        if (!elecComp) continue;
-        
-        checkedComponents++;
-        
+    for (ElectricalComponent* elecComp : m_electricalComponents) {
         // Get previous values
         auto prevIt = m_prevValues.find(elecComp);
         if (prevIt == m_prevValues.end()) {
             // No previous value - add current values and consider not converged
             m_prevValues[elecComp] = qMakePair(elecComp->getVoltage(), elecComp->getCurrent());
-            qDebug() << "DEBUG: No previous value for" << elecComp->getName() << "- not converged";
             return false;
         }
         
@@ -613,15 +955,9 @@ bool CircuitSimulator::hasConverged()
         double voltageDiff = qAbs(voltage - prevVoltage);
         double currentDiff = qAbs(current - prevCurrent);
         
-        qDebug() << "DEBUG: Component" << elecComp->getName() 
-                 << "V_diff:" << voltageDiff << "I_diff:" << currentDiff 
-                 << "tolerance:" << m_convergenceTolerance;
-        
         if (voltageDiff > m_convergenceTolerance || 
             currentDiff > m_convergenceTolerance) {
             
-            qDebug() << "DEBUG: Component" << elecComp->getName() << "not converged";
-            
             // Update previous values for next iteration
             m_prevValues[elecComp] = qMakePair(voltage, current);
             return false;
@@ -631,48 +967,289 @@ bool CircuitSimulator::hasConverged()
         m_prevValues[elecComp] = qMakePair(voltage, current);
     }
     
-    qDebug() << "DEBUG: Checked" << checkedComponents << "components - ALL CONVERGED";
     return true;
 }
 
 void CircuitSimulator::assignNodeIds()
 {
-    qDebug() << "DEBUG: CircuitSimulator::assignNodeIds() starting";
-    
     m_nodeIndices.clear();
     
     if (!m_circuit) {
-        qDebug() << "DEBUG: No circuit for node assignment";
         return;
     }
     
     const QVector<Node*> &nodes = m_circuit->getNodes();
-    qDebug() << "DEBUG: Found" << nodes.size() << "nodes in circuit";
     
     // Find ground node first
     Node* groundNode = m_circuit->getGroundNode();
     if (groundNode) {
         // Ground node is always index 0
         m_nodeIndices[groundNode] = 0;
-        qDebug() << "DEBUG: Assigned ground node" << groundNode->getId() << "to matrix index 0";
-    } else {
-        qDebug() << "DEBUG: No ground node found";
     }
     
     // Assign indices to all other nodes
     int nextIndex = (groundNode) ? 1 : 0;
     for (Node* node : nodes) {
-        if (node != groundNode) {
+        if (node != groundNode && !m_partition.isDigital(node)) {
             m_nodeIndices[node] = nextIndex;
-            qDebug() << "DEBUG: Assigned node" << node->getId() << "to matrix index" << nextIndex;
             nextIndex++;
         }
     }
-    
-    qDebug() << "DEBUG: Assigned indices to" << m_nodeIndices.size() << "nodes";
 }
 
 int CircuitSimulator::getNodeCount() const
 {
     return m_nodeIndices.size();
-}
\ No newline at end of file
+}
+
+void CircuitSimulator::publishMetrics(bool converged, qint64 stepNs)
+{
+    m_metrics.setMatrixStats(m_matrixSolver->getDimension(),
+                             m_matrixSolver->getLastNonZeros(),
+                             m_matrixSolver->getLastFactorNonZeros());
+    m_metrics.setTopologyCounts(m_fullRebuildCount, m_incrementalEditCount);
+    m_metrics.setSolverCounts(m_matrixSolver->getResizeCount(),
+                              m_matrixSolver->getReallocationCount());
+    m_metrics.publishStep(m_iterationCount, converged, stepNs);
+}
+
+void CircuitSimulator::startMetricsDump(const QString &fileName, int intervalMs)
+{
+    m_metricsDumpFile = fileName;
+    m_metricsDumpTimer.start(qMax(1, intervalMs));
+}
+
+void CircuitSimulator::stopMetricsDump()
+{
+    m_metricsDumpTimer.stop();
+    m_metricsDumpFile.clear();
+}
+
+void CircuitSimulator::writeMetricsDump()
+{
+    // One JSON object per line, appended
+    QFile file(m_metricsDumpFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot write simulator metrics to" << m_metricsDumpFile;
+        stopMetricsDump();
+        return;
+    }
+    
+    QJsonObject entry = getMetrics().toJson();
+    entry["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    entry["simulationTime"] = m_simulationTime;
+    entry["responseLatency"] = m_responseLatency.toJson();
+    entry["scheduler"] = m_scheduler.toJson();
+    
+    QJsonObject mixedSignal;
+    mixedSignal["enabled"] = m_partition.isEnabled();
+    mixedSignal["digitalNets"] = m_partition.getDigitalNets().size();
+    mixedSignal["analogToDigital"] = m_partition.getAnalogToDigital().size();
+    mixedSignal["digitalToAnalog"] = m_partition.getDigitalToAnalog().size();
+    mixedSignal["events"] = double(m_partition.getEventCount());
+    entry["mixedSignal"] = mixedSignal;
+    file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+    file.write("\n");
+}
+
+double CircuitSimulator::getNodeVoltage(Node *node) const
+{
+    if (!node) {
+        return 0.0;
+    }
+    
+    int index = m_initialized ? m_nodeIndices.value(node, -1) : -1;
+    if (index < 0 || index >= m_matrixSolver->getDimension()) {
+        return node->getVoltage();
+    }
+    return m_matrixSolver->getNodeVoltage(index);
+}
+
+void CircuitSimulator::setDigitalFastPath(bool enabled)
+{
+    if (enabled != m_partition.isEnabled()) {
+        m_partition.setEnabled(enabled);
+        m_partition.clear();
+        m_initialized = false;
+    }
+}
+
+void CircuitSimulator::setReferenceMode(bool enabled)
+{
+    m_matrixSolver->setReferenceMode(enabled);
+}
+
+bool CircuitSimulator::isReferenceMode() const
+{
+    return m_matrixSolver->isReferenceMode();
+}
+
+SimulatorSnapshot CircuitSimulator::saveSnapshot(const SimulatorSnapshot &base)
+{
+    // No mutex lock here: snapshots are typically taken from handlers of
+    // simulationStepCompleted, which run while doUpdate() holds the mutex
+    
+    SimulatorSnapshot snapshot;
+    if (!m_circuit) {
+        return snapshot;
+    }
+    
+    QVector<ElectricalComponent*> components = getElectricalComponents();
+    
+    snapshot.m_topologySignature = computeTopologySignature();
+    snapshot.m_componentCount = components.size();
+    snapshot.m_simulationTime = m_simulationTime;
+    snapshot.m_iterationCount = m_iterationCount;
+    
+    // Pages can only be shared with a snapshot of the same circuit layout
+    bool canShare = base.isValid() && base.m_topologySignature == snapshot.m_topologySignature;
+    
+    // Node voltages (solver solution when available)
+    const QVector<Node*> &nodes = m_circuit->getNodes();
+    QVector<double> nodeVoltages;
+    nodeVoltages.reserve(nodes.size());
+    for (Node* node : nodes) {
+        int index = m_initialized ? m_nodeIndices.value(node, -1) : -1;
+        nodeVoltages.append(index >= 0 ? m_matrixSolver->getNodeVoltage(index) : node->getVoltage());
+    }
+    snapshot.m_nodeVoltages = (canShare && base.m_nodeVoltages == nodeVoltages)
+                              ? base.m_nodeVoltages : nodeVoltages;
+    
+    if (m_initialized) {
+        QVector<double> solution = m_matrixSolver->getSolution();
+        snapshot.m_solution = (canShare && base.m_solution == solution) ? base.m_solution : solution;
+    }
+    
+    // Component state, one page per PAGE_SIZE components
+    int pageCount = (components.size() + SimulatorSnapshot::PAGE_SIZE - 1) / SimulatorSnapshot::PAGE_SIZE;
+    snapshot.m_pages.reserve(pageCount);
+    
+    for (int page = 0; page < pageCount; ++page) {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        
+        int first = page * SimulatorSnapshot::PAGE_SIZE;
+        int last = std::min(first + SimulatorSnapshot::PAGE_SIZE, components.size());
+        for (int i = first; i < last; ++i) {
+            components[i]->saveState(out);
+        }
+        
+        if (canShare && page < base.m_pages.size() && base.m_pages[page] == data) {
+            snapshot.m_pages.append(base.m_pages[page]);
+        } else {
+            snapshot.m_pages.append(data);
+        }
+    }
+    
+    // Board-level Arduino state
+    QByteArray arduinoState;
+    QDataStream arduinoOut(&arduinoState, QIODevice::WriteOnly);
+    for (Arduino* arduino : m_circuit->getArduinos()) {
+        arduino->saveState(arduinoOut);
+    }
+    snapshot.m_arduinoState = (canShare && base.m_arduinoState == arduinoState)
+                              ? base.m_arduinoState : arduinoState;
+    
+    snapshot.m_valid = true;
+    return snapshot;
+}
+
+bool CircuitSimulator::restoreSnapshot(const SimulatorSnapshot &snapshot)
+{
+    if (!snapshot.isValid() || !m_circuit) {
+        qWarning() << "Cannot restore invalid snapshot";
+        return false;
+    }
+    
+    if (snapshot.m_topologySignature != computeTopologySignature()) {
+        qWarning() << "Cannot restore snapshot: circuit topology has changed";
+        return false;
+    }
+    
+    QVector<ElectricalComponent*> components = getElectricalComponents();
+    
+    for (int page = 0; page < snapshot.m_pages.size(); ++page) {
+        QDataStream in(snapshot.m_pages[page]);
+        
+        int first = page * SimulatorSnapshot::PAGE_SIZE;
+        int last = std::min(first + SimulatorSnapshot::PAGE_SIZE, components.size());
+        for (int i = first; i < last; ++i) {
+            components[i]->restoreState(in);
+        }
+        
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "Corrupt snapshot page" << page;
+            return false;
+        }
+    }
+    
+    QDataStream arduinoIn(snapshot.m_arduinoState);
+    for (Arduino* arduino : m_circuit->getArduinos()) {
+        arduino->restoreState(arduinoIn);
+    }
+    
+    const QVector<Node*> &nodes = m_circuit->getNodes();
+    for (int i = 0; i < nodes.size() && i < snapshot.m_nodeVoltages.size(); ++i) {
+        nodes[i]->setVoltage(snapshot.m_nodeVoltages[i]);
+    }
+    
+    // Readers of the solver see the restored operating point, not the
+    // last one solved. A snapshot taken before initialization has no
+    // solution vector; rebuild it from the node voltages instead.
+    if (m_initialized && !m_matrixSolver->setSolution(snapshot.m_solution)) {
+        QVector<double> solution(m_matrixSolver->getDimension(), 0.0);
+        for (int i = 0; i < nodes.size() && i < snapshot.m_nodeVoltages.size(); ++i) {
+            int index = m_nodeIndices.value(nodes[i], -1);
+            if (index >= 0 && index < solution.size()) {
+                solution[index] = snapshot.m_nodeVoltages[i];
+            }
+        }
+        m_matrixSolver->setSolution(solution);
+    }
+    
+    m_simulationTime = snapshot.m_simulationTime;
+    m_iterationCount = snapshot.m_iterationCount;
+    
+    // Digital nets take their levels from the restored drivers
+    m_partition.resync();
+    
+    // Convergence checks continue from the restored operating point
+    m_prevValues.clear();
+    for (ElectricalComponent* elecComp : components) {
+        m_prevValues[elecComp] = qMakePair(elecComp->getVoltage(), elecComp->getCurrent());
+    }
+    
+    qDebug() << "Restored snapshot at time" << m_simulationTime;
+    return true;
+}
+
+QVector<ElectricalComponent*> CircuitSimulator::getElectricalComponents() const
+{
+    QVector<ElectricalComponent*> result;
+    
+    const QVector<Component*> &components = m_circuit->getComponents();
+    result.reserve(components.size());
+    for (Component* comp : components) {
+        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
+        if (elecComp) {
+            result.append(elecComp);
+        }
+    }
+    
+    return result;
+}
+
+uint CircuitSimulator::computeTopologySignature() const
+{
+    uint signature = 0;
+    
+    for (Component* comp : m_circuit->getComponents()) {
+        signature = signature * 31 + qHash(comp->getId());
+        for (int i = 0; i < comp->getTerminalCount(); ++i) {
+            Node* node = comp->getNode(i);
+            signature = signature * 31 + (node ? static_cast<uint>(node->getId()) : 0u);
+        }
+    }
+    
+    return signature;
+}
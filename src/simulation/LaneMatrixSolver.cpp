@@ -0,0 +1,275 @@
+#include "simulation/LaneMatrixSolver.h"
+#include "simulation/Tracing.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Gaussian elimination and back substitution over W interleaved systems.
+// W is a compile-time constant so every per-lane loop has a fixed trip
+// count and becomes straight-line vector code.
+template<int W>
+unsigned solveLanes(int n, double *a, double *b, double *x, double epsilon)
+{
+    unsigned failed = 0;
+
+    for (int k = 0; k < n; ++k) {
+        double *pivotRow = a + (k * n) * W;
+
+        // Largest magnitude in column k, per lane
+        double best[W];
+        int row[W];
+        for (int l = 0; l < W; ++l) {
+            best[l] = std::abs(pivotRow[k * W + l]);
+            row[l] = k;
+        }
+        for (int i = k + 1; i < n; ++i) {
+            const double *entry = a + (i * n + k) * W;
+            for (int l = 0; l < W; ++l) {
+                double value = std::abs(entry[l]);
+                bool larger = value > best[l];
+                best[l] = larger ? value : best[l];
+                row[l] = larger ? i : row[l];
+            }
+        }
+
+        // Row exchange; only this part is lane by lane
+        for (int l = 0; l < W; ++l) {
+            if (best[l] < epsilon) {
+                failed |= 1u << l;
+                pivotRow[k * W + l] = 1.0;
+                continue;
+            }
+            if (row[l] != k) {
+                double *other = a + (row[l] * n) * W;
+                for (int j = k; j < n; ++j) {
+                    std::swap(pivotRow[j * W + l], other[j * W + l]);
+                }
+                std::swap(b[k * W + l], b[row[l] * W + l]);
+            }
+        }
+
+        // Normalize the pivot row
+        double inverse[W];
+        for (int l = 0; l < W; ++l) {
+            inverse[l] = 1.0 / pivotRow[k * W + l];
+        }
+        for (int j = k; j < n; ++j) {
+            for (int l = 0; l < W; ++l) {
+                pivotRow[j * W + l] *= inverse[l];
+            }
+        }
+        for (int l = 0; l < W; ++l) {
+            b[k * W + l] *= inverse[l];
+        }
+
+        // Eliminate below the pivot
+        for (int i = k + 1; i < n; ++i) {
+            double *target = a + (i * n) * W;
+            double factor[W];
+            bool nonZero = false;
+            for (int l = 0; l < W; ++l) {
+                factor[l] = target[k * W + l];
+                nonZero |= factor[l] != 0.0;
+            }
+            if (!nonZero) {
+                continue;
+            }
+
+            for (int j = k; j < n; ++j) {
+                // Pivot values are read before the target is written, so
+                // the block does not depend on the rows being distinct
+                double pivot[W];
+                for (int l = 0; l < W; ++l) {
+                    pivot[l] = pivotRow[j * W + l];
+                }
+                for (int l = 0; l < W; ++l) {
+                    target[j * W + l] -= factor[l] * pivot[l];
+                }
+            }
+            for (int l = 0; l < W; ++l) {
+                b[i * W + l] -= factor[l] * b[k * W + l];
+            }
+        }
+    }
+
+    // Unit diagonal after normalization
+    for (int i = n - 1; i >= 0; --i) {
+        const double *rowEntries = a + (i * n) * W;
+        double sum[W];
+        for (int l = 0; l < W; ++l) {
+            sum[l] = b[i * W + l];
+        }
+        for (int j = i + 1; j < n; ++j) {
+            for (int l = 0; l < W; ++l) {
+                sum[l] -= rowEntries[j * W + l] * x[j * W + l];
+            }
+        }
+        for (int l = 0; l < W; ++l) {
+            x[i * W + l] = sum[l];
+        }
+    }
+
+    return failed;
+}
+
+} // namespace
+
+LaneMatrixSolver::LaneMatrixSolver()
+    : m_lanes(4)
+    , m_dimension(0)
+    , m_epsilon(1e-10)
+    , m_failedLanes(0)
+{
+}
+
+void LaneMatrixSolver::setLaneCount(int lanes)
+{
+    if (lanes != 4 && lanes != 8) {
+        qWarning() << "Unsupported lane count:" << lanes;
+        return;
+    }
+
+    m_lanes = lanes;
+    if (m_dimension > 0) {
+        setDimension(m_dimension);
+    }
+}
+
+void LaneMatrixSolver::setDimension(int dimension)
+{
+    if (dimension < 1) {
+        qWarning() << "Invalid matrix dimension:" << dimension;
+        return;
+    }
+
+    m_dimension = dimension;
+    m_matrix.resize(dimension * dimension * m_lanes);
+    m_rightHandSide.resize(dimension * m_lanes);
+    m_solution.resize(dimension * m_lanes);
+    clear();
+    std::fill(m_solution.begin(), m_solution.end(), 0.0);
+}
+
+void LaneMatrixSolver::clear()
+{
+    std::fill(m_matrix.begin(), m_matrix.end(), 0.0);
+    std::fill(m_rightHandSide.begin(), m_rightHandSide.end(), 0.0);
+}
+
+void LaneMatrixSolver::addConductance(int nodeA, int nodeB, const double *conductance)
+{
+    bool validA = nodeA >= 0 && nodeA < m_dimension;
+    bool validB = nodeB >= 0 && nodeB < m_dimension;
+    if (!validA || (!validB && nodeB != -1)) {
+        qWarning() << "Invalid node indices in addConductance:" << nodeA << nodeB;
+        return;
+    }
+
+    // Negligible conductances are dropped per lane, as in MatrixSolver
+    double g[MaxLanes];
+    for (int l = 0; l < m_lanes; ++l) {
+        g[l] = conductance[l] < m_epsilon ? 0.0 : conductance[l];
+    }
+
+    double *aa = m_matrix.data() + (nodeA * m_dimension + nodeA) * m_lanes;
+    for (int l = 0; l < m_lanes; ++l) {
+        aa[l] += g[l];
+    }
+    if (nodeB == -1) {
+        return;
+    }
+
+    double *bb = m_matrix.data() + (nodeB * m_dimension + nodeB) * m_lanes;
+    double *ab = m_matrix.data() + (nodeA * m_dimension + nodeB) * m_lanes;
+    double *ba = m_matrix.data() + (nodeB * m_dimension + nodeA) * m_lanes;
+    for (int l = 0; l < m_lanes; ++l) {
+        bb[l] += g[l];
+        ab[l] -= g[l];
+        ba[l] -= g[l];
+    }
+}
+
+void LaneMatrixSolver::addCurrentSource(int nodeA, int nodeB, const double *current)
+{
+    bool validA = nodeA >= 0 && nodeA < m_dimension;
+    bool validB = nodeB >= 0 && nodeB < m_dimension;
+    if ((!validA && nodeA != -1) || (!validB && nodeB != -1)) {
+        qWarning() << "Invalid node indices in addCurrentSource:" << nodeA << nodeB;
+        return;
+    }
+
+    // Positive current flows from nodeA to nodeB
+    if (validA) {
+        double *rhs = m_rightHandSide.data() + nodeA * m_lanes;
+        for (int l = 0; l < m_lanes; ++l) {
+            rhs[l] -= current[l];
+        }
+    }
+    if (validB) {
+        double *rhs = m_rightHandSide.data() + nodeB * m_lanes;
+        for (int l = 0; l < m_lanes; ++l) {
+            rhs[l] += current[l];
+        }
+    }
+}
+
+void LaneMatrixSolver::setNodeVoltage(int node, const double *voltage)
+{
+    if (node < 0 || node >= m_dimension) {
+        qWarning() << "Invalid node in setNodeVoltage:" << node;
+        return;
+    }
+
+    double *row = m_matrix.data() + (node * m_dimension) * m_lanes;
+    std::fill(row, row + m_dimension * m_lanes, 0.0);
+    double *rhs = m_rightHandSide.data() + node * m_lanes;
+    for (int l = 0; l < m_lanes; ++l) {
+        row[node * m_lanes + l] = 1.0;
+        rhs[l] = voltage[l];
+    }
+}
+
+bool LaneMatrixSolver::solve()
+{
+    TRACE_SCOPE("LaneMatrixSolver::solve");
+
+    if (m_dimension == 0) {
+        qWarning() << "Matrix not set up for solving.";
+        return false;
+    }
+
+    if (m_lanes == 8) {
+        m_failedLanes = solveLanes<8>(m_dimension, m_matrix.data(), m_rightHandSide.data(),
+                                      m_solution.data(), m_epsilon);
+    } else {
+        m_failedLanes = solveLanes<4>(m_dimension, m_matrix.data(), m_rightHandSide.data(),
+                                      m_solution.data(), m_epsilon);
+    }
+
+    if (m_failedLanes) {
+        qWarning() << "Singular matrix in lanes" << QString::number(m_failedLanes, 2);
+    }
+    return m_failedLanes == 0;
+}
+
+bool LaneMatrixSolver::isLaneSolved(int lane) const
+{
+    return lane >= 0 && lane < m_lanes && !(m_failedLanes & (1u << lane));
+}
+
+double LaneMatrixSolver::getNodeVoltage(int node, int lane) const
+{
+    if (node < 0 || node >= m_dimension || lane < 0 || lane >= m_lanes) {
+        qWarning() << "Invalid node in getNodeVoltage:" << node << "lane" << lane;
+        return 0.0;
+    }
+
+    return m_solution[node * m_lanes + lane];
+}
+
+const double *LaneMatrixSolver::getNodeVoltages(int node) const
+{
+    return m_solution.constData() + node * m_lanes;
+}
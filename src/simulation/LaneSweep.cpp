@@ -0,0 +1,345 @@
+#include "simulation/LaneSweep.h"
+#include "simulation/Circuit.h"
+#include "simulation/Node.h"
+#include "simulation/Tracing.h"
+#include "core/ElectricalComponent.h"
+#include "core/DigitalComponent.h"
+#include "core/LedStrip.h"
+#include "core/LedMatrix.h"
+#include "core/Bus.h"
+#include "core/Breadboard.h"
+#include "core/SampledSource.h"
+#include "core/ArduinoPin.h"
+#include "core/LED.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+LaneSweep::LaneSweep(Circuit *circuit, int lanes)
+    : m_circuit(circuit)
+    , m_compiled(false)
+    , m_maxIterations(100)
+    , m_convergenceTolerance(1e-6)
+    , m_iterationCount(0)
+    , m_convergedLanes(0)
+{
+    m_solver.setLaneCount(lanes);
+}
+
+int LaneSweep::addStamp(StampKind kind, int nodeA, int nodeB, double value)
+{
+    m_stamps.append({kind, nodeA, nodeB});
+    for (int l = 0; l < getLaneCount(); ++l) {
+        m_stampValues.append(value);
+    }
+    return m_stamps.size() - 1;
+}
+
+bool LaneSweep::compile()
+{
+    TRACE_SCOPE("LaneSweep::compile");
+
+    m_compiled = false;
+    m_nodeIndices.clear();
+    m_stamps.clear();
+    m_stampValues.clear();
+    m_stampOf.clear();
+    m_ledAnode.clear();
+    m_ledCathode.clear();
+    m_ledParameters.clear();
+    m_ledResistance.clear();
+    m_ledOf.clear();
+
+    if (!m_circuit) {
+        return false;
+    }
+
+    // Same indexing as CircuitSimulator: ground first
+    Node* groundNode = m_circuit->getGroundNode();
+    int nextIndex = 0;
+    if (groundNode) {
+        m_nodeIndices[groundNode] = nextIndex++;
+    }
+    for (Node* node : m_circuit->getNodes()) {
+        if (node != groundNode) {
+            m_nodeIndices[node] = nextIndex++;
+        }
+    }
+    if (nextIndex == 0) {
+        qWarning() << "Circuit has no nodes to sweep";
+        return false;
+    }
+
+    const int lanes = getLaneCount();
+    for (Component* comp : m_circuit->getComponents()) {
+        ElectricalComponent* elecComp = qobject_cast<ElectricalComponent*>(comp);
+        if (!elecComp) {
+            continue;
+        }
+
+        if (qobject_cast<DigitalComponent*>(elecComp) || qobject_cast<LedStrip*>(elecComp) ||
+            qobject_cast<LedMatrix*>(elecComp) || qobject_cast<Breadboard*>(elecComp) ||
+            qobject_cast<SampledSource*>(elecComp)) {
+            qWarning() << "Cannot sweep" << elecComp->getName() << ": component type not supported";
+            return false;
+        }
+
+        Bus* bus = qobject_cast<Bus*>(elecComp);
+        if (bus) {
+            for (int line = 0; line < bus->getWidth(); ++line) {
+                int from = m_nodeIndices.value(bus->getNode(bus->fromTerminal(line)), -1);
+                int to = m_nodeIndices.value(bus->getNode(bus->toTerminal(line)), -1);
+                if (from >= 0 && to >= 0) {
+                    addStamp(ConductanceStamp, from, to, 1.0 / bus->getResistance());
+                }
+            }
+            continue;
+        }
+
+        LED* led = qobject_cast<LED*>(elecComp);
+        if (led) {
+            int anode = m_nodeIndices.value(led->getNode(0), -1);
+            int cathode = m_nodeIndices.value(led->getNode(1), -1);
+            if (anode >= 0 && cathode >= 0) {
+                m_ledOf[led] = m_ledAnode.size();
+                m_ledAnode.append(anode);
+                m_ledCathode.append(cathode);
+                for (int l = 0; l < lanes; ++l) {
+                    m_ledParameters.append(LedBatch::parametersOf(led));
+                    m_ledResistance.append(led->getResistance());
+                }
+            }
+            continue;
+        }
+
+        // The generic one- and two-terminal cases of buildMatrices()
+        double resistance = elecComp->getResistance();
+        if (resistance <= 0.0) {
+            resistance = 1e-6;
+        }
+
+        int terminalCount = elecComp->getTerminalCount();
+        if (terminalCount == 1) {
+            int nodeIndex = m_nodeIndices.value(elecComp->getNode(0), -1);
+            if (nodeIndex < 0) {
+                continue;
+            }
+
+            ArduinoPin* pin = qobject_cast<ArduinoPin*>(elecComp);
+            if (pin && pin->isOutput() && pin->getVoltage() > 0.01) {
+                m_stampOf[elecComp] = addStamp(SourceStamp, nodeIndex, -1, pin->getVoltage());
+            } else {
+                m_stampOf[elecComp] = addStamp(ConductanceStamp, nodeIndex, -1, 1.0 / resistance);
+            }
+        } else if (terminalCount == 2) {
+            int nodeIndex1 = m_nodeIndices.value(elecComp->getNode(0), -1);
+            int nodeIndex2 = m_nodeIndices.value(elecComp->getNode(1), -1);
+            if (nodeIndex1 >= 0 && nodeIndex2 >= 0) {
+                m_stampOf[elecComp] = addStamp(ConductanceStamp, nodeIndex1, nodeIndex2, 1.0 / resistance);
+            }
+        }
+    }
+
+    const int diodeLanes = m_ledAnode.size() * lanes;
+    m_ledVoltage.fill(0.0, diodeLanes);
+    m_ledCurrent.fill(0.0, diodeLanes);
+    m_ledBrightness.fill(0.0, diodeLanes);
+    m_previousVoltage.fill(0.0, nextIndex * lanes);
+    m_previousCurrent.fill(0.0, diodeLanes);
+
+    m_solver.setDimension(nextIndex);
+    m_iterationCount = 0;
+    m_convergedLanes = 0;
+    m_compiled = true;
+    return true;
+}
+
+int LaneSweep::laneIndex(const QHash<const Component*, int> &indices, const Component *component, int lane) const
+{
+    if (lane < 0 || lane >= getLaneCount()) {
+        return -1;
+    }
+
+    int index = indices.value(component, -1);
+    return index >= 0 ? index * getLaneCount() + lane : -1;
+}
+
+bool LaneSweep::setResistance(Component *component, int lane, double resistance)
+{
+    int index = laneIndex(m_stampOf, component, lane);
+    if (index < 0 || m_stamps[index / getLaneCount()].kind != ConductanceStamp) {
+        return false;
+    }
+
+    m_stampValues[index] = 1.0 / (resistance > 0.0 ? resistance : 1e-6);
+    return true;
+}
+
+bool LaneSweep::setSourceVoltage(ArduinoPin *pin, int lane, double voltage)
+{
+    int index = laneIndex(m_stampOf, pin, lane);
+    if (index < 0 || m_stamps[index / getLaneCount()].kind != SourceStamp) {
+        return false;
+    }
+
+    m_stampValues[index] = voltage;
+    return true;
+}
+
+bool LaneSweep::setForwardVoltage(LED *led, int lane, double voltage)
+{
+    int index = laneIndex(m_ledOf, led, lane);
+    if (index < 0) {
+        return false;
+    }
+
+    m_ledParameters[index].forwardVoltage = voltage;
+    return true;
+}
+
+bool LaneSweep::solve()
+{
+    TRACE_SCOPE("LaneSweep::solve");
+
+    if (!m_compiled && !compile()) {
+        return false;
+    }
+
+    const int lanes = getLaneCount();
+    const unsigned allLanes = (1u << lanes) - 1;
+    const int nodeCount = m_solver.getDimension();
+    const int diodes = m_ledAnode.size();
+    const int diodeLanes = diodes * lanes;
+
+    m_iterationCount = 0;
+    m_convergedLanes = 0;
+
+    // Each lane continues from its last operating point
+    while (m_iterationCount < m_maxIterations && m_convergedLanes != allLanes) {
+        TRACE_SCOPE("LaneNewtonIteration");
+
+        m_solver.clear();
+        const double* values = m_stampValues.constData();
+        for (int s = 0; s < m_stamps.size(); ++s) {
+            const Stamp &stamp = m_stamps[s];
+            if (stamp.kind != SourceStamp) {
+                m_solver.addConductance(stamp.nodeA, stamp.nodeB, values + s * lanes);
+            }
+        }
+
+        double conductance[LaneMatrixSolver::MaxLanes];
+        const double* resistance = m_ledResistance.constData();
+        for (int d = 0; d < diodes; ++d) {
+            for (int l = 0; l < lanes; ++l) {
+                conductance[l] = 1.0 / resistance[d * lanes + l];
+            }
+            m_solver.addConductance(m_ledAnode[d], m_ledCathode[d], conductance);
+        }
+
+        // Sources replace their row, so they go in after every conductance,
+        // diodes included, as buildMatrices does
+        for (int s = 0; s < m_stamps.size(); ++s) {
+            const Stamp &stamp = m_stamps[s];
+            if (stamp.kind == SourceStamp) {
+                m_solver.setNodeVoltage(stamp.nodeA, values + s * lanes);
+            }
+        }
+
+        // A singular lane fails on its own and never converges
+        m_solver.solve();
+        unsigned solvedLanes = 0;
+        for (int l = 0; l < lanes; ++l) {
+            if (m_solver.isLaneSolved(l)) {
+                solvedLanes |= 1u << l;
+            }
+        }
+
+        // Diode voltages, then the model over every diode of every lane
+        double* voltage = m_ledVoltage.data();
+        for (int d = 0; d < diodes; ++d) {
+            const double* anode = m_solver.getNodeVoltages(m_ledAnode[d]);
+            const double* cathode = m_solver.getNodeVoltages(m_ledCathode[d]);
+            for (int l = 0; l < lanes; ++l) {
+                voltage[d * lanes + l] = anode[l] - cathode[l];
+            }
+        }
+        LedBatch::model(diodeLanes, m_ledParameters.constData(), voltage,
+                        m_ledCurrent.data(), m_ledResistance.data(), m_ledBrightness.data());
+
+        // Largest change per lane, over node voltages and diode currents
+        double change[LaneMatrixSolver::MaxLanes] = {};
+        double* previousVoltage = m_previousVoltage.data();
+        for (int node = 0; node < nodeCount; ++node) {
+            const double* solution = m_solver.getNodeVoltages(node);
+            double* previous = previousVoltage + node * lanes;
+            for (int l = 0; l < lanes; ++l) {
+                change[l] = std::max(change[l], std::abs(solution[l] - previous[l]));
+                previous[l] = solution[l];
+            }
+        }
+        const double* current = m_ledCurrent.constData();
+        double* previousCurrent = m_previousCurrent.data();
+        for (int d = 0; d < diodes; ++d) {
+            for (int l = 0; l < lanes; ++l) {
+                int k = d * lanes + l;
+                change[l] = std::max(change[l], std::abs(current[k] - previousCurrent[k]));
+                previousCurrent[k] = current[k];
+            }
+        }
+
+        m_convergedLanes = 0;
+        for (int l = 0; l < lanes; ++l) {
+            if (change[l] <= m_convergenceTolerance) {
+                m_convergedLanes |= 1u << l;
+            }
+        }
+        m_convergedLanes &= solvedLanes;
+
+        m_iterationCount++;
+    }
+
+    TRACE_COUNTER("LaneSweep.iterations", m_iterationCount);
+    return m_convergedLanes == allLanes;
+}
+
+bool LaneSweep::isLaneConverged(int lane) const
+{
+    return lane >= 0 && lane < getLaneCount() && (m_convergedLanes & (1u << lane));
+}
+
+double LaneSweep::getNodeVoltage(Node *node, int lane) const
+{
+    int index = m_nodeIndices.value(node, -1);
+    return index >= 0 ? m_solver.getNodeVoltage(index, lane) : 0.0;
+}
+
+double LaneSweep::getCurrent(Component *component, int lane) const
+{
+    int index = laneIndex(m_ledOf, component, lane);
+    if (index >= 0) {
+        return m_ledCurrent[index];
+    }
+
+    // Conductances only; a pinned source has no current of its own here
+    index = laneIndex(m_stampOf, component, lane);
+    if (index < 0) {
+        return 0.0;
+    }
+
+    const Stamp &stamp = m_stamps[index / getLaneCount()];
+    if (stamp.kind != ConductanceStamp) {
+        return 0.0;
+    }
+
+    double voltage = m_solver.getNodeVoltage(stamp.nodeA, lane);
+    if (stamp.nodeB >= 0) {
+        voltage -= m_solver.getNodeVoltage(stamp.nodeB, lane);
+    }
+    return voltage * m_stampValues[index];
+}
+
+double LaneSweep::getBrightness(LED *led, int lane) const
+{
+    int index = laneIndex(m_ledOf, led, lane);
+    return index >= 0 ? m_ledBrightness[index] : 0.0;
+}
@@ -0,0 +1,109 @@
+#include "simulation/LatencyHistogram.h"
+#include <QJsonArray>
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(BucketCount, 0)
+    , m_count(0)
+    , m_sum(0)
+    , m_min(0)
+    , m_max(0)
+{
+}
+
+int LatencyHistogram::bucketFor(qint64 ns)
+{
+    if (ns < SubBuckets) {
+        return ns > 0 ? int(ns) : 0;
+    }
+
+    int exponent = SubBucketBits;
+    while (exponent < MaxExponent && (ns >> (exponent + 1)) != 0) {
+        ++exponent;
+    }
+    if ((ns >> (exponent + 1)) != 0) {
+        return BucketCount - 1;    // Beyond the range; clamp into the last bucket
+    }
+
+    int sub = int(ns >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+    return (exponent - SubBucketBits + 1) * SubBuckets + sub;
+}
+
+qint64 LatencyHistogram::bucketLowerBound(int bucket)
+{
+    if (bucket < SubBuckets) {
+        return bucket;
+    }
+    int exponent = bucket / SubBuckets + SubBucketBits - 1;
+    int sub = bucket % SubBuckets;
+    return qint64(SubBuckets + sub) << (exponent - SubBucketBits);
+}
+
+void LatencyHistogram::record(qint64 ns)
+{
+    if (ns < 0) {
+        ns = 0;
+    }
+
+    m_buckets[bucketFor(ns)]++;
+    if (m_count == 0 || ns < m_min) {
+        m_min = ns;
+    }
+    if (ns > m_max) {
+        m_max = ns;
+    }
+    m_sum += ns;
+    m_count++;
+}
+
+void LatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    quint64 rank = quint64(qBound(0.0, p, 1.0) * double(m_count - 1)) + 1;
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            // Middle of the bucket, kept inside the observed range
+            qint64 lower = bucketLowerBound(i);
+            qint64 upper = i + 1 < BucketCount ? bucketLowerBound(i + 1) : m_max + 1;
+            return qBound(m_min, lower + (upper - lower - 1) / 2, m_max);
+        }
+    }
+    return m_max;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    QJsonArray buckets;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (m_buckets[i]) {
+            QJsonArray bucket;
+            bucket.append(double(bucketLowerBound(i)));
+            bucket.append(double(m_buckets[i]));
+            buckets.append(bucket);
+        }
+    }
+
+    QJsonObject json;
+    json["count"] = double(m_count);
+    json["minNs"] = double(getMin());
+    json["meanNs"] = getMean();
+    json["p50Ns"] = double(percentile(0.50));
+    json["p90Ns"] = double(percentile(0.90));
+    json["p99Ns"] = double(percentile(0.99));
+    json["maxNs"] = double(m_max);
+    json["buckets"] = buckets;     // [lowerBoundNs, count]
+    return json;
+}
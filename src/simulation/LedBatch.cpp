@@ -0,0 +1,123 @@
+#include "simulation/LedBatch.h"
+#include "simulation/MatrixSolver.h"
+#include "core/LED.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const double Ln2 = 0.6931471805599453;
+const double Sqrt2 = 1.4142135623730951;
+const quint64 MantissaMask = 0x000fffffffffffffULL;
+const quint64 ExponentOne = 0x3ff0000000000000ULL;     // Exponent field of 1.0
+const quint64 ExponentMagic = 0x4330000000000000ULL;   // Exponent field of 2^52
+}
+
+double LedBatch::fastLog(double x)
+{
+    quint64 bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    // x = 2^e * m with m in [1, 2). The exponent field is converted by
+    // placing it in the mantissa of 2^52, since packed 64-bit integer to
+    // double conversion is not available everywhere.
+    quint64 exponentBits = (bits >> 52) | ExponentMagic;
+    quint64 mantissaBits = (bits & MantissaMask) | ExponentOne;
+    double exponent;
+    double mantissa;
+    std::memcpy(&exponent, &exponentBits, sizeof(exponent));
+    std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+    exponent -= 4503599627370496.0 + 1023.0;
+
+    // Center the mantissa on 1 so the series converges quickly
+    bool high = mantissa > Sqrt2;
+    mantissa = high ? mantissa * 0.5 : mantissa;
+    exponent = high ? exponent + 1.0 : exponent;
+
+    // log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+    double s = (mantissa - 1.0) / (mantissa + 1.0);
+    double s2 = s * s;
+    double series = 1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 * (1.0 / 11)))));
+    return exponent * Ln2 + 2.0 * s * series;
+}
+
+void LedBatch::clear()
+{
+    // resize() keeps the capacity, so refilling does not allocate
+    m_leds.resize(0);
+    m_anode.resize(0);
+    m_cathode.resize(0);
+    m_parameters.resize(0);
+    m_resistance.resize(0);
+}
+
+LedBatch::Parameters LedBatch::parametersOf(const LED *led)
+{
+    double saturationRange = led->getMaxCurrent() - led->getForwardCurrent();
+    return {led->getForwardVoltage(), led->getForwardCurrent(),
+            saturationRange > 0.0 ? 1.0 / saturationRange : 0.0};
+}
+
+void LedBatch::add(LED *led, int anode, int cathode)
+{
+    m_leds.append(led);
+    m_anode.append(anode);
+    m_cathode.append(cathode);
+    m_parameters.append(parametersOf(led));
+    m_resistance.append(led->getResistance());
+}
+
+void LedBatch::stamp(MatrixSolver *solver) const
+{
+    const int count = m_leds.size();
+    for (int k = 0; k < count; ++k) {
+        solver->addConductance(m_anode[k], m_cathode[k], 1.0 / m_resistance[k]);
+    }
+}
+
+void LedBatch::evaluate(const MatrixSolver *solver)
+{
+    const int count = m_leds.size();
+    m_voltage.resize(count);
+    m_current.resize(count);
+    m_brightness.resize(count);
+
+    // Gather
+    double *voltage = m_voltage.data();
+    for (int k = 0; k < count; ++k) {
+        voltage[k] = solver->getNodeVoltage(m_anode[k]) - solver->getNodeVoltage(m_cathode[k]);
+    }
+
+    double *current = m_current.data();
+    double *resistance = m_resistance.data();
+    double *brightness = m_brightness.data();
+    model(count, m_parameters.constData(), voltage, current, resistance, brightness);
+
+    // Scatter; each LED signals its own changes
+    for (int k = 0; k < count; ++k) {
+        m_leds[k]->setEvaluatedState(voltage[k], current[k], brightness[k], resistance[k]);
+    }
+}
+
+void LedBatch::model(int count, const Parameters *parameters, const double *voltage,
+                     double *current, double *resistance, double *brightness)
+{
+    // Same model as LED::calculateElectricalState(), as selects over the
+    // arrays: both branches are computed, then one is kept
+    for (int k = 0; k < count; ++k) {
+        const Parameters &p = parameters[k];
+        double v = voltage[k];
+        double i = v / resistance[k];
+        bool on = (v > 0.0) & (v >= p.forwardVoltage) & (i > LED::MIN_CONDUCTION_CURRENT);
+
+        double safeCurrent = std::max(i, LED::MIN_CONDUCTION_CURRENT);
+        double linear = safeCurrent / p.forwardCurrent;
+        double excess = std::max(safeCurrent - p.forwardCurrent, 0.0) * p.saturationScale;
+        double saturated = std::min(1.0, 1.0 + LED::BRIGHTNESS_SATURATION * fastLog(1.0 + excess));
+        double onBrightness = safeCurrent <= p.forwardCurrent ? linear : saturated;
+        double onResistance = LED::SERIES_RESISTANCE + p.forwardVoltage / safeCurrent;
+
+        current[k] = i;
+        resistance[k] = on ? onResistance : LED::OFF_RESISTANCE;
+        brightness[k] = on ? onBrightness : 0.0;
+    }
+}
@@ -1,47 +1,49 @@
 #include "simulation/MatrixSolver.h"
+#include "simulation/Tracing.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <cmath>
 #include <algorithm>
 
 MatrixSolver::MatrixSolver(QObject *parent)
     : QObject(parent)
     , m_dimension(0)
+    , m_capacity(0)
     , m_isSetup(false)
     , m_epsilon(1e-10)
+    , m_referenceMode(false)
+    , m_lastFactorizationNs(0)
+    , m_lastSubstitutionNs(0)
+    , m_lastNonZeros(0)
+    , m_lastFactorNonZeros(0)
+    , m_resizeCount(0)
+    , m_reallocationCount(0)
 {
-    qDebug() << "DEBUG: MatrixSolver constructor";
 }
 
 MatrixSolver::~MatrixSolver()
 {
-    qDebug() << "DEBUG: MatrixSolver destructor";
     clear();
 }
 
 void MatrixSolver::setDimension(int dimension)
 {
-    qDebug() << "DEBUG: MatrixSolver::setDimension(" << dimension << ")";
-    
     if (dimension < 1) {
         qWarning() << "Invalid matrix dimension:" << dimension;
         return;
     }
 
     m_dimension = dimension;
-    qDebug() << "DEBUG: Setting up matrices for dimension" << dimension;
     setupMatrices();
 }
 
 void MatrixSolver::clear()
 {
-    qDebug() << "DEBUG: MatrixSolver::clear()";
-    
 #ifdef HAVE_EIGEN3
     if (m_dimension > 0) {
         m_conductanceMatrix.setZero();
         m_rightHandSide.setZero();
         m_solution.setZero();
-        qDebug() << "DEBUG: Cleared Eigen matrices";
     }
 #else
     // Zero out matrices but keep allocated memory
@@ -50,21 +52,24 @@ void MatrixSolver::clear()
         m_rightHandSide[i] = 0.0;
         m_solution[i] = 0.0;
     }
-    qDebug() << "DEBUG: Cleared QVector matrices";
 #endif
     m_branchCurrents.clear();
     m_isSetup = true;
-    qDebug() << "DEBUG: MatrixSolver::clear() completed";
 }
 
 void MatrixSolver::setupMatrices()
 {
-    qDebug() << "DEBUG: MatrixSolver::setupMatrices() for dimension" << m_dimension;
-    
-    clear(); // Make sure previous data is cleared
+    // Storage is still sized for the old dimension here, so only drop the
+    // branch data; the matrices are resized and zeroed below
+    m_branchCurrents.clear();
+
+    m_resizeCount++;
 
 #ifdef HAVE_EIGEN3
-    qDebug() << "DEBUG: Using Eigen3 implementation";
+    if (m_dimension != m_capacity) {
+        m_reallocationCount++;
+    }
+    
     // Initialize Eigen matrices
     m_conductanceMatrix.resize(m_dimension, m_dimension);
     m_rightHandSide.resize(m_dimension);
@@ -73,55 +78,55 @@ void MatrixSolver::setupMatrices()
     m_conductanceMatrix.setZero();
     m_rightHandSide.setZero();
     m_solution.setZero();
-    qDebug() << "DEBUG: Eigen matrices initialized";
+    m_capacity = m_dimension;
 #else
-    qDebug() << "DEBUG: Using QVector fallback implementation";
+    // Grow storage geometrically so that incremental topology edits (one
+    // node at a time) don't reallocate every row on every added node.
+    // Shrinking keeps the allocation.
+    if (m_dimension > m_capacity) {
+        m_reallocationCount++;
+        m_capacity = std::max(m_dimension, m_capacity + m_capacity / 2);
+        m_conductanceMatrix.reserve(m_capacity);
+        m_rightHandSide.reserve(m_capacity);
+        m_solution.reserve(m_capacity);
+    }
+    
     // Initialize QVector matrices
     m_conductanceMatrix.resize(m_dimension);
     m_rightHandSide.resize(m_dimension);
     m_solution.resize(m_dimension);
     
     for (int i = 0; i < m_dimension; ++i) {
+        m_conductanceMatrix[i].reserve(m_capacity);
         m_conductanceMatrix[i].resize(m_dimension);
         std::fill(m_conductanceMatrix[i].begin(), m_conductanceMatrix[i].end(), 0.0);
         m_rightHandSide[i] = 0.0;
         m_solution[i] = 0.0;
     }
-    qDebug() << "DEBUG: QVector matrices initialized";
 #endif
 
     m_isSetup = true;
-    qDebug() << "DEBUG: MatrixSolver::setupMatrices() completed";
 }
 
 void MatrixSolver::addConductance(int nodeA, int nodeB, double conductance)
 {
-    qDebug() << "DEBUG: MatrixSolver::addConductance(" << nodeA << "," << nodeB << "," << conductance << ")";
-    
     if (!m_isSetup || conductance < m_epsilon) {
-        qDebug() << "DEBUG: Skipping conductance - not setup:" << !m_isSetup << "too small:" << (conductance < m_epsilon);
         return; // Skip extremely small conductance or uninitalized state
     }
 
     // Handle component connected to ground (nodeB = -1)
     if (nodeB == -1) {
-        qDebug() << "DEBUG: Adding conductance to ground for node" << nodeA;
         // Add diagonal element (self-conductance)
         if (nodeA >= 0 && nodeA < m_dimension) {
 #ifdef HAVE_EIGEN3
             m_conductanceMatrix(nodeA, nodeA) += conductance;
-            qDebug() << "DEBUG: Added" << conductance << "to diagonal element (" << nodeA << "," << nodeA << ")";
 #else
             m_conductanceMatrix[nodeA][nodeA] += conductance;
-            qDebug() << "DEBUG: Added" << conductance << "to diagonal element [" << nodeA << "][" << nodeA << "]";
 #endif
-        } else {
-            qDebug() << "DEBUG: Invalid nodeA index:" << nodeA;
         }
     } 
     // Handle component between two nodes
     else if (nodeA >= 0 && nodeA < m_dimension && nodeB >= 0 && nodeB < m_dimension) {
-        qDebug() << "DEBUG: Adding conductance between nodes" << nodeA << "and" << nodeB;
         // Add to diagonal elements (self-conductance)
 #ifdef HAVE_EIGEN3
         m_conductanceMatrix(nodeA, nodeA) += conductance;
@@ -130,14 +135,12 @@ void MatrixSolver::addConductance(int nodeA, int nodeB, double conductance)
         // Add off-diagonal elements (mutual conductance)
         m_conductanceMatrix(nodeA, nodeB) -= conductance;
         m_conductanceMatrix(nodeB, nodeA) -= conductance;
-        qDebug() << "DEBUG: Added/subtracted" << conductance << "to matrix elements (Eigen)";
 #else
         m_conductanceMatrix[nodeA][nodeA] += conductance;
         m_conductanceMatrix[nodeB][nodeB] += conductance;
         
         m_conductanceMatrix[nodeA][nodeB] -= conductance;
         m_conductanceMatrix[nodeB][nodeA] -= conductance;
-        qDebug() << "DEBUG: Added/subtracted" << conductance << "to matrix elements (QVector)";
 #endif
     } else {
         qWarning() << "Invalid node indices in addConductance:" << nodeA << nodeB;
@@ -146,10 +149,7 @@ void MatrixSolver::addConductance(int nodeA, int nodeB, double conductance)
 
 void MatrixSolver::addCurrentSource(int nodeA, int nodeB, double current)
 {
-    qDebug() << "DEBUG: MatrixSolver::addCurrentSource(" << nodeA << "," << nodeB << "," << current << ")";
-    
     if (!m_isSetup || std::abs(current) < m_epsilon) {
-        qDebug() << "DEBUG: Skipping current source - not setup or too small";
         return; // Skip tiny currents or uninitialized state
     }
 
@@ -164,7 +164,6 @@ void MatrixSolver::addCurrentSource(int nodeA, int nodeB, double current)
 #else
             m_rightHandSide[nodeA] -= current;
 #endif
-            qDebug() << "DEBUG: Added current source from ground to node" << nodeA;
         }
     }
     // Handle current flowing from ground to a node
@@ -175,7 +174,6 @@ void MatrixSolver::addCurrentSource(int nodeA, int nodeB, double current)
 #else
             m_rightHandSide[nodeB] += current;
 #endif
-            qDebug() << "DEBUG: Added current source from ground to node" << nodeB;
         }
     }
     // Handle current between two nodes
@@ -187,7 +185,6 @@ void MatrixSolver::addCurrentSource(int nodeA, int nodeB, double current)
         m_rightHandSide[nodeA] -= current;
         m_rightHandSide[nodeB] += current;
 #endif
-        qDebug() << "DEBUG: Added current source between nodes" << nodeA << "and" << nodeB;
     } else {
         qWarning() << "Invalid node indices in addCurrentSource:" << nodeA << nodeB;
     }
@@ -198,10 +195,7 @@ void MatrixSolver::addCurrentSource(int nodeA, int nodeB, double current)
 
 void MatrixSolver::addVoltageSource(int nodeA, int nodeB, double voltage)
 {
-    qDebug() << "DEBUG: MatrixSolver::addVoltageSource(" << nodeA << "," << nodeB << "," << voltage << ")";
-    
     if (!m_isSetup) {
-        qDebug() << "DEBUG: Not setup, skipping voltage source";
         return;
     }
     
@@ -209,7 +203,6 @@ void MatrixSolver::addVoltageSource(int nodeA, int nodeB, double voltage)
     if (nodeB == -1) {
         if (nodeA >= 0 && nodeA < m_dimension) {
             setNodeVoltage(nodeA, voltage);
-            qDebug() << "DEBUG: Set voltage source from node" << nodeA << "to ground";
         }
     }
     // Handle voltage source between two nodes
@@ -221,14 +214,11 @@ void MatrixSolver::addVoltageSource(int nodeA, int nodeB, double voltage)
         // This is a simplification that works when the circuit has a clear ground
         setNodeVoltage(nodeA, voltage);
         setNodeVoltage(nodeB, 0);
-        qDebug() << "DEBUG: Set voltage source between nodes" << nodeA << "and" << nodeB;
     }
 }
 
 void MatrixSolver::setNodeVoltage(int node, double voltage)
 {
-    qDebug() << "DEBUG: MatrixSolver::setNodeVoltage(" << node << "," << voltage << ")";
-    
     if (!m_isSetup || node < 0 || node >= m_dimension) {
         qWarning() << "Invalid node in setNodeVoltage:" << node;
         return;
@@ -241,73 +231,46 @@ void MatrixSolver::setNodeVoltage(int node, double voltage)
     
     // Set right-hand side to the known voltage
     m_rightHandSide(node) = voltage;
-    qDebug() << "DEBUG: Set node" << node << "voltage constraint (Eigen)";
 #else
     for (int i = 0; i < m_dimension; ++i) {
         m_conductanceMatrix[node][i] = 0.0;
     }
     m_conductanceMatrix[node][node] = 1.0;
     m_rightHandSide[node] = voltage;
-    qDebug() << "DEBUG: Set node" << node << "voltage constraint (QVector)";
 #endif
 }
 
 bool MatrixSolver::solve()
 {
-    qDebug() << "DEBUG: MatrixSolver::solve() starting";
+    TRACE_SCOPE("MatrixSolver::solve");
     
     if (!m_isSetup || m_dimension == 0) {
         qWarning() << "Matrix not set up for solving.";
         return false;
     }
     
-    qDebug() << "DEBUG: Matrix dimension:" << m_dimension;
+    m_lastNonZeros = countNonZeros();
+    TRACE_COUNTER("MatrixSolver.nonZeros", m_lastNonZeros);
+    m_lastSubstitutionNs = 0;
+    QElapsedTimer timer;
+    timer.start();
     
-    // Print matrix for debugging (only for small matrices)
-    if (m_dimension <= 5) {
-        qDebug() << "DEBUG: Conductance Matrix:";
-#ifdef HAVE_EIGEN3
-        for (int i = 0; i < m_dimension; i++) {
-            QString row;
-            for (int j = 0; j < m_dimension; j++) {
-                row += QString("%1 ").arg(m_conductanceMatrix(i, j), 8, 'f', 3);
-            }
-            qDebug() << "  " << row;
-        }
-        qDebug() << "DEBUG: Right Hand Side:";
-        for (int i = 0; i < m_dimension; i++) {
-            qDebug() << "  " << m_rightHandSide(i);
-        }
-#else
-        for (int i = 0; i < m_dimension; i++) {
-            QString row;
-            for (int j = 0; j < m_dimension; j++) {
-                row += QString("%1 ").arg(m_conductanceMatrix[i][j], 8, 'f', 3);
-            }
-            qDebug() << "  " << row;
-        }
-        qDebug() << "DEBUG: Right Hand Side:";
-        for (int i = 0; i < m_dimension; i++) {
-            qDebug() << "  " << m_rightHandSide[i];
-        }
-#endif
+    if (m_referenceMode) {
+        bool solved = solveReference();
+        m_lastFactorizationNs = timer.nsecsElapsed();
+        return solved;
     }
     
 #ifdef HAVE_EIGEN3
-    qDebug() << "DEBUG: Using Eigen solver";
     // Use Eigen's built-in solvers
     try {
-        qDebug() << "DEBUG: Starting Eigen QR decomposition";
-        m_solution = m_conductanceMatrix.colPivHouseholderQr().solve(m_rightHandSide);
-        qDebug() << "DEBUG: Eigen solve completed successfully";
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(m_conductanceMatrix);
+        m_lastFactorizationNs = timer.nsecsElapsed();
+        m_lastFactorNonZeros = (qr.matrixQR().array() != 0.0).count();
         
-        // Print solution for debugging
-        if (m_dimension <= 5) {
-            qDebug() << "DEBUG: Solution:";
-            for (int i = 0; i < m_dimension; i++) {
-                qDebug() << "  Node" << i << "=" << m_solution(i) << "V";
-            }
-        }
+        timer.start();
+        m_solution = qr.solve(m_rightHandSide);
+        m_lastSubstitutionNs = timer.nsecsElapsed();
         
         return true;
     } catch (const std::exception& e) {
@@ -315,27 +278,143 @@ bool MatrixSolver::solve()
         return false;
     }
 #else
-    qDebug() << "DEBUG: Using fallback Gaussian elimination";
     // Use our own Gaussian elimination
     bool gaussResult = gaussianElimination();
-    qDebug() << "DEBUG: Gaussian elimination result:" << gaussResult;
+    m_lastFactorizationNs = timer.nsecsElapsed();
     
     if (!gaussResult) {
         return false;
     }
     
+    timer.start();
     bool backSubResult = backSubstitution();
-    qDebug() << "DEBUG: Back substitution result:" << backSubResult;
+    m_lastSubstitutionNs = timer.nsecsElapsed();
     
-    // Print solution for debugging
-    if (backSubResult && m_dimension <= 5) {
-        qDebug() << "DEBUG: Solution:";
-        for (int i = 0; i < m_dimension; i++) {
-            qDebug() << "  Node" << i << "=" << m_solution[i] << "V";
+    return backSubResult;
+#endif
+}
+
+bool MatrixSolver::solveReference()
+{
+    TRACE_SCOPE("MatrixSolver::solveReference");
+    
+    const int n = m_dimension;
+    
+    // Work on an extended-precision copy so the stored system is untouched
+    QVector<QVector<long double>> a(n, QVector<long double>(n));
+    QVector<long double> b(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+#ifdef HAVE_EIGEN3
+            a[i][j] = m_conductanceMatrix(i, j);
+#else
+            a[i][j] = m_conductanceMatrix[i][j];
+#endif
         }
+#ifdef HAVE_EIGEN3
+        b[i] = m_rightHandSide(i);
+#else
+        b[i] = m_rightHandSide[i];
+#endif
     }
     
-    return backSubResult;
+    // Multipliers below the diagonal plus the upper triangle
+    qint64 factorNonZeros = 0;
+    
+    // Column permutation from full pivoting: column k holds unknown columns[k]
+    QVector<int> columns(n);
+    for (int k = 0; k < n; ++k) {
+        columns[k] = k;
+    }
+    
+    for (int k = 0; k < n; ++k) {
+        // Largest remaining element anywhere in the trailing submatrix
+        int pivotRow = k;
+        int pivotColumn = k;
+        long double maxValue = 0.0L;
+        for (int i = k; i < n; ++i) {
+            for (int j = k; j < n; ++j) {
+                long double value = std::fabs(a[i][j]);
+                if (value > maxValue) {
+                    maxValue = value;
+                    pivotRow = i;
+                    pivotColumn = j;
+                }
+            }
+        }
+        
+        if (maxValue < m_epsilon) {
+            qWarning() << "Singular matrix in reference solver at step" << k;
+            return false;
+        }
+        
+        if (pivotRow != k) {
+            a[k].swap(a[pivotRow]);
+            std::swap(b[k], b[pivotRow]);
+        }
+        if (pivotColumn != k) {
+            for (int i = 0; i < n; ++i) {
+                std::swap(a[i][k], a[i][pivotColumn]);
+            }
+            std::swap(columns[k], columns[pivotColumn]);
+        }
+        
+        for (int i = k + 1; i < n; ++i) {
+            long double factor = a[i][k] / a[k][k];
+            if (factor == 0.0L) {
+                continue;
+            }
+            factorNonZeros++;
+            for (int j = k; j < n; ++j) {
+                a[i][j] -= factor * a[k][j];
+            }
+            b[i] -= factor * b[k];
+        }
+    }
+    
+    for (int i = 0; i < n; ++i) {
+        for (int j = i; j < n; ++j) {
+            if (a[i][j] != 0.0L) {
+                factorNonZeros++;
+            }
+        }
+    }
+    m_lastFactorNonZeros = factorNonZeros;
+    
+    QVector<long double> x(n);
+    for (int i = n - 1; i >= 0; --i) {
+        long double sum = b[i];
+        for (int j = i + 1; j < n; ++j) {
+            sum -= a[i][j] * x[j];
+        }
+        x[i] = sum / a[i][i];
+    }
+    
+    for (int k = 0; k < n; ++k) {
+#ifdef HAVE_EIGEN3
+        m_solution(columns[k]) = static_cast<double>(x[k]);
+#else
+        m_solution[columns[k]] = static_cast<double>(x[k]);
+#endif
+    }
+    return true;
+}
+
+qint64 MatrixSolver::countNonZeros() const
+{
+#ifdef HAVE_EIGEN3
+    return (m_conductanceMatrix.array() != 0.0).count();
+#else
+    qint64 count = 0;
+    for (int i = 0; i < m_dimension; ++i) {
+        const double *row = m_conductanceMatrix[i].constData();
+        for (int j = 0; j < m_dimension; ++j) {
+            if (row[j] != 0.0) {
+                count++;
+            }
+        }
+    }
+    return count;
 #endif
 }
 
@@ -352,19 +431,49 @@ double MatrixSolver::getNodeVoltage(int node) const
     double voltage = m_solution[node];
 #endif
     
-    qDebug() << "DEBUG: getNodeVoltage(" << node << ") =" << voltage;
     return voltage;
 }
 
-double MatrixSolver::getBranchCurrent(int nodeA, int nodeB) const
+QVector<double> MatrixSolver::getSolution() const
+{
+    QVector<double> solution;
+    if (!m_isSetup) {
+        return solution;
+    }
+    
+    solution.resize(m_dimension);
+    for (int i = 0; i < m_dimension; ++i) {
+#ifdef HAVE_EIGEN3
+        solution[i] = m_solution(i);
+#else
+        solution[i] = m_solution[i];
+#endif
+    }
+    return solution;
+}
+
+bool MatrixSolver::setSolution(const QVector<double> &solution)
 {
-    qDebug() << "DEBUG: MatrixSolver::getBranchCurrent(" << nodeA << "," << nodeB << ")";
+    if (!m_isSetup || solution.size() != m_dimension) {
+        return false;
+    }
     
+    for (int i = 0; i < m_dimension; ++i) {
+#ifdef HAVE_EIGEN3
+        m_solution(i) = solution[i];
+#else
+        m_solution[i] = solution[i];
+#endif
+    }
+    return true;
+}
+
+double MatrixSolver::getBranchCurrent(int nodeA, int nodeB) const
+{
     // Check if we have a stored current source value first
     QPair<int, int> branchKey(nodeA, nodeB);
     if (m_branchCurrents.contains(branchKey)) {
         double current = m_branchCurrents[branchKey];
-        qDebug() << "DEBUG: Found stored current:" << current;
         return current;
     }
     
@@ -381,7 +490,6 @@ double MatrixSolver::getBranchCurrent(int nodeA, int nodeB) const
         double voltageB = m_solution[nodeB];
 #endif
         double current = conductance * (voltageA - voltageB);
-        qDebug() << "DEBUG: Calculated current from voltages:" << current;
         return current;
     }
     
@@ -405,20 +513,15 @@ double MatrixSolver::getBranchCurrent(int nodeA, int nodeB) const
             }
         }
         double current = conductance * voltageA;
-        qDebug() << "DEBUG: Calculated current to ground:" << current;
         return current;
     }
     
-    qDebug() << "DEBUG: No current found, returning 0";
     return 0.0;
 }
 
 bool MatrixSolver::isValid() const
 {
-    qDebug() << "DEBUG: MatrixSolver::isValid() checking";
-    
     if (!m_isSetup || m_dimension == 0) {
-        qDebug() << "DEBUG: Not valid - not setup or zero dimension";
         return false;
     }
     
@@ -427,9 +530,7 @@ bool MatrixSolver::isValid() const
     // For smaller matrices, compute the determinant
     if (m_dimension <= 4) {
         double det = m_conductanceMatrix.determinant();
-        qDebug() << "DEBUG: Matrix determinant:" << det;
         bool valid = std::abs(det) > m_epsilon;
-        qDebug() << "DEBUG: Determinant check result:" << valid;
         return valid;
     }
     
@@ -437,7 +538,6 @@ bool MatrixSolver::isValid() const
     // This is a simpler check that works with most Eigen versions
     for (int i = 0; i < m_dimension; ++i) {
         if (std::abs(m_conductanceMatrix(i, i)) < m_epsilon) {
-            qDebug() << "DEBUG: Small diagonal element at" << i << ":" << m_conductanceMatrix(i, i);
             return false;
         }
     }
@@ -445,30 +545,24 @@ bool MatrixSolver::isValid() const
     // Additional check: see if matrix has reasonable values
     double maxElement = m_conductanceMatrix.cwiseAbs().maxCoeff();
     double minElement = m_conductanceMatrix.cwiseAbs().minCoeff();
-    qDebug() << "DEBUG: Matrix range - max:" << maxElement << "min:" << minElement;
     
     // Check for reasonable condition (max/min ratio)
     if (maxElement > 0 && minElement > 0) {
         double conditionEstimate = maxElement / minElement;
-        qDebug() << "DEBUG: Condition estimate:" << conditionEstimate;
         return conditionEstimate < 1e12; // Reasonable condition number
     }
     
     bool valid = maxElement > m_epsilon;
-    qDebug() << "DEBUG: Max element check result:" << valid;
     return valid;
 #else
-    qDebug() << "DEBUG: Using simple diagonal check for QVector implementation";
     // Simple check for obvious issues
     bool hasDiagonalElements = true;
     for (int i = 0; i < m_dimension; ++i) {
         if (std::abs(m_conductanceMatrix[i][i]) < m_epsilon) {
-            qDebug() << "DEBUG: Small diagonal element at" << i << ":" << m_conductanceMatrix[i][i];
             hasDiagonalElements = false;
             break;
         }
     }
-    qDebug() << "DEBUG: Diagonal elements check result:" << hasDiagonalElements;
     return hasDiagonalElements;
 #endif
 }
@@ -478,14 +572,14 @@ bool MatrixSolver::isValid() const
 
 bool MatrixSolver::gaussianElimination()
 {
-    qDebug() << "DEBUG: MatrixSolver::gaussianElimination() starting";
+    TRACE_SCOPE("MatrixSolver::gaussianElimination");
+    
+    // Multipliers below the diagonal plus the upper triangle
+    m_lastFactorNonZeros = 0;
     
     for (int i = 0; i < m_dimension; ++i) {
-        qDebug() << "DEBUG: Processing row" << i;
-        
         // Find pivot element (largest in column)
         int pivotRow = findPivotRow(i);
-        qDebug() << "DEBUG: Pivot row for column" << i << "is" << pivotRow;
         
         // If no suitable pivot found, matrix is singular
         if (std::abs(m_conductanceMatrix[pivotRow][i]) < m_epsilon) {
@@ -495,13 +589,11 @@ bool MatrixSolver::gaussianElimination()
         
         // Swap rows if needed
         if (pivotRow != i) {
-            qDebug() << "DEBUG: Swapping rows" << i << "and" << pivotRow;
             swapRows(i, pivotRow);
         }
         
         // Normalize pivot row
         double pivot = m_conductanceMatrix[i][i];
-        qDebug() << "DEBUG: Pivot element:" << pivot;
         
         for (int j = i; j < m_dimension; ++j) {
             m_conductanceMatrix[i][j] /= pivot;
@@ -512,7 +604,7 @@ bool MatrixSolver::gaussianElimination()
         for (int k = i + 1; k < m_dimension; ++k) {
             double factor = m_conductanceMatrix[k][i];
             if (std::abs(factor) > m_epsilon) {
-                qDebug() << "DEBUG: Eliminating row" << k << "with factor" << factor;
+                m_lastFactorNonZeros++;
                 for (int j = i; j < m_dimension; ++j) {
                     m_conductanceMatrix[k][j] -= factor * m_conductanceMatrix[i][j];
                 }
@@ -521,26 +613,28 @@ bool MatrixSolver::gaussianElimination()
         }
     }
     
-    qDebug() << "DEBUG: Gaussian elimination completed successfully";
+    for (int i = 0; i < m_dimension; ++i) {
+        for (int j = i; j < m_dimension; ++j) {
+            if (m_conductanceMatrix[i][j] != 0.0) {
+                m_lastFactorNonZeros++;
+            }
+        }
+    }
+    
     return true;
 }
 
 bool MatrixSolver::backSubstitution()
 {
-    qDebug() << "DEBUG: MatrixSolver::backSubstitution() starting";
+    TRACE_SCOPE("MatrixSolver::backSubstitution");
     
     for (int i = m_dimension - 1; i >= 0; --i) {
-        qDebug() << "DEBUG: Back substitution for variable" << i;
-        
         m_solution[i] = m_rightHandSide[i];
         for (int j = i + 1; j < m_dimension; ++j) {
             m_solution[i] -= m_conductanceMatrix[i][j] * m_solution[j];
         }
-        
-        qDebug() << "DEBUG: Solution[" << i << "] =" << m_solution[i];
     }
     
-    qDebug() << "DEBUG: Back substitution completed successfully";
     return true;
 }
 
@@ -548,7 +642,6 @@ void MatrixSolver::swapRows(int row1, int row2)
 {
     if (row1 == row2) return;
     
-    qDebug() << "DEBUG: Swapping rows" << row1 << "and" << row2;
     m_conductanceMatrix[row1].swap(m_conductanceMatrix[row2]);
     std::swap(m_rightHandSide[row1], m_rightHandSide[row2]);
 }
@@ -566,7 +659,6 @@ int MatrixSolver::findPivotRow(int startRow)
         }
     }
     
-    qDebug() << "DEBUG: Found pivot row" << pivotRow << "with value" << maxValue;
     return pivotRow;
 }
 #endif // !HAVE_EIGEN3
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "simulation/MixedSignalPartition.h"
+#include "simulation/Circuit.h"
+#include "simulation/Node.h"
+#include <QDebug>
+
+MixedSignalPartition::MixedSignalPartition()
+    : m_enabled(true)
+    , m_propagating(false)
+    , m_eventCount(0)
+{
+}
+
+void MixedSignalPartition::clear()
+{
+    m_nets.clear();
+    m_netOfNode.clear();
+    m_drivenNets.clear();
+    m_roles.clear();
+    m_outputComponents.clear();
+    m_digitalOnly.clear();
+    m_analogToDigital.clear();
+    m_digitalToAnalog.clear();
+    m_queue.clear();
+    m_queued.clear();
+}
+
+void MixedSignalPartition::build(Circuit *circuit)
+{
+    clear();
+    if (!circuit) {
+        return;
+    }
+
+    Node *ground = circuit->getGroundNode();
+
+    for (Node *node : circuit->getNodes()) {
+        if (node == ground || node->isGroundNode()) {
+            continue;
+        }
+
+        const QVector<QPair<Component*, int>> &connections = node->getConnections();
+        QVector<Terminal> outputs;
+        QVector<Terminal> inputs;
+        bool analog = false;
+
+        for (const QPair<Component*, int> &connection : connections) {
+            ElectricalComponent *component = qobject_cast<ElectricalComponent*>(connection.first);
+            if (!component) {
+                analog = true;
+                continue;
+            }
+
+            QVector<ElectricalComponent::TerminalRole> &roles = m_roles[component];
+            if (roles.isEmpty()) {
+                roles.resize(component->getTerminalCount());
+                for (int terminal = 0; terminal < roles.size(); ++terminal) {
+                    roles[terminal] = component->getTerminalRole(terminal);
+                    if (roles[terminal] == ElectricalComponent::DigitalOutput) {
+                        m_outputComponents.insert(component);
+                    }
+                }
+            }
+
+            Terminal terminal = { component, connection.second };
+            switch (roles.value(connection.second, ElectricalComponent::AnalogTerminal)) {
+                case ElectricalComponent::DigitalOutput:
+                    outputs.append(terminal);
+                    break;
+                case ElectricalComponent::DigitalInput:
+                    inputs.append(terminal);
+                    break;
+                case ElectricalComponent::PassiveTerminal:
+                    break;
+                default:
+                    analog = true;
+                    break;
+            }
+        }
+
+        if (m_enabled && !analog && outputs.size() == 1) {
+            DigitalNet net;
+            net.node = node;
+            net.driver = outputs.first();
+            net.loads = inputs;
+            net.connectionCount = connections.size();
+            net.level = -1;
+
+            int index = m_nets.size();
+            m_nets.append(net);
+            m_netOfNode.insert(node, index);
+            m_drivenNets[net.driver.component].append(index);
+            continue;
+        }
+
+        // Digital terminals facing an analog (or contended) net
+        for (const Terminal &terminal : outputs) {
+            m_digitalToAnalog.append({ terminal, node, -1 });
+        }
+        for (const Terminal &terminal : inputs) {
+            m_analogToDigital.append({ terminal, node, -1 });
+        }
+    }
+
+    for (auto it = m_roles.constBegin(); it != m_roles.constEnd(); ++it) {
+        ElectricalComponent *component = it.key();
+        bool connected = false;
+        bool digitalOnly = true;
+        for (int terminal = 0; terminal < component->getTerminalCount(); ++terminal) {
+            Node *node = component->getNode(terminal);
+            if (node) {
+                connected = true;
+                digitalOnly = digitalOnly && isDigital(node);
+            }
+        }
+        if (connected && digitalOnly) {
+            m_digitalOnly.insert(component);
+        }
+    }
+
+    // Evaluate every net once on the next propagation
+    m_queued.fill(false, m_nets.size());
+    for (int i = 0; i < m_nets.size(); ++i) {
+        enqueue(i);
+    }
+}
+
+bool MixedSignalPartition::rolesChanged(ElectricalComponent *component) const
+{
+    auto it = m_roles.constFind(component);
+    if (it == m_roles.constEnd()) {
+        return false;   // Not connected when built; topology edits handle it
+    }
+
+    const QVector<ElectricalComponent::TerminalRole> &roles = it.value();
+    for (int terminal = 0; terminal < roles.size(); ++terminal) {
+        if (component->getTerminalRole(terminal) != roles[terminal]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MixedSignalPartition::isStale() const
+{
+    for (const DigitalNet &net : m_nets) {
+        if (net.node->getConnections().size() != net.connectionCount) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MixedSignalPartition::enqueue(int net)
+{
+    if (!m_queued[net]) {
+        m_queued[net] = true;
+        m_queue.append(net);
+    }
+}
+
+int MixedSignalPartition::driverChanged(ElectricalComponent *component)
+{
+    auto it = m_drivenNets.constFind(component);
+    if (it == m_drivenNets.constEnd()) {
+        return 0;
+    }
+
+    for (int net : it.value()) {
+        enqueue(net);
+    }
+    return propagate();
+}
+
+int MixedSignalPartition::propagate()
+{
+    // Inputs reacting to an event queue further events, which the running
+    // loop picks up instead of recursing
+    if (m_propagating) {
+        return 0;
+    }
+    m_propagating = true;
+
+    int changed = 0;
+    int head = 0;
+    for (; head < m_queue.size(); ++head) {
+        if (head >= MaxEventsPerPropagation) {
+            qWarning() << "Digital nets did not settle after" << MaxEventsPerPropagation
+                       << "events; dropping the rest (oscillating logic loop?)";
+            for (int i = head; i < m_queue.size(); ++i) {
+                m_queued[m_queue[i]] = false;
+            }
+            break;
+        }
+
+        int index = m_queue[head];
+        m_queued[index] = false;
+        m_eventCount++;
+
+        DigitalNet &net = m_nets[index];
+        bool level = net.driver.component->getDigitalOutput(net.driver.terminal);
+        if (net.level == int(level)) {
+            continue;
+        }
+        net.level = level;
+        changed++;
+
+        double voltage = level ? ElectricalComponent::LogicHigh : 0.0;
+        net.node->setVoltage(voltage);
+        for (const Terminal &load : net.loads) {
+            if (load.component->getTerminalCount() == 1) {
+                load.component->updateState(voltage, 0.0);
+            }
+            load.component->digitalInputChanged(load.terminal, level);
+        }
+    }
+
+    m_queue.clear();
+    m_propagating = false;
+    return changed;
+}
+
+int MixedSignalPartition::resync()
+{
+    for (int i = 0; i < m_nets.size(); ++i) {
+        m_nets[i].level = -1;
+        enqueue(i);
+    }
+    for (Boundary &boundary : m_analogToDigital) {
+        boundary.level = -1;
+    }
+    return propagate();
+}
+
+int MixedSignalPartition::sampleBoundaries(const std::function<double(Node*)> &voltageOf)
+{
+    int edges = 0;
+    for (Boundary &boundary : m_analogToDigital) {
+        bool level = voltageOf(boundary.node) > ElectricalComponent::LogicThreshold;
+        if (boundary.level == int(level)) {
+            continue;
+        }
+        boundary.level = level;
+        edges++;
+        boundary.terminal.component->digitalInputChanged(boundary.terminal.terminal, level);
+    }
+
+    propagate();
+    return edges;
+}
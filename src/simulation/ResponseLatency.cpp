@@ -0,0 +1,109 @@
+#include "simulation/ResponseLatency.h"
+#include <QMutexLocker>
+#include <chrono>
+
+namespace {
+const char *const StageNames[ResponseLatency::StageCount] = {
+    "notify", "throttle", "solve", "ledResponse", "total"
+};
+}
+
+ResponseLatency::ResponseLatency()
+    : m_pendingWrittenNs(-1)
+    , m_pendingNotifiedNs(-1)
+    , m_inFlight(false)
+    , m_responded(false)
+    , m_inFlightWrittenNs(0)
+    , m_updateStartNs(0)
+{
+}
+
+qint64 ResponseLatency::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* ResponseLatency::stageName(Stage stage)
+{
+    return StageNames[stage];
+}
+
+void ResponseLatency::stimulus(qint64 writtenNs, qint64 notifiedNs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_stages[Notify].record(notifiedNs - writtenNs);
+    if (m_pendingWrittenNs < 0 || writtenNs < m_pendingWrittenNs) {
+        m_pendingWrittenNs = writtenNs;
+        m_pendingNotifiedNs = notifiedNs;
+    }
+}
+
+void ResponseLatency::beginUpdate(qint64 ns)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_inFlight = m_pendingWrittenNs >= 0;
+    m_responded = false;
+    if (!m_inFlight) {
+        return;
+    }
+
+    m_stages[Throttle].record(ns - m_pendingNotifiedNs);
+    m_inFlightWrittenNs = m_pendingWrittenNs;
+    m_updateStartNs = ns;
+    m_pendingWrittenNs = -1;
+    m_pendingNotifiedNs = -1;
+}
+
+void ResponseLatency::response(qint64 ns)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_inFlight && !m_responded) {
+        m_stages[LedResponse].record(ns - m_inFlightWrittenNs);
+        m_responded = true;
+    }
+}
+
+void ResponseLatency::endUpdate(qint64 ns)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_inFlight) {
+        m_stages[Solve].record(ns - m_updateStartNs);
+        m_stages[Total].record(ns - m_inFlightWrittenNs);
+        m_inFlight = false;
+    }
+}
+
+LatencyHistogram ResponseLatency::getHistogram(Stage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stages[stage];
+}
+
+void ResponseLatency::reset()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (LatencyHistogram &histogram : m_stages) {
+        histogram.reset();
+    }
+    m_pendingWrittenNs = -1;
+    m_pendingNotifiedNs = -1;
+    m_inFlight = false;
+    m_responded = false;
+}
+
+QJsonObject ResponseLatency::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject json;
+    for (int i = 0; i < StageCount; ++i) {
+        json[StageNames[i]] = m_stages[i].toJson();
+    }
+    return json;
+}
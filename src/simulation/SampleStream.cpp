@@ -0,0 +1,452 @@
+#include "simulation/SampleStream.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const qint64 DefaultWindowSize = 16 * 1024 * 1024;
+const qint64 MinimumWindowSize = 64 * 1024;
+const qint64 WindowAlignment = 64 * 1024;   // Multiple of every page size
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+double powerOfTen(int exponent)
+{
+    static const double exact[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    return exponent <= 22 ? exact[exponent] : std::pow(10.0, exponent);
+}
+
+// Locale-independent decimal parser working on the mapped bytes in
+// place (strtod needs a terminated copy and follows LC_NUMERIC)
+bool parseNumber(const char *&p, const char *end, double &value)
+{
+    const char *s = p;
+    bool negative = false;
+    if (s < end && (*s == '+' || *s == '-')) {
+        negative = *s == '-';
+        ++s;
+    }
+
+    const quint64 mantissaLimit = 100000000000000000ULL;
+    quint64 mantissa = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    for (; s < end && isDigit(*s); ++s) {
+        if (mantissa < mantissaLimit) {
+            mantissa = mantissa * 10 + (*s - '0');
+        } else {
+            ++exponent;
+        }
+        anyDigit = true;
+    }
+    if (s < end && *s == '.') {
+        for (++s; s < end && isDigit(*s); ++s) {
+            if (mantissa < mantissaLimit) {
+                mantissa = mantissa * 10 + (*s - '0');
+                --exponent;
+            }
+            anyDigit = true;
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char *e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '+' || *e == '-')) {
+            negativeExponent = *e == '-';
+            ++e;
+        }
+        if (e < end && isDigit(*e)) {
+            int written = 0;
+            for (; e < end && isDigit(*e); ++e) {
+                if (written < 10000) {
+                    written = written * 10 + (*e - '0');
+                }
+            }
+            exponent += negativeExponent ? -written : written;
+            s = e;
+        }
+    }
+
+    double magnitude = double(mantissa);
+    magnitude = exponent < 0 ? magnitude / powerOfTen(-exponent)
+                             : magnitude * powerOfTen(exponent);
+    value = negative ? -magnitude : magnitude;
+    p = s;
+    return true;
+}
+}
+
+SampleStream::SampleStream()
+    : m_format(Csv)
+    , m_isOpen(false)
+    , m_fileSize(0)
+    , m_windowSize(DefaultWindowSize)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowLength(0)
+    , m_first({0.0, 0.0})
+    , m_last({0.0, 0.0})
+    , m_current({0.0, 0.0})
+    , m_next({0.0, 0.0})
+    , m_hasNext(false)
+    , m_record(0)
+    , m_nextOffset(0)
+    , m_lineNumber(0)
+{
+}
+
+SampleStream::~SampleStream()
+{
+    close();
+}
+
+bool SampleStream::open(const QString &fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    bool binary = suffix == "bin" || suffix == "dat" || suffix == "raw";
+    return open(fileName, binary ? Binary : Csv);
+}
+
+bool SampleStream::open(const QString &fileName, Format format)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "SampleStream: cannot open" << fileName;
+        return false;
+    }
+
+    m_format = format;
+    m_fileSize = m_file.size();
+    m_isOpen = true;
+    m_checkpoints.clear();
+
+    bool valid;
+    if (m_format == Binary) {
+        if (m_fileSize % qint64(sizeof(Sample)) != 0) {
+            qWarning() << "SampleStream: ignoring a partial record at the end of" << fileName;
+        }
+        valid = recordCount() > 0 && readRecord(0, m_first) && readRecord(recordCount() - 1, m_last);
+    } else {
+        valid = readLine(0, m_first) > 0 && findLastLine(m_last);
+        m_checkpoints.append({m_first.time, 0});
+    }
+
+    if (!valid) {
+        qWarning() << "SampleStream: no samples in" << fileName;
+        close();
+        return false;
+    }
+
+    if (m_last.time < m_first.time) {
+        qWarning() << "SampleStream: sample times decrease in" << fileName;
+    }
+
+    // Cursor at the first sample
+    if (m_format == Binary) {
+        seekRecord(m_first.time);
+    } else {
+        seekLine(m_first.time);
+    }
+
+    qDebug() << "Opened sample stream" << fileName << "covering" << m_first.time
+             << "to" << m_last.time << "s";
+    return true;
+}
+
+void SampleStream::close()
+{
+    unmapWindow();
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_isOpen = false;
+    m_fileSize = 0;
+    m_hasNext = false;
+    m_checkpoints.clear();
+}
+
+void SampleStream::setWindowSize(qint64 bytes)
+{
+    // Rounded to whole alignment units; the next access maps the new size
+    m_windowSize = qMax(MinimumWindowSize, bytes - bytes % WindowAlignment);
+    unmapWindow();
+}
+
+double SampleStream::valueAt(double time)
+{
+    if (!m_isOpen) {
+        return 0.0;
+    }
+
+    if (time <= m_first.time) {
+        return m_first.value;
+    }
+    if (time >= m_last.time) {
+        return m_last.value;
+    }
+
+    // Playback normally moves forward a few samples per call; anything
+    // else is a seek
+    if (time < m_current.time) {
+        if (m_format == Binary) {
+            seekRecord(time);
+        } else {
+            seekLine(time);
+        }
+    }
+
+    int steps = 0;
+    while (m_hasNext && m_next.time <= time) {
+        if (m_format == Binary && ++steps > 64) {
+            seekRecord(time);
+            break;
+        }
+        if (!(m_format == Binary ? advanceRecord() : advanceLine())) {
+            break;
+        }
+    }
+
+    if (!m_hasNext || m_next.time <= m_current.time) {
+        return m_current.value;
+    }
+
+    double fraction = (time - m_current.time) / (m_next.time - m_current.time);
+    return m_current.value + fraction * (m_next.value - m_current.value);
+}
+
+const char *SampleStream::map(qint64 offset, qint64 length, qint64 *available)
+{
+    if (offset < 0 || offset >= m_fileSize) {
+        *available = 0;
+        return nullptr;
+    }
+
+    qint64 wanted = qMin(length, m_fileSize - offset);
+    bool inWindow = m_window && offset >= m_windowOffset
+                    && offset + wanted <= m_windowOffset + m_windowLength;
+
+    if (!inWindow) {
+        unmapWindow();
+
+        qint64 start = offset - offset % WindowAlignment;
+        qint64 windowLength = qMax(m_windowSize, offset - start + wanted);
+        windowLength = qMin(windowLength, m_fileSize - start);
+
+        m_window = m_file.map(start, windowLength);
+        if (!m_window) {
+            qWarning() << "SampleStream: cannot map" << windowLength << "bytes at" << start
+                       << "of" << m_file.fileName();
+            *available = 0;
+            return nullptr;
+        }
+        m_windowOffset = start;
+        m_windowLength = windowLength;
+    }
+
+    *available = wanted;
+    return reinterpret_cast<const char*>(m_window) + (offset - m_windowOffset);
+}
+
+void SampleStream::unmapWindow()
+{
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+    m_windowOffset = 0;
+    m_windowLength = 0;
+}
+
+bool SampleStream::readRecord(qint64 index, Sample &sample)
+{
+    qint64 available = 0;
+    const char *data = map(index * qint64(sizeof(Sample)), sizeof(Sample), &available);
+    if (!data || available < qint64(sizeof(Sample))) {
+        return false;
+    }
+
+    quint64 bits[2];
+    std::memcpy(bits, data, sizeof(bits));
+    bits[0] = qFromLittleEndian(bits[0]);
+    bits[1] = qFromLittleEndian(bits[1]);
+    std::memcpy(&sample.time, &bits[0], sizeof(double));
+    std::memcpy(&sample.value, &bits[1], sizeof(double));
+    return true;
+}
+
+void SampleStream::seekRecord(double time)
+{
+    // Last record at or before time
+    qint64 low = 0;
+    qint64 high = recordCount() - 1;
+    Sample probe;
+    while (low < high) {
+        qint64 middle = low + (high - low + 1) / 2;
+        if (readRecord(middle, probe) && probe.time <= time) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    m_record = low;
+    readRecord(m_record, m_current);
+    m_hasNext = readRecord(m_record + 1, m_next);
+}
+
+bool SampleStream::advanceRecord()
+{
+    Sample next;
+    if (!readRecord(m_record + 2, next)) {
+        m_hasNext = false;
+        return false;
+    }
+
+    ++m_record;
+    m_current = m_next;
+    m_next = next;
+    return true;
+}
+
+qint64 SampleStream::readLine(qint64 offset, Sample &sample)
+{
+    while (offset < m_fileSize) {
+        qint64 available = 0;
+        const char *line = map(offset, MaxLineLength, &available);
+        if (!line) {
+            return -1;
+        }
+
+        const char *newline = static_cast<const char*>(std::memchr(line, '\n', available));
+        if (!newline && offset + available < m_fileSize) {
+            qWarning() << "SampleStream: line at" << offset << "of" << m_file.fileName()
+                       << "is longer than" << MaxLineLength << "bytes";
+            return -1;
+        }
+        const char *end = newline ? newline : line + available;
+        qint64 next = offset + (end - line) + 1;
+
+        // "time<sep>value"; blank lines, comments and headers don't parse
+        const char *p = line;
+        while (p < end && isBlank(*p)) ++p;
+        if (p < end && *p != '#' && parseNumber(p, end, sample.time)) {
+            while (p < end && isBlank(*p)) ++p;
+            if (p < end && (*p == ',' || *p == ';')) ++p;
+            while (p < end && isBlank(*p)) ++p;
+            if (parseNumber(p, end, sample.value)) {
+                return qMin(next, m_fileSize);
+            }
+        }
+
+        offset = next;
+    }
+
+    return -1;
+}
+
+void SampleStream::seekLine(double time)
+{
+    // Nearest checkpoint at or before time; the first is at the start
+    int low = 0;
+    int high = m_checkpoints.size() - 1;
+    while (low < high) {
+        int middle = low + (high - low + 1) / 2;
+        if (m_checkpoints[middle].time <= time) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    qint64 offset = readLine(m_checkpoints[low].offset, m_current);
+    m_lineNumber = qint64(low) * CheckpointInterval;
+    m_hasNext = offset > 0 && (m_nextOffset = readLine(offset, m_next)) > 0;
+    if (m_hasNext) {
+        ++m_lineNumber;
+    }
+
+    while (m_hasNext && m_next.time <= time) {
+        if (!advanceLine()) {
+            break;
+        }
+    }
+}
+
+bool SampleStream::advanceLine()
+{
+    Sample next;
+    qint64 lineOffset = m_nextOffset;
+    qint64 offset = readLine(lineOffset, next);
+    if (offset < 0) {
+        m_hasNext = false;
+        return false;
+    }
+
+    m_current = m_next;
+    m_next = next;
+    m_nextOffset = offset;
+    ++m_lineNumber;
+
+    // Checkpoints are only ever appended, the first time a line is reached
+    if (m_lineNumber % CheckpointInterval == 0
+        && m_lineNumber / CheckpointInterval == m_checkpoints.size()) {
+        m_checkpoints.append({next.time, lineOffset});
+    }
+    return true;
+}
+
+bool SampleStream::findLastLine(Sample &sample)
+{
+    // Walk back one line at a time from the end until one holds a sample
+    qint64 end = m_fileSize;
+    while (end > 0) {
+        qint64 start = qMax<qint64>(0, end - MaxLineLength - 1);
+        qint64 available = 0;
+        const char *data = map(start, end - start, &available);
+        if (!data) {
+            return false;
+        }
+
+        // Skip the newline ending this line, then find the one before it
+        qint64 position = end - start - 1;
+        if (position >= 0 && data[position] == '\n') {
+            --position;
+        }
+        while (position >= 0 && data[position] != '\n') {
+            --position;
+        }
+        if (position < 0 && start > 0) {
+            qWarning() << "SampleStream: last line of" << m_file.fileName()
+                       << "is longer than" << MaxLineLength << "bytes";
+            return false;
+        }
+
+        qint64 lineStart = start + position + 1;
+        if (readLine(lineStart, sample) > 0) {
+            return true;
+        }
+        end = lineStart;
+    }
+
+    return false;
+}
@@ -0,0 +1,154 @@
+#include "simulation/SimulationMetrics.h"
+
+namespace {
+const char *const PhaseNames[SimulationMetricsSnapshot::PhaseCount] = {
+    "stamping", "factorization", "substitution", "stateUpdate", "convergenceCheck"
+};
+}
+
+double SimulationMetricsSnapshot::iterationsPerStep() const
+{
+    return steps > 0 ? double(iterations) / double(steps) : 0.0;
+}
+
+double SimulationMetricsSnapshot::indexReuseRate() const
+{
+    quint64 total = fullRebuilds + incrementalEdits;
+    return total > 0 ? double(incrementalEdits) / double(total) : 0.0;
+}
+
+double SimulationMetricsSnapshot::solverStorageReuseRate() const
+{
+    return solverResizes > 0 ? 1.0 - double(solverReallocations) / double(solverResizes) : 0.0;
+}
+
+QJsonObject SimulationMetricsSnapshot::toJson() const
+{
+    QJsonObject phases;
+    for (int i = 0; i < PhaseCount; ++i) {
+        phases[PhaseNames[i]] = phaseNs[i];
+    }
+
+    QJsonObject json;
+    json["steps"] = double(steps);
+    json["iterations"] = double(iterations);
+    json["iterationsPerStep"] = iterationsPerStep();
+    json["convergenceFailures"] = double(convergenceFailures);
+    json["phaseNs"] = phases;
+    json["stepNs"] = stepNs;
+    json["lastIterations"] = lastIterations;
+    json["lastStepNs"] = lastStepNs;
+    json["fullRebuilds"] = double(fullRebuilds);
+    json["incrementalEdits"] = double(incrementalEdits);
+    json["indexReuseRate"] = indexReuseRate();
+    json["solverStorageReuseRate"] = solverStorageReuseRate();
+    json["dimension"] = dimension;
+    json["nonZeros"] = nonZeros;
+    json["factorNonZeros"] = factorNonZeros;
+    json["fillIn"] = fillIn();
+    return json;
+}
+
+SimulationMetrics::SimulationMetrics()
+    : m_sequence(0)
+{
+    reset();
+}
+
+void SimulationMetrics::reset()
+{
+    m_pending = SimulationMetricsSnapshot();
+    publish();
+}
+
+void SimulationMetrics::setMatrixStats(int dimension, qint64 nonZeros, qint64 factorNonZeros)
+{
+    m_pending.dimension = dimension;
+    m_pending.nonZeros = nonZeros;
+    m_pending.factorNonZeros = factorNonZeros;
+}
+
+void SimulationMetrics::setTopologyCounts(quint64 fullRebuilds, quint64 incrementalEdits)
+{
+    m_pending.fullRebuilds = fullRebuilds;
+    m_pending.incrementalEdits = incrementalEdits;
+}
+
+void SimulationMetrics::setSolverCounts(quint64 resizes, quint64 reallocations)
+{
+    m_pending.solverResizes = resizes;
+    m_pending.solverReallocations = reallocations;
+}
+
+void SimulationMetrics::publishStep(int iterations, bool converged, qint64 stepNs)
+{
+    m_pending.steps++;
+    m_pending.iterations += iterations;
+    if (!converged) {
+        m_pending.convergenceFailures++;
+    }
+    m_pending.stepNs += stepNs;
+    m_pending.lastIterations = iterations;
+    m_pending.lastStepNs = stepNs;
+    publish();
+}
+
+void SimulationMetrics::publish()
+{
+    // Odd sequence while the published values are inconsistent
+    unsigned sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    store(m_steps, m_pending.steps);
+    store(m_iterations, m_pending.iterations);
+    store(m_convergenceFailures, m_pending.convergenceFailures);
+    for (int i = 0; i < SimulationMetricsSnapshot::PhaseCount; ++i) {
+        store(m_phaseNs[i], m_pending.phaseNs[i]);
+    }
+    store(m_stepNs, m_pending.stepNs);
+    store(m_lastIterations, m_pending.lastIterations);
+    store(m_lastStepNs, m_pending.lastStepNs);
+    store(m_fullRebuilds, m_pending.fullRebuilds);
+    store(m_incrementalEdits, m_pending.incrementalEdits);
+    store(m_solverResizes, m_pending.solverResizes);
+    store(m_solverReallocations, m_pending.solverReallocations);
+    store(m_dimension, m_pending.dimension);
+    store(m_nonZeros, m_pending.nonZeros);
+    store(m_factorNonZeros, m_pending.factorNonZeros);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+SimulationMetricsSnapshot SimulationMetrics::snapshot() const
+{
+    SimulationMetricsSnapshot result;
+    unsigned before;
+    unsigned after;
+
+    do {
+        before = m_sequence.load(std::memory_order_acquire);
+
+        result.steps = load(m_steps);
+        result.iterations = load(m_iterations);
+        result.convergenceFailures = load(m_convergenceFailures);
+        for (int i = 0; i < SimulationMetricsSnapshot::PhaseCount; ++i) {
+            result.phaseNs[i] = load(m_phaseNs[i]);
+        }
+        result.stepNs = load(m_stepNs);
+        result.lastIterations = load(m_lastIterations);
+        result.lastStepNs = load(m_lastStepNs);
+        result.fullRebuilds = load(m_fullRebuilds);
+        result.incrementalEdits = load(m_incrementalEdits);
+        result.solverResizes = load(m_solverResizes);
+        result.solverReallocations = load(m_solverReallocations);
+        result.dimension = load(m_dimension);
+        result.nonZeros = load(m_nonZeros);
+        result.factorNonZeros = load(m_factorNonZeros);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_sequence.load(std::memory_order_relaxed);
+    } while ((before & 1u) || before != after);
+
+    return result;
+}
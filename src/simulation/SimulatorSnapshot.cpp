@@ -0,0 +1,38 @@
+#include "simulation/SimulatorSnapshot.h"
+#include <algorithm>
+
+SimulatorSnapshot::SimulatorSnapshot()
+    : m_valid(false)
+    , m_topologySignature(0)
+    , m_componentCount(0)
+    , m_simulationTime(0.0)
+    , m_iterationCount(0)
+{
+}
+
+int SimulatorSnapshot::getSharedPageCount(const SimulatorSnapshot &other) const
+{
+    int shared = 0;
+    int count = std::min(m_pages.size(), other.m_pages.size());
+
+    for (int i = 0; i < count; ++i) {
+        // Implicitly shared pages point at the same data block
+        if (m_pages[i].constData() == other.m_pages[i].constData()) {
+            shared++;
+        }
+    }
+
+    return shared;
+}
+
+qint64 SimulatorSnapshot::getByteSize() const
+{
+    qint64 bytes = (m_nodeVoltages.size() + m_solution.size()) * static_cast<qint64>(sizeof(double));
+    bytes += m_arduinoState.size();
+
+    for (const QByteArray &page : m_pages) {
+        bytes += page.size();
+    }
+
+    return bytes;
+}
@@ -0,0 +1,120 @@
+#include "simulation/SpeedController.h"
+#include "simulation/CircuitSimulator.h"
+#include <QtMath>
+
+SpeedController::SpeedController(CircuitSimulator *simulator, QObject *parent)
+    : QObject(parent)
+    , m_simulator(simulator)
+    , m_targetRatio(1.0)
+    , m_catchUpBudgetMs(8)
+    , m_maxLag(0.25)
+    , m_simOrigin(0.0)
+    , m_wallOriginNs(0)
+    , m_reportSimTime(0.0)
+    , m_reportWallNs(0)
+    , m_achievedRatio(0.0)
+    , m_droppedSteps(0)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SpeedController::tick);
+    m_wallClock.start();
+}
+
+void SpeedController::setTargetRatio(double ratio)
+{
+    m_targetRatio = qMax(0.0, ratio);
+    m_simulator->getScheduler().setTargetRealTimeFactor(m_targetRatio);
+
+    if (isRunning()) {
+        anchor();
+        m_timer.start(isUnbounded() ? 0 : FrameIntervalMs);
+    }
+}
+
+void SpeedController::start()
+{
+    if (isRunning()) {
+        return;
+    }
+
+    if (!m_simulator->isRunning()) {
+        m_simulator->start();
+    }
+
+    m_simulator->getScheduler().setTargetRealTimeFactor(m_targetRatio);
+    anchor();
+    m_reportSimTime = m_simulator->getSimulationTime();
+    m_reportWallNs = m_wallOriginNs;
+    m_timer.start(isUnbounded() ? 0 : FrameIntervalMs);
+}
+
+void SpeedController::stop()
+{
+    m_timer.stop();
+    m_achievedRatio = 0.0;
+}
+
+void SpeedController::anchor()
+{
+    m_simOrigin = m_simulator->getSimulationTime();
+    m_wallOriginNs = m_wallClock.nsecsElapsed();
+}
+
+void SpeedController::tick()
+{
+    double timeStep = m_simulator->getTimeStep();
+    if (timeStep <= 0.0) {
+        return;
+    }
+
+    QElapsedTimer slice;
+    slice.start();
+
+    if (isUnbounded()) {
+        while (slice.elapsed() < UnboundedSliceMs) {
+            double before = m_simulator->getSimulationTime();
+            m_simulator->step();
+            if (m_simulator->getSimulationTime() <= before) {
+                break;  // Step failed; don't spin on it for the whole slice
+            }
+        }
+    } else {
+        qint64 nowNs = m_wallClock.nsecsElapsed();
+        double target = m_simOrigin + m_targetRatio * (nowNs - m_wallOriginNs) / 1e9;
+        double behind = target - m_simulator->getSimulationTime();
+
+        // Forget backlog we won't be able to work off without a burst
+        if (behind > m_maxLag) {
+            double dropped = behind - m_maxLag;
+            m_droppedSteps += qRound64(dropped / timeStep);
+            m_simOrigin -= dropped;
+            target -= dropped;
+        }
+
+        while (target - m_simulator->getSimulationTime() >= timeStep &&
+               slice.elapsed() < m_catchUpBudgetMs) {
+            double before = m_simulator->getSimulationTime();
+            m_simulator->step();
+            if (m_simulator->getSimulationTime() <= before) {
+                break;  // Step failed; don't spin on it
+            }
+        }
+    }
+
+    report(m_wallClock.nsecsElapsed());
+}
+
+void SpeedController::report(qint64 nowNs)
+{
+    qint64 elapsedNs = nowNs - m_reportWallNs;
+    if (elapsedNs < qint64(ReportIntervalMs) * 1000000) {
+        return;
+    }
+
+    double simulationTime = m_simulator->getSimulationTime();
+    m_achievedRatio = (simulationTime - m_reportSimTime) * 1e9 / elapsedNs;
+    m_reportSimTime = simulationTime;
+    m_reportWallNs = nowNs;
+
+    emit ratioUpdated(m_achievedRatio, simulationTime);
+}
@@ -0,0 +1,379 @@
+#include "simulation/StimulusRecorder.h"
+#include "simulation/CircuitSimulator.h"
+#include "simulation/Circuit.h"
+#include "core/Arduino.h"
+#include "core/Resistor.h"
+#include "core/ElectricalComponent.h"
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+const quint32 RECORDING_MAGIC = 0x53544D31; // "STM1"
+const quint64 FNV_OFFSET = 14695981039346656037ULL;
+const quint64 FNV_PRIME = 1099511628211ULL;
+
+quint64 hashDouble(quint64 hash, double value)
+{
+    // Hash the exact bit pattern so any difference at all shows up
+    unsigned char bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(double));
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+}
+
+StimulusRecorder::StimulusRecorder(CircuitSimulator *simulator, QObject *parent)
+    : QObject(parent)
+    , m_simulator(simulator)
+    , m_recording(false)
+    , m_recordStartTime(0.0)
+{
+}
+
+void StimulusRecorder::startRecording()
+{
+    if (!m_simulator || m_recording) {
+        return;
+    }
+
+    m_stimuli.clear();
+    m_startSnapshot = m_simulator->saveSnapshot();
+    m_recordStartTime = m_simulator->getSimulationTime();
+    m_recording = true;
+
+    qDebug() << "Stimulus recording started at t =" << m_recordStartTime;
+}
+
+void StimulusRecorder::stopRecording()
+{
+    if (m_recording) {
+        m_recording = false;
+        qDebug() << "Stimulus recording stopped," << m_stimuli.size() << "stimuli recorded";
+    }
+}
+
+void StimulusRecorder::clear()
+{
+    m_stimuli.clear();
+    m_startSnapshot = SimulatorSnapshot();
+    m_recordStartTime = 0.0;
+}
+
+void StimulusRecorder::pinMode(Arduino *arduino, int pin, int mode)
+{
+    if (arduino) {
+        double time = m_simulator->getSimulationTime();
+        arduino->pinMode(pin, mode);
+        record(time, Stimulus::PinMode, arduinoIndex(arduino), pin, mode);
+    }
+}
+
+void StimulusRecorder::digitalWrite(Arduino *arduino, int pin, int value)
+{
+    if (arduino) {
+        double time = m_simulator->getSimulationTime();
+        arduino->digitalWrite(pin, value);
+        record(time, Stimulus::DigitalWrite, arduinoIndex(arduino), pin, value);
+    }
+}
+
+void StimulusRecorder::analogWrite(Arduino *arduino, int pin, int value)
+{
+    if (arduino) {
+        double time = m_simulator->getSimulationTime();
+        arduino->analogWrite(pin, value);
+        record(time, Stimulus::AnalogWrite, arduinoIndex(arduino), pin, value);
+    }
+}
+
+void StimulusRecorder::setResistance(Resistor *resistor, double resistance)
+{
+    if (resistor) {
+        double time = m_simulator->getSimulationTime();
+        resistor->setResistance(resistance);
+        record(time, Stimulus::ResistorValue, componentIndex(resistor), -1, resistance);
+    }
+}
+
+void StimulusRecorder::setPowered(Arduino *arduino, bool on)
+{
+    if (arduino) {
+        double time = m_simulator->getSimulationTime();
+        if (on) {
+            arduino->powerOn();
+        } else {
+            arduino->powerOff();
+        }
+        record(time, on ? Stimulus::PowerOn : Stimulus::PowerOff, arduinoIndex(arduino), -1, 0.0);
+    }
+}
+
+double StimulusRecorder::getRecordedDuration() const
+{
+    if (m_stimuli.isEmpty()) {
+        return 0.0;
+    }
+    return m_stimuli.last().time - m_recordStartTime;
+}
+
+// The time is read before the input is applied: in live mode applying it
+// triggers a synchronous solve, which has already advanced the clock
+void StimulusRecorder::record(double time, int type, int target, int pin, double value)
+{
+    if (!m_recording) {
+        return;
+    }
+
+    if (target < 0) {
+        qWarning() << "StimulusRecorder: input target is not part of the circuit, not recorded";
+        return;
+    }
+
+    Stimulus stimulus;
+    stimulus.time = time;
+    stimulus.type = type;
+    stimulus.target = target;
+    stimulus.pin = pin;
+    stimulus.value = value;
+
+    m_stimuli.append(stimulus);
+    emit stimulusRecorded(stimulus);
+}
+
+bool StimulusRecorder::apply(const Stimulus &stimulus)
+{
+    Circuit *circuit = m_simulator->getCircuit();
+
+    if (stimulus.type == Stimulus::ResistorValue) {
+        const QVector<Component*> &components = circuit->getComponents();
+        if (stimulus.target >= components.size()) {
+            return false;
+        }
+        Resistor *resistor = qobject_cast<Resistor*>(components[stimulus.target]);
+        if (!resistor) {
+            return false;
+        }
+        resistor->setResistance(stimulus.value);
+        return true;
+    }
+
+    QVector<Arduino*> arduinos = circuit->getArduinos();
+    if (stimulus.target >= arduinos.size()) {
+        return false;
+    }
+    Arduino *arduino = arduinos[stimulus.target];
+
+    switch (stimulus.type) {
+    case Stimulus::PinMode:
+        arduino->pinMode(stimulus.pin, static_cast<int>(stimulus.value));
+        break;
+    case Stimulus::DigitalWrite:
+        arduino->digitalWrite(stimulus.pin, static_cast<int>(stimulus.value));
+        break;
+    case Stimulus::AnalogWrite:
+        arduino->analogWrite(stimulus.pin, static_cast<int>(stimulus.value));
+        break;
+    case Stimulus::PowerOn:
+        arduino->powerOn();
+        break;
+    case Stimulus::PowerOff:
+        arduino->powerOff();
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+int StimulusRecorder::arduinoIndex(Arduino *arduino) const
+{
+    if (!m_simulator || !m_simulator->getCircuit()) {
+        return -1;
+    }
+    return m_simulator->getCircuit()->getArduinos().indexOf(arduino);
+}
+
+int StimulusRecorder::componentIndex(QObject *component) const
+{
+    if (!m_simulator || !m_simulator->getCircuit()) {
+        return -1;
+    }
+
+    const QVector<Component*> &components = m_simulator->getCircuit()->getComponents();
+    for (int i = 0; i < components.size(); ++i) {
+        if (components[i] == component) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+quint64 StimulusRecorder::hashState(quint64 hash) const
+{
+    for (Component *component : m_simulator->getCircuit()->getComponents()) {
+        ElectricalComponent *electrical = qobject_cast<ElectricalComponent*>(component);
+        if (electrical) {
+            hash = hashDouble(hash, electrical->getVoltage());
+            hash = hashDouble(hash, electrical->getCurrent());
+        }
+    }
+    return hash;
+}
+
+ReplayResult StimulusRecorder::replay(double duration)
+{
+    ReplayResult result;
+    result.success = false;
+    result.steps = 0;
+    result.stimuliApplied = 0;
+    result.finalTime = 0.0;
+    result.fingerprint = FNV_OFFSET;
+    result.elapsedMs = 0;
+
+    if (!m_simulator || !m_simulator->getCircuit()) {
+        qWarning() << "StimulusRecorder: no simulator to replay into";
+        return result;
+    }
+
+    if (m_recording) {
+        stopRecording();
+    }
+
+    // Live updates are paced by wall-clock timers; replay steps directly
+    bool wasRunning = m_simulator->isRunning();
+    if (wasRunning) {
+        m_simulator->stop();
+    }
+
+    if (!m_startSnapshot.isValid() || !m_simulator->restoreSnapshot(m_startSnapshot)) {
+        m_simulator->reset();
+    }
+
+    double startTime = m_simulator->getSimulationTime();
+    double endTime = duration >= 0.0 ? startTime + duration
+                                     : startTime + getRecordedDuration();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int next = 0;
+    bool failed = false;
+
+    // Apply each stimulus before the first step whose start time reaches it,
+    // which is where it was applied while recording
+    while (!failed) {
+        double now = m_simulator->getSimulationTime();
+
+        while (next < m_stimuli.size() && m_stimuli[next].time - m_recordStartTime + startTime <= now) {
+            if (!apply(m_stimuli[next])) {
+                qWarning() << "StimulusRecorder: cannot apply stimulus" << next
+                           << "- recording does not match this circuit";
+                failed = true;
+                break;
+            }
+            next++;
+            result.stimuliApplied++;
+        }
+
+        if (failed || now > endTime) {
+            break;
+        }
+
+        if (!m_simulator->step()) {
+            qWarning() << "StimulusRecorder: simulation step failed at" << now << "s";
+            failed = true;
+            break;
+        }
+        result.steps++;
+        result.fingerprint = hashState(result.fingerprint);
+    }
+
+    result.elapsedMs = timer.elapsed();
+    result.finalTime = m_simulator->getSimulationTime();
+    result.success = !failed;
+
+    qDebug() << "Replay finished:" << result.steps << "steps," << result.stimuliApplied
+             << "stimuli in" << result.elapsedMs << "ms, fingerprint"
+             << QString::number(result.fingerprint, 16);
+
+    if (wasRunning) {
+        m_simulator->start();
+    }
+
+    emit replayFinished(result);
+    return result;
+}
+
+bool StimulusRecorder::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "StimulusRecorder: cannot open" << fileName << "for writing";
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << RECORDING_MAGIC << m_recordStartTime << static_cast<qint32>(m_stimuli.size());
+
+    for (const Stimulus &stimulus : m_stimuli) {
+        out << stimulus.time << static_cast<qint32>(stimulus.type)
+            << static_cast<qint32>(stimulus.target) << static_cast<qint32>(stimulus.pin)
+            << stimulus.value;
+    }
+
+    return out.status() == QDataStream::Ok;
+}
+
+bool StimulusRecorder::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "StimulusRecorder: cannot open" << fileName;
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    double startTime = 0.0;
+    qint32 count = 0;
+    in >> magic >> startTime >> count;
+
+    if (magic != RECORDING_MAGIC || count < 0) {
+        qWarning() << "StimulusRecorder:" << fileName << "is not a stimulus recording";
+        return false;
+    }
+
+    QVector<Stimulus> stimuli;
+    stimuli.reserve(count);
+
+    for (qint32 i = 0; i < count; ++i) {
+        Stimulus stimulus;
+        qint32 type, target, pin;
+        in >> stimulus.time >> type >> target >> pin >> stimulus.value;
+        stimulus.type = type;
+        stimulus.target = target;
+        stimulus.pin = pin;
+        stimuli.append(stimulus);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "StimulusRecorder:" << fileName << "is truncated";
+        return false;
+    }
+
+    stopRecording();
+    m_stimuli = stimuli;
+    m_recordStartTime = startTime;
+    m_startSnapshot = SimulatorSnapshot();
+    return true;
+}
@@ -0,0 +1,85 @@
+#include "simulation/Subcircuit.h"
+#include "core/Component.h"
+#include <QDebug>
+#include <QHash>
+
+namespace {
+bool isGroundNet(const QString &net)
+{
+    // Same names Circuit registers for its ground node
+    return net == "GND" || net == "GROUND";
+}
+}
+
+SubcircuitTemplate::SubcircuitTemplate(const QString &name, const QStringList &ports)
+    : m_name(name)
+    , m_ports(ports)
+    , m_compiled(false)
+{
+}
+
+int SubcircuitTemplate::addElement(const QString &name, const Factory &factory, const QStringList &nets)
+{
+    m_elements.append({name, factory, nets, 0, nets.size()});
+    m_compiled = false;
+    return m_elements.size() - 1;
+}
+
+QString SubcircuitTemplate::getElementName(int element) const
+{
+    return element >= 0 && element < m_elements.size() ? m_elements[element].name : QString();
+}
+
+bool SubcircuitTemplate::compile()
+{
+    m_compiled = false;
+    m_slots.clear();
+    m_internalNets.clear();
+
+    QHash<QString, int> slotOf;
+    for (int port = 0; port < m_ports.size(); ++port) {
+        const QString &net = m_ports[port];
+        if (net.isEmpty() || isGroundNet(net) || slotOf.contains(net)) {
+            qWarning() << "Subcircuit" << m_name << "has an invalid port:" << net;
+            return false;
+        }
+        slotOf.insert(net, port);
+    }
+
+    for (Element &element : m_elements) {
+        if (!element.factory) {
+            qWarning() << "Subcircuit" << m_name << "element" << element.name << "has no factory";
+            return false;
+        }
+
+        // A throwaway prototype tells how many terminals the element has
+        Component *prototype = element.factory(nullptr);
+        int terminalCount = prototype ? prototype->getTerminalCount() : -1;
+        delete prototype;
+        if (terminalCount != element.nets.size()) {
+            qWarning() << "Subcircuit" << m_name << "element" << element.name
+                       << "names" << element.nets.size() << "nets for" << terminalCount << "terminals";
+            return false;
+        }
+
+        element.firstTerminal = m_slots.size();
+        element.terminalCount = terminalCount;
+        for (const QString &net : element.nets) {
+            if (net.isEmpty() || isGroundNet(net)) {
+                m_slots.append(net.isEmpty() ? UnconnectedSlot : GroundSlot);
+                continue;
+            }
+
+            int slot = slotOf.value(net, -1);
+            if (slot < 0) {
+                slot = m_ports.size() + m_internalNets.size();
+                slotOf.insert(net, slot);
+                m_internalNets.append(net);
+            }
+            m_slots.append(slot);
+        }
+    }
+
+    m_compiled = true;
+    return true;
+}
@@ -0,0 +1,207 @@
+#include "simulation/Tracing.h"
+#include <QDebug>
+
+#ifdef ARDUINOSIM_ENABLE_TRACING
+
+#include <QSaveFile>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    qint64 timestamp;   // ns
+    qint64 value;       // Duration (spans) or sample (counters)
+    char phase;         // 'X' span, 'C' counter
+};
+
+// Written only by its own thread; readers use the head index to tell
+// which slots hold complete events
+struct ThreadBuffer
+{
+    explicit ThreadBuffer(int id) : events(Tracing::BufferSize), head(0), start(0), threadId(id) {}
+
+    std::vector<TraceEvent> events;
+    std::atomic<quint64> head;  // Total events written
+    std::atomic<quint64> start; // Events before this index were cleared
+    int threadId;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextThreadId = 1;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// Buffers stay registered after their thread exits so its events can
+// still be written out
+ThreadBuffer &threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer = std::make_shared<ThreadBuffer>(r.nextThreadId++);
+        r.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void record(const char *name, char phase, qint64 timestamp, qint64 value)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    quint64 index = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer.events[index & (Tracing::BufferSize - 1)];
+    event.name = name;
+    event.timestamp = timestamp;
+    event.value = value;
+    event.phase = phase;
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void appendEscaped(QByteArray &out, const char *text)
+{
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out.append('\\');
+        }
+        out.append(*c);
+    }
+}
+
+}
+
+qint64 Tracing::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracing::recordSpan(const char *name, qint64 start, qint64 duration)
+{
+    record(name, 'X', start, duration);
+}
+
+void Tracing::recordCounter(const char *name, qint64 value)
+{
+    record(name, 'C', now(), value);
+}
+
+bool Tracing::isEnabled()
+{
+    return true;
+}
+
+void Tracing::clear()
+{
+    // The owning threads keep writing; only move the read start forward
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : r.buffers) {
+        buffer->start.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool Tracing::writeChromeTrace(const QString &fileName)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffers = r.buffers;
+    }
+
+    // Copy each ring out, then drop slots the writer may have overwritten
+    // while we were copying
+    QVector<QPair<int, TraceEvent>> events;
+    qint64 origin = -1;
+    for (const std::shared_ptr<ThreadBuffer> &buffer : buffers) {
+        quint64 head = buffer->head.load(std::memory_order_acquire);
+        quint64 first = head > quint64(BufferSize) ? head - BufferSize : 0;
+        first = qMax(first, buffer->start.load(std::memory_order_relaxed));
+
+        QVector<TraceEvent> copied;
+        copied.reserve(int(head - first));
+        for (quint64 i = first; i < head; ++i) {
+            copied.append(buffer->events[i & (BufferSize - 1)]);
+        }
+
+        quint64 after = buffer->head.load(std::memory_order_acquire);
+        quint64 valid = after > quint64(BufferSize) ? after - BufferSize : 0;
+        for (quint64 i = qMax(first, valid); i < head; ++i) {
+            const TraceEvent &event = copied[int(i - first)];
+            events.append(qMakePair(buffer->threadId, event));
+            if (origin < 0 || event.timestamp < origin) {
+                origin = event.timestamp;
+            }
+        }
+    }
+
+    QByteArray out;
+    out.reserve(events.size() * 96 + 64);
+    out.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (int i = 0; i < events.size(); ++i) {
+        const int threadId = events[i].first;
+        const TraceEvent &event = events[i].second;
+        double ts = (event.timestamp - origin) / 1000.0;    // Chrome expects microseconds
+
+        out.append(i ? ",\n{\"name\":\"" : "\n{\"name\":\"");
+        appendEscaped(out, event.name);
+        out.append("\",\"ph\":\"");
+        out.append(event.phase);
+        out.append("\",\"pid\":1,\"tid\":");
+        out.append(QByteArray::number(threadId));
+        out.append(",\"ts\":");
+        out.append(QByteArray::number(ts, 'f', 3));
+        if (event.phase == 'X') {
+            out.append(",\"dur\":");
+            out.append(QByteArray::number(event.value / 1000.0, 'f', 3));
+        } else {
+            out.append(",\"args\":{\"value\":");
+            out.append(QByteArray::number(event.value));
+            out.append('}');
+        }
+        out.append('}');
+    }
+    out.append("\n]}\n");
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write trace to" << fileName;
+        return false;
+    }
+    file.write(out);
+    return file.commit();
+}
+
+#else
+
+bool Tracing::isEnabled()
+{
+    return false;
+}
+
+bool Tracing::writeChromeTrace(const QString &fileName)
+{
+    qWarning() << "Tracing is not compiled in; not writing" << fileName;
+    return false;
+}
+
+void Tracing::clear()
+{
+}
+
+#endif // ARDUINOSIM_ENABLE_TRACING
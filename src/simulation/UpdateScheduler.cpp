@@ -0,0 +1,107 @@
+#include "simulation/UpdateScheduler.h"
+#include <cmath>
+
+UpdateScheduler::UpdateScheduler()
+    : m_policy(LatencyFirst)
+    , m_fixedIntervalMs(10)
+    , m_frameBudgetMs(1000.0 / 60.0)
+    , m_targetRealTimeFactor(0.0)
+    , m_timeStepMs(1.0)
+{
+    reset();
+}
+
+void UpdateScheduler::reset()
+{
+    m_hasSamples = false;
+    m_solveMs = 0.0;
+    m_iterationMs = 0.0;
+    m_achievedRealTimeFactor = 0.0;
+}
+
+void UpdateScheduler::recordUpdate(qint64 periodNs, qint64 solveNs, int iterations, double simulatedSeconds)
+{
+    double solveMs = solveNs / 1e6;
+    double iterationMs = solveMs / qMax(1, iterations);
+
+    // Updates far apart say nothing about achievable speed; only count
+    // periods where the simulator was kept busy
+    double periodMs = periodNs / 1e6;
+    bool busy = periodMs > 0.0 && periodMs <= qMax(2.0 * getUpdateInterval(), m_frameBudgetMs);
+
+    if (!m_hasSamples) {
+        m_solveMs = solveMs;
+        m_iterationMs = iterationMs;
+        m_achievedRealTimeFactor = busy ? simulatedSeconds * 1000.0 / periodMs : 0.0;
+        m_hasSamples = true;
+        return;
+    }
+
+    m_solveMs += Smoothing * (solveMs - m_solveMs);
+    m_iterationMs += Smoothing * (iterationMs - m_iterationMs);
+    if (busy) {
+        double factor = simulatedSeconds * 1000.0 / periodMs;
+        m_achievedRealTimeFactor += Smoothing * (factor - m_achievedRealTimeFactor);
+    }
+}
+
+int UpdateScheduler::getUpdateInterval() const
+{
+    if (m_policy == Fixed) {
+        return m_fixedIntervalMs;
+    }
+    if (!m_hasSamples) {
+        return 0;
+    }
+
+    double period = m_policy == LatencyFirst
+        ? m_solveMs / LatencyDuty
+        : qMax(m_solveMs / ThroughputDuty, m_frameBudgetMs);
+
+    // Hold the target speed unless that would starve the GUI thread
+    if (m_targetRealTimeFactor > 0.0) {
+        double stepMs = m_timeStepMs / m_targetRealTimeFactor;
+        period = qMax(qMin(period, stepMs), m_solveMs / ThroughputDuty);
+    }
+
+    return qBound(0, int(std::lround(period)), MaxIntervalMs);
+}
+
+int UpdateScheduler::getIterationBudget(int maxIterations) const
+{
+    if (m_policy != LatencyFirst || !m_hasSamples || m_iterationMs <= 0.0) {
+        return maxIterations;
+    }
+
+    double fits = m_frameBudgetMs * LatencyDuty / m_iterationMs;
+    if (fits >= maxIterations) {
+        return maxIterations;
+    }
+    return qMin(maxIterations, qMax(MinIterationBudget, int(fits)));
+}
+
+const char* UpdateScheduler::policyName(Policy policy)
+{
+    switch (policy) {
+        case Fixed:
+            return "fixed";
+        case LatencyFirst:
+            return "latencyFirst";
+        case ThroughputFirst:
+            return "throughputFirst";
+    }
+    return "unknown";
+}
+
+QJsonObject UpdateScheduler::toJson() const
+{
+    QJsonObject json;
+    json["policy"] = policyName(m_policy);
+    json["updateIntervalMs"] = getUpdateInterval();
+    json["frameBudgetMs"] = m_frameBudgetMs;
+    json["targetRealTimeFactor"] = m_targetRealTimeFactor;
+    json["achievedRealTimeFactor"] = m_achievedRealTimeFactor;
+    json["averageSolveMs"] = m_solveMs;
+    json["averageIterationMs"] = m_iterationMs;
+    return json;
+}
@@ -0,0 +1,347 @@
+#include "simulation/VcdWriter.h"
+#include "simulation/CircuitSimulator.h"
+#include "core/Arduino.h"
+#include <QDateTime>
+#include <QDebug>
+
+VcdWriter::VcdWriter(CircuitSimulator *simulator, QObject *parent)
+    : QObject(parent)
+    , m_simulator(simulator)
+#ifdef HAVE_ZLIB
+    , m_gzFile(nullptr)
+#endif
+    , m_isOpen(false)
+    , m_compressed(false)
+    , m_bufferSize(64 * 1024)
+    , m_lastTime(0)
+    , m_timeWritten(false)
+    , m_edgeCount(0)
+    , m_bytesWritten(0)
+{
+}
+
+VcdWriter::~VcdWriter()
+{
+    close();
+}
+
+void VcdWriter::addArduino(Arduino *arduino)
+{
+    if (!arduino) {
+        return;
+    }
+
+    QString scope = arduino->getBoardName();
+    for (int i = 0; i < arduino->getDigitalPinCount(); ++i) {
+        addPin(arduino->getDigitalPin(i), scope);
+    }
+}
+
+void VcdWriter::addPin(DigitalPin *pin, const QString &scope)
+{
+    if (!pin || m_traceIndex.contains(pin)) {
+        return;
+    }
+
+    if (m_isOpen) {
+        qWarning() << "VcdWriter: cannot add pin" << pin->getPinNumber()
+                   << "after the dump has been opened";
+        return;
+    }
+
+    PinTrace trace;
+    trace.pin = pin;
+    trace.scope = scope;
+    trace.scope.replace(" ", "_");
+    trace.levelId = makeIdentifier(m_traces.size() * 2);
+    trace.modeId = makeIdentifier(m_traces.size() * 2 + 1);
+    trace.lastLevel = levelOf(pin);
+    trace.lastMode = static_cast<int>(pin->getMode());
+
+    m_traceIndex[pin] = m_traces.size();
+    m_traces.append(trace);
+
+    connect(pin, &ArduinoPin::pinValueChanged, this, &VcdWriter::onPinValueChanged);
+    connect(pin, &ArduinoPin::pinModeChanged, this, &VcdWriter::onPinModeChanged);
+    connect(pin, &QObject::destroyed, this, &VcdWriter::onPinDestroyed);
+}
+
+bool VcdWriter::open(const QString &fileName)
+{
+    close();
+
+    m_compressed = fileName.endsWith(".gz");
+
+    if (m_compressed) {
+#ifdef HAVE_ZLIB
+        m_gzFile = gzopen(fileName.toLocal8Bit().constData(), "wb6");
+        if (!m_gzFile) {
+            qWarning() << "VcdWriter: cannot open" << fileName;
+            return false;
+        }
+#else
+        qWarning() << "VcdWriter: built without zlib, cannot write" << fileName;
+        return false;
+#endif
+    } else {
+        m_file.setFileName(fileName);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "VcdWriter: cannot open" << fileName << ":" << m_file.errorString();
+            return false;
+        }
+    }
+
+    m_isOpen = true;
+    m_buffer.reserve(m_bufferSize);
+    m_timeWritten = false;
+    m_edgeCount = 0;
+    m_bytesWritten = 0;
+    m_lastTime = m_simulator ? qRound64(m_simulator->getSimulationTime() * 1e9) : 0;
+
+    writeHeader();
+    return true;
+}
+
+void VcdWriter::close()
+{
+    if (!m_isOpen) {
+        return;
+    }
+
+    flushBuffer();
+
+#ifdef HAVE_ZLIB
+    if (m_gzFile) {
+        gzclose(m_gzFile);
+        m_gzFile = nullptr;
+    }
+#endif
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_isOpen = false;
+    qDebug() << "VcdWriter: recorded" << m_edgeCount << "changes," << m_bytesWritten << "bytes";
+}
+
+void VcdWriter::flush()
+{
+    if (!m_isOpen) {
+        return;
+    }
+
+    flushBuffer();
+#ifdef HAVE_ZLIB
+    if (m_gzFile) {
+        gzflush(m_gzFile, Z_SYNC_FLUSH);
+    }
+#endif
+    if (m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+void VcdWriter::setBufferSize(int bytes)
+{
+    // Keep at least room for a handful of value changes per flush
+    m_bufferSize = std::max(bytes, 256);
+    if (m_isOpen) {
+        flushBuffer();
+        m_buffer.reserve(m_bufferSize);
+    }
+}
+
+void VcdWriter::onPinValueChanged(double value)
+{
+    Q_UNUSED(value)
+
+    DigitalPin *pin = qobject_cast<DigitalPin*>(sender());
+    int index = m_traceIndex.value(pin, -1);
+    if (index < 0) {
+        return;
+    }
+
+    PinTrace &trace = m_traces[index];
+    char level = levelOf(pin);
+    if (level == trace.lastLevel) {
+        return; // Not an edge
+    }
+
+    trace.lastLevel = level;
+    if (m_isOpen) {
+        writeTime();
+        writeLevel(trace, level);
+        m_edgeCount++;
+    }
+}
+
+void VcdWriter::onPinModeChanged(ArduinoPin::PinMode mode)
+{
+    DigitalPin *pin = qobject_cast<DigitalPin*>(sender());
+    int index = m_traceIndex.value(pin, -1);
+    if (index < 0) {
+        return;
+    }
+
+    PinTrace &trace = m_traces[index];
+    char level = levelOf(pin);
+    bool modeChanged = static_cast<int>(mode) != trace.lastMode;
+    bool levelChanged = level != trace.lastLevel;
+    if (!modeChanged && !levelChanged) {
+        return;
+    }
+
+    trace.lastMode = static_cast<int>(mode);
+    trace.lastLevel = level;
+    if (m_isOpen) {
+        writeTime();
+        if (modeChanged) {
+            writeMode(trace, trace.lastMode);
+        }
+        if (levelChanged) {
+            writeLevel(trace, level);
+        }
+        m_edgeCount++;
+    }
+}
+
+void VcdWriter::onPinDestroyed(QObject *object)
+{
+    // The pin is already partially destroyed, so match on the address only
+    for (auto it = m_traceIndex.begin(); it != m_traceIndex.end(); ++it) {
+        if (static_cast<QObject*>(it.key()) == object) {
+            m_traces[it.value()].pin = nullptr;
+            m_traceIndex.erase(it);
+            break;
+        }
+    }
+}
+
+QByteArray VcdWriter::makeIdentifier(int index)
+{
+    // VCD identifiers use the printable ASCII range '!' (33) to '~' (126)
+    QByteArray id;
+    do {
+        id.append(static_cast<char>('!' + index % 94));
+        index /= 94;
+    } while (index > 0);
+    return id;
+}
+
+char VcdWriter::levelOf(const DigitalPin *pin)
+{
+    if (pin->isInput() && !pin->getNode(0)) {
+        return 'z'; // Floating input
+    }
+
+    // Same 2.5V threshold the pin itself uses for digitalRead()
+    return pin->readPin() > 2.5 ? '1' : '0';
+}
+
+void VcdWriter::writeHeader()
+{
+    QByteArray header;
+    header += "$date " + QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() + " $end\n";
+    header += "$version ArduinoSimulator VcdWriter $end\n";
+    header += "$timescale 1ns $end\n";
+
+    // Pins destroyed before the dump was opened are left out
+    QString currentScope;
+    for (const PinTrace &trace : m_traces) {
+        if (!trace.pin) {
+            continue;
+        }
+        if (trace.scope != currentScope) {
+            if (!currentScope.isEmpty()) {
+                header += "$upscope $end\n";
+            }
+            currentScope = trace.scope;
+            header += "$scope module " + currentScope.toUtf8() + " $end\n";
+        }
+
+        QByteArray name = "D" + QByteArray::number(trace.pin->getPinNumber());
+        header += "$var wire 1 " + trace.levelId + " " + name + " $end\n";
+        header += "$var reg 3 " + trace.modeId + " " + name + "_mode $end\n";
+    }
+    if (!currentScope.isEmpty()) {
+        header += "$upscope $end\n";
+    }
+    header += "$enddefinitions $end\n";
+    append(header);
+
+    // Initial values
+    writeTime();
+    append("$dumpvars\n");
+    for (const PinTrace &trace : m_traces) {
+        if (!trace.pin) {
+            continue;
+        }
+        writeLevel(trace, trace.lastLevel);
+        writeMode(trace, trace.lastMode);
+    }
+    append("$end\n");
+}
+
+void VcdWriter::writeTime()
+{
+    qint64 now = m_simulator ? qRound64(m_simulator->getSimulationTime() * 1e9) : 0;
+
+    // VCD time must never go backwards (e.g. after a simulator reset)
+    now = std::max(now, m_lastTime);
+
+    if (!m_timeWritten || now != m_lastTime) {
+        append("#" + QByteArray::number(now) + "\n");
+        m_lastTime = now;
+        m_timeWritten = true;
+    }
+}
+
+void VcdWriter::writeLevel(const PinTrace &trace, char level)
+{
+    QByteArray line;
+    line.append(level);
+    line.append(trace.levelId);
+    line.append('\n');
+    append(line);
+}
+
+void VcdWriter::writeMode(const PinTrace &trace, int mode)
+{
+    QByteArray line("b");
+    for (int bit = 2; bit >= 0; --bit) {
+        line.append((mode >> bit) & 1 ? '1' : '0');
+    }
+    line.append(' ');
+    line.append(trace.modeId);
+    line.append('\n');
+    append(line);
+}
+
+void VcdWriter::append(const QByteArray &data)
+{
+    if (m_buffer.size() + data.size() > m_bufferSize) {
+        flushBuffer();
+    }
+    m_buffer.append(data);
+}
+
+void VcdWriter::flushBuffer()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+#ifdef HAVE_ZLIB
+    if (m_gzFile) {
+        gzwrite(m_gzFile, m_buffer.constData(), static_cast<unsigned>(m_buffer.size()));
+    }
+#endif
+    if (m_file.isOpen()) {
+        m_file.write(m_buffer);
+    }
+
+    m_bytesWritten += m_buffer.size();
+
+    // resize() keeps the reserved capacity, so the buffer is reused
+    m_buffer.resize(0);
+}
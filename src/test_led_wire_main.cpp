@@ -9,16 +9,25 @@
 #include <QDebug>
 #include <QTimer>
 #include <QGroupBox>
+#include <QFileDialog>
+#include <QDockWidget>
+#include <QAction>
+#include <QComboBox>
 
 // Include UI components
 #include "ui/CircuitCanvas.h"
 #include "ui/LEDGraphicsItem.h"
 #include "ui/WireGraphicsItem.h"
 #include "ui/ArduinoGraphicsItem.h"
+#include "ui/UiDiagnostics.h"
+#include "ui/UiDiagnosticsWidget.h"
 
 // Include backend components
 #include "simulation/Circuit.h"
 #include "simulation/CircuitSimulator.h"
+#include "simulation/VcdWriter.h"
+#include "simulation/StimulusRecorder.h"
+#include "simulation/SpeedController.h"
 #include "core/LED.h"
 #include "core/Arduino.h"
 
@@ -32,6 +41,9 @@ public:
         , m_circuit(nullptr)
         , m_simulator(nullptr)
         , m_arduino(nullptr)
+        , m_vcdWriter(nullptr)
+        , m_recorder(nullptr)
+        , m_speedController(nullptr)
         , m_circuitCanvas(nullptr)
         , m_graphicsView(nullptr)
     {
@@ -78,6 +90,21 @@ private slots:
         }
     }
 
+    void addSensorSource()
+    {
+        if (!m_circuitCanvas) return;
+        
+        QString fileName = QFileDialog::getOpenFileName(this, "Open Sensor Recording", QString(),
+                                                        "Sample files (*.csv *.txt *.bin *.dat *.raw)");
+        if (fileName.isEmpty()) return;
+        
+        if (m_circuitCanvas->addSampledSource(QPointF(100, 350), fileName)) {
+            m_statusLabel->setText("Added sensor source playing " + fileName);
+        } else {
+            m_statusLabel->setText("✗ Cannot read " + fileName);
+        }
+    }
+
     void clearCanvas()
     {
         if (!m_circuitCanvas) return;
@@ -102,7 +129,7 @@ private slots:
     {
         if (!m_simulator) return;
         
-        m_simulator->start();
+        m_speedController->start();
         m_simulationButton->setText("Stop Simulation");
         m_simulationButton->disconnect();
         connect(m_simulationButton, &QPushButton::clicked, this, &LEDWireTestWindow::stopSimulation);
@@ -114,7 +141,9 @@ private slots:
     {
         if (!m_simulator) return;
         
+        m_speedController->stop();
         m_simulator->stop();
+        m_speedLabel->setText("Achieved: -");
         m_simulationButton->setText("Start Simulation");
         m_simulationButton->disconnect();
         connect(m_simulationButton, &QPushButton::clicked, this, &LEDWireTestWindow::startSimulation);
@@ -122,16 +151,86 @@ private slots:
         m_statusLabel->setText("Simulation stopped");
     }
 
+    void changeSpeed(int index)
+    {
+        if (!m_speedController) return;
+        
+        m_speedController->setTargetRatio(m_speedCombo->itemData(index).toDouble());
+        m_statusLabel->setText("Simulation speed: " + m_speedCombo->itemText(index));
+    }
+
+    void toggleVcdRecording()
+    {
+        if (m_vcdWriter) {
+            m_vcdWriter->close();
+            m_statusLabel->setText(QString("VCD recording stopped (%1 changes)")
+                                  .arg(m_vcdWriter->getEdgeCount()));
+            delete m_vcdWriter;
+            m_vcdWriter = nullptr;
+            m_vcdButton->setText("Record VCD...");
+            return;
+        }
+        
+        if (!m_simulator || !m_arduino) return;
+        
+        QString fileName = QFileDialog::getSaveFileName(this, "Record Pin Activity", "pins.vcd",
+                                                        "Value Change Dump (*.vcd *.vcd.gz)");
+        if (fileName.isEmpty()) return;
+        
+        m_vcdWriter = new VcdWriter(m_simulator, this);
+        m_vcdWriter->addArduino(m_arduino);
+        if (!m_vcdWriter->open(fileName)) {
+            delete m_vcdWriter;
+            m_vcdWriter = nullptr;
+            m_statusLabel->setText("✗ Cannot write " + fileName);
+            return;
+        }
+        
+        m_vcdButton->setText("Stop VCD Recording");
+        m_statusLabel->setText("Recording pin activity to " + fileName);
+    }
+
+    void toggleInputRecording()
+    {
+        if (!m_recorder) return;
+        
+        if (m_recorder->isRecording()) {
+            m_recorder->stopRecording();
+            m_recordButton->setText("Record Inputs");
+            m_replayButton->setEnabled(m_recorder->getStimulusCount() > 0);
+            m_statusLabel->setText(QString("Recorded %1 inputs over %2 s")
+                                  .arg(m_recorder->getStimulusCount())
+                                  .arg(m_recorder->getRecordedDuration()));
+        } else {
+            m_recorder->startRecording();
+            m_recordButton->setText("Stop Recording Inputs");
+            m_replayButton->setEnabled(false);
+            m_statusLabel->setText("Recording inputs");
+        }
+    }
+
+    void replayInputs()
+    {
+        if (!m_recorder) return;
+        
+        ReplayResult result = m_recorder->replay();
+        m_statusLabel->setText(QString("%1 replay: %2 inputs, %3 steps in %4 ms")
+                              .arg(result.success ? "✓" : "✗")
+                              .arg(result.stimuliApplied)
+                              .arg(result.steps)
+                              .arg(result.elapsedMs));
+    }
+
     void powerArduino()
     {
         if (!m_arduino) return;
         
         if (m_arduino->isPoweredOn()) {
-            m_arduino->powerOff();
+            m_recorder->setPowered(m_arduino, false);
             m_powerButton->setText("Power On Arduino");
             m_statusLabel->setText("Arduino powered off");
         } else {
-            m_arduino->powerOn();
+            m_recorder->setPowered(m_arduino, true);
             m_powerButton->setText("Power Off Arduino");
             m_statusLabel->setText("Arduino powered on");
         }
@@ -144,7 +243,7 @@ private slots:
             return;
         }
         
-        m_arduino->pinMode(13, Arduino::OUTPUT);
+        m_recorder->pinMode(m_arduino, 13, Arduino::OUTPUT);
         m_statusLabel->setText("Pin 13 configured as OUTPUT");
     }
 
@@ -158,7 +257,7 @@ private slots:
         static bool pin13State = false;
         pin13State = !pin13State;
         
-        m_arduino->digitalWrite(13, pin13State ? Arduino::HIGH : Arduino::LOW);
+        m_recorder->digitalWrite(m_arduino, 13, pin13State ? Arduino::HIGH : Arduino::LOW);
         m_pin13Button->setText(pin13State ? "Pin 13: HIGH" : "Pin 13: LOW");
         
         m_statusLabel->setText(QString("Pin 13 set to %1").arg(pin13State ? "HIGH" : "LOW"));
@@ -216,14 +315,17 @@ private:
         
         QPushButton* addLEDBtn = new QPushButton("Add LED");
         QPushButton* addArduinoBtn = new QPushButton("Add Arduino");
+        QPushButton* addSensorBtn = new QPushButton("Add Sensor Source...");
         QPushButton* clearBtn = new QPushButton("Clear Canvas");
         
         componentLayout->addWidget(addLEDBtn);
         componentLayout->addWidget(addArduinoBtn);
+        componentLayout->addWidget(addSensorBtn);
         componentLayout->addWidget(clearBtn);
         
         connect(addLEDBtn, &QPushButton::clicked, this, &LEDWireTestWindow::addLED);
         connect(addArduinoBtn, &QPushButton::clicked, this, &LEDWireTestWindow::addArduino);
+        connect(addSensorBtn, &QPushButton::clicked, this, &LEDWireTestWindow::addSensorSource);
         connect(clearBtn, &QPushButton::clicked, this, &LEDWireTestWindow::clearCanvas);
         
         // Simulation controls
@@ -234,6 +336,31 @@ private:
         connect(m_simulationButton, &QPushButton::clicked, this, &LEDWireTestWindow::startSimulation);
         simLayout->addWidget(m_simulationButton);
         
+        // Simulated seconds per wall second; 0 runs as fast as possible
+        m_speedCombo = new QComboBox();
+        m_speedCombo->addItem("1x (real time)", 1.0);
+        m_speedCombo->addItem("0.1x (slow motion)", 0.1);
+        m_speedCombo->addItem("Unbounded", 0.0);
+        connect(m_speedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                this, &LEDWireTestWindow::changeSpeed);
+        simLayout->addWidget(m_speedCombo);
+        
+        m_speedLabel = new QLabel("Achieved: -");
+        simLayout->addWidget(m_speedLabel);
+        
+        m_vcdButton = new QPushButton("Record VCD...");
+        connect(m_vcdButton, &QPushButton::clicked, this, &LEDWireTestWindow::toggleVcdRecording);
+        simLayout->addWidget(m_vcdButton);
+        
+        m_recordButton = new QPushButton("Record Inputs");
+        connect(m_recordButton, &QPushButton::clicked, this, &LEDWireTestWindow::toggleInputRecording);
+        simLayout->addWidget(m_recordButton);
+        
+        m_replayButton = new QPushButton("Replay Inputs");
+        m_replayButton->setEnabled(false);
+        connect(m_replayButton, &QPushButton::clicked, this, &LEDWireTestWindow::replayInputs);
+        simLayout->addWidget(m_replayButton);
+        
         // Arduino controls
         QGroupBox* arduinoGroup = new QGroupBox("Arduino Control");
         QVBoxLayout* arduinoLayout = new QVBoxLayout(arduinoGroup);
@@ -260,7 +387,8 @@ private:
             "3. Click on another connection point to complete wire\n"
             "4. Right-click or ESC to cancel wire drawing\n"
             "5. Start simulation to see electrical behavior\n"
-            "6. Use Arduino controls to test LED circuits"
+            "6. Use Arduino controls to test LED circuits\n"
+            "7. F12 shows responsiveness diagnostics"
         );
         instructions->setWordWrap(true);
         instructions->setStyleSheet("font-size: 10px; color: #666;");
@@ -295,6 +423,27 @@ private:
         // Add to main layout
         mainLayout->addWidget(controlPanel);
         mainLayout->addWidget(m_graphicsView, 1); // Give graphics view more space
+        
+        setupDiagnostics();
+    }
+
+    void setupDiagnostics()
+    {
+        UiDiagnostics* diagnostics = new UiDiagnostics(this);
+        m_circuitCanvas->setDiagnostics(diagnostics);
+        
+        QDockWidget* dock = new QDockWidget("Diagnostics", this);
+        dock->setObjectName("diagnosticsDock");
+        dock->setWidget(new UiDiagnosticsWidget(diagnostics, dock));
+        addDockWidget(Qt::RightDockWidgetArea, dock);
+        dock->hide();
+        
+        // Measure only while the dock is open (F12)
+        connect(dock, &QDockWidget::visibilityChanged, diagnostics, &UiDiagnostics::setEnabled);
+        
+        QAction* toggle = dock->toggleViewAction();
+        toggle->setShortcut(Qt::Key_F12);
+        addAction(toggle);
     }
 
     void setupCircuit()
@@ -303,8 +452,20 @@ private:
         m_circuit = new Circuit(this);
         m_simulator = new CircuitSimulator(m_circuit, this);
         
+        // Paces the simulation clock against wall time
+        m_speedController = new SpeedController(m_simulator, this);
+        connect(m_speedController, &SpeedController::ratioUpdated, [this](double ratio, double time) {
+            m_speedLabel->setText(QString("Achieved: %1x at t = %2 s")
+                                 .arg(ratio, 0, 'g', 3)
+                                 .arg(time, 0, 'f', 2));
+        });
+        
+        // All user inputs go through the recorder
+        m_recorder = new StimulusRecorder(m_simulator, this);
+        
         // Set circuit for canvas
         m_circuitCanvas->setCircuit(m_circuit);
+        m_circuitCanvas->setStimulusRecorder(m_recorder);
         
         // Create Arduino for testing
         m_arduino = new Arduino(Arduino::UNO, this);
@@ -339,6 +500,14 @@ private:
 
     void cleanup()
     {
+        if (m_vcdWriter) {
+            m_vcdWriter->close();
+        }
+        
+        if (m_speedController) {
+            m_speedController->stop();
+        }
+        
         if (m_simulator) {
             m_simulator->stop();
         }
@@ -353,12 +522,20 @@ private:
     Circuit* m_circuit;
     CircuitSimulator* m_simulator;
     Arduino* m_arduino;
+    VcdWriter* m_vcdWriter;     // While recording
+    StimulusRecorder* m_recorder;
+    SpeedController* m_speedController;
     
     // UI objects
     CircuitCanvas* m_circuitCanvas;
     QGraphicsView* m_graphicsView;
     QLabel* m_statusLabel;
     QPushButton* m_simulationButton;
+    QComboBox* m_speedCombo;
+    QLabel* m_speedLabel;
+    QPushButton* m_vcdButton;
+    QPushButton* m_recordButton;
+    QPushButton* m_replayButton;
     QPushButton* m_powerButton;
     QPushButton* m_pin13Button;
 };
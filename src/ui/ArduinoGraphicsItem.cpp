@@ -1,4 +1,5 @@
 #include "ui/ArduinoGraphicsItem.h"
+#include "ui/UiDiagnostics.h"
 #include "core/Arduino.h"
 #include "core/ArduinoPin.h"
 #include <QPainter>
@@ -54,6 +55,8 @@ void ArduinoGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsIte
     Q_UNUSED(option)
     Q_UNUSED(widget)
     
+    PaintTimer paintTimer(this, UiDiagnostics::ArduinoItem);
+    
     painter->setRenderHint(QPainter::Antialiasing);
     
     // Arduino board body
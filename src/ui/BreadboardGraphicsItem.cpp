@@ -0,0 +1,207 @@
+#include "ui/BreadboardGraphicsItem.h"
+#include "core/Breadboard.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QFont>
+#include <QPen>
+#include <QBrush>
+#include <QtMath>
+#include <QDebug>
+
+BreadboardGraphicsItem::BreadboardGraphicsItem(Breadboard* backendBoard, QGraphicsItem* parent)
+    : ComponentGraphicsItem(parent)
+    , m_backendBoard(backendBoard)
+{
+    if (!m_backendBoard) {
+        qWarning() << "BreadboardGraphicsItem created with null backend board";
+        return;
+    }
+
+    setFlag(QGraphicsItem::ItemIsMovable, true);
+    setFlag(QGraphicsItem::ItemIsSelectable, true);
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+    setZValue(-2); // Behind wires and the parts plugged into it
+
+    buildHolePath();
+
+    qDebug() << "Created BreadboardGraphicsItem for" << m_backendBoard->getName()
+             << "with" << m_backendBoard->getHoleCount() << "holes";
+}
+
+QPointF BreadboardGraphicsItem::holePosition(int hole) const
+{
+    int row = m_backendBoard->holeRow(hole);
+    int column = m_backendBoard->holeColumn(hole);
+
+    // Gaps between the rails and the strips, and across the center channel
+    qreal y = row * Pitch;
+    if (row >= Breadboard::RowA) {
+        y += Pitch;
+    }
+    if (row >= Breadboard::RowF) {
+        y += Pitch;
+    }
+    if (row >= Breadboard::BottomPositiveRail) {
+        y += Pitch;
+    }
+
+    return QPointF(column * Pitch, y);
+}
+
+void BreadboardGraphicsItem::buildHolePath()
+{
+    m_holePath = QPainterPath();
+    for (int hole = 0; hole < m_backendBoard->getHoleCount(); ++hole) {
+        QPointF center = holePosition(hole);
+        m_holePath.addRect(QRectF(center.x() - HoleSize / 2, center.y() - HoleSize / 2, HoleSize, HoleSize));
+    }
+}
+
+QRectF BreadboardGraphicsItem::boundingRect() const
+{
+    QPointF last = holePosition(m_backendBoard->getHoleCount() - 1);
+    return QRectF(-Pitch, -Pitch, last.x() + 2 * Pitch, last.y() + 2 * Pitch + 14);
+}
+
+void BreadboardGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    const QRectF bounds = boundingRect();
+    const QRectF body = bounds.adjusted(0, 0, 0, -14);
+
+    // Board
+    painter->setPen(QPen(QColor(180, 180, 180), 1));
+    painter->setBrush(QBrush(QColor(245, 245, 240)));
+    painter->drawRect(body);
+
+    // Rail markings above and below the strips
+    qreal railTop = holePosition(m_backendBoard->hole(Breadboard::TopPositiveRail, 0)).y();
+    qreal railBottom = holePosition(m_backendBoard->hole(Breadboard::BottomNegativeRail, 0)).y();
+    painter->setPen(QPen(Qt::red, 1));
+    painter->drawLine(QPointF(body.left(), railTop - Pitch / 2), QPointF(body.right(), railTop - Pitch / 2));
+    painter->drawLine(QPointF(body.left(), railBottom - Pitch * 1.5), QPointF(body.right(), railBottom - Pitch * 1.5));
+    painter->setPen(QPen(Qt::blue, 1));
+    painter->drawLine(QPointF(body.left(), railTop + Pitch * 1.5), QPointF(body.right(), railTop + Pitch * 1.5));
+    painter->drawLine(QPointF(body.left(), railBottom + Pitch / 2), QPointF(body.right(), railBottom + Pitch / 2));
+
+    // All holes in one call, then the occupied ones on top
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QBrush(QColor(90, 90, 90)));
+    painter->drawPath(m_holePath);
+
+    painter->setBrush(QBrush(QColor(0, 150, 0)));
+    for (int hole = 0; hole < m_backendBoard->getHoleCount(); ++hole) {
+        if (isConnectionPointOccupied(hole)) {
+            QPointF center = holePosition(hole);
+            painter->drawRect(QRectF(center.x() - HoleSize / 2, center.y() - HoleSize / 2, HoleSize, HoleSize));
+        }
+    }
+
+    // Label
+    painter->setPen(QPen(Qt::black, 1));
+    painter->setFont(QFont("Arial", 7));
+    painter->drawText(QRectF(body.left(), body.bottom(), body.width(), 14), Qt::AlignCenter,
+                      m_backendBoard->getName());
+
+    if (isSelected()) {
+        drawSelectionIndicator(painter, bounds);
+    }
+}
+
+Component* BreadboardGraphicsItem::getBackendComponent() const
+{
+    return m_backendBoard;
+}
+
+QString BreadboardGraphicsItem::getComponentType() const
+{
+    return "Breadboard";
+}
+
+QPointF BreadboardGraphicsItem::getConnectionPointPosition(int index) const
+{
+    if (m_backendBoard->isValidHole(index)) {
+        return mapToScene(holePosition(index));
+    }
+    return QPointF();
+}
+
+bool BreadboardGraphicsItem::isConnectionPointOccupied(int index) const
+{
+    return m_occupiedHoles.contains(index);
+}
+
+void BreadboardGraphicsItem::setConnectionPointOccupied(int index, bool occupied)
+{
+    if (!m_backendBoard->isValidHole(index)) {
+        return;
+    }
+
+    if (occupied) {
+        m_occupiedHoles.insert(index);
+    } else {
+        m_occupiedHoles.remove(index);
+    }
+    update();
+}
+
+int BreadboardGraphicsItem::getConnectionPointAt(const QPointF& scenePos) const
+{
+    const qreal connectionRadius = Pitch / 2;
+
+    // Nearest column directly; rows are few and unevenly spaced
+    QPointF local = mapFromScene(scenePos);
+    int column = qRound(local.x() / Pitch);
+    if (column < 0 || column >= m_backendBoard->getColumns()) {
+        return -1;
+    }
+
+    for (int row = 0; row < Breadboard::RowCount; ++row) {
+        int hole = m_backendBoard->hole(row, column);
+        if (QLineF(holePosition(hole), local).length() <= connectionRadius) {
+            return hole;
+        }
+    }
+
+    return -1;
+}
+
+int BreadboardGraphicsItem::findFreeConnectionPoint(const QPointF& scenePos, qreal radius, qreal* distance) const
+{
+    int nearest = -1;
+    qreal nearestDistance = radius;
+
+    // Only the columns within reach can hold a candidate
+    QPointF local = mapFromScene(scenePos);
+    int firstColumn = qMax(0, qCeil((local.x() - radius) / Pitch));
+    int lastColumn = qMin(m_backendBoard->getColumns() - 1, qFloor((local.x() + radius) / Pitch));
+
+    for (int column = firstColumn; column <= lastColumn; ++column) {
+        for (int row = 0; row < Breadboard::RowCount; ++row) {
+            int hole = m_backendBoard->hole(row, column);
+            if (isConnectionPointOccupied(hole)) continue;
+
+            qreal holeDistance = QLineF(holePosition(hole), local).length();
+            if (holeDistance < nearestDistance) {
+                nearestDistance = holeDistance;
+                nearest = hole;
+            }
+        }
+    }
+
+    if (distance) {
+        *distance = nearestDistance;
+    }
+    return nearest;
+}
+
+QVariant BreadboardGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemPositionChange) {
+        emit componentMoved(this);
+    }
+
+    return ComponentGraphicsItem::itemChange(change, value);
+}
@@ -3,10 +3,20 @@
 #include "ui/LEDGraphicsItem.h"
 #include "ui/ResistorGraphicsItem.h"
 #include "ui/ArduinoGraphicsItem.h"
+#include "ui/LedStripGraphicsItem.h"
+#include "ui/LedMatrixGraphicsItem.h"
+#include "ui/BreadboardGraphicsItem.h"
+#include "ui/SampledSourceGraphicsItem.h"
 #include "ui/WireGraphicsItem.h"
+#include "ui/CircuitCommands.h"
+#include "ui/UiDiagnostics.h"
 #include "simulation/Circuit.h"
 #include "simulation/Node.h"
+#include "simulation/StimulusRecorder.h"
 #include "core/LED.h"
+#include "core/LedStrip.h"
+#include "core/LedMatrix.h"
+#include "core/Breadboard.h"
 #include "core/Resistor.h"
 #include "core/Wire.h"
 #include "core/Arduino.h"
@@ -14,7 +24,9 @@
 #include <QGraphicsView>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QFileDialog>
 #include <QAction>
+#include <QUndoStack>
 #include <QDebug>
 #include <QtMath>
 
@@ -25,12 +37,14 @@ CircuitCanvas::CircuitCanvas(QObject* parent)
     , m_currentWire(nullptr)
     , m_startComponent(nullptr)
     , m_startTerminal(-1)
+    , m_busWidth(1)
     , m_snapRadius(15.0)
     , m_gridSize(20.0)
     , m_showGrid(true)
     , m_snapToGrid(true)
     , m_snapToComponents(true)
     , m_nextComponentId(1)
+    , m_undoStack(new QUndoStack(this))
 {
     // Set scene size (can be made configurable)
     setSceneRect(-2000, -1500, 4000, 3000);
@@ -43,7 +57,11 @@ CircuitCanvas::CircuitCanvas(QObject* parent)
 
 CircuitCanvas::~CircuitCanvas()
 {
-    // Cleanup is handled by Qt's scene management
+    // Commands own the items they took out of the scene; release them while
+    // the items still in the scene (which they may reference) are alive
+    m_undoStack->clear();
+    
+    // Remaining cleanup is handled by Qt's scene management
     qDebug() << "CircuitCanvas destroyed";
 }
 
@@ -79,9 +97,6 @@ ComponentGraphicsItem* CircuitCanvas::addLED(const QPointF& position, const QCol
     LED* backendLED = LED::createStandardLED(color.name(), m_circuit);
     backendLED->setName(QString("LED%1").arg(m_nextComponentId++));
     
-    // Add to circuit
-    m_circuit->addComponent(backendLED);
-    
     // Create graphics item
     LEDGraphicsItem* ledGraphics = new LEDGraphicsItem(backendLED);
     ledGraphics->setPos(snapToGrid(position));
@@ -89,14 +104,119 @@ ComponentGraphicsItem* CircuitCanvas::addLED(const QPointF& position, const QCol
     // Connect signals
     connectComponentSignals(ledGraphics);
     
-    // Add to scene
-    addItem(ledGraphics);
-    m_componentItems.append(ledGraphics);
+    // Add to circuit and scene
+    m_undoStack->push(new AddComponentCommand(this, ledGraphics));
     
     qDebug() << "Added LED at position" << position;
     return ledGraphics;
 }
 
+ComponentGraphicsItem* CircuitCanvas::addLedStrip(const QPointF& position, int pixelCount)
+{
+    if (!m_circuit) {
+        qWarning() << "Cannot add LED strip: no circuit set";
+        return nullptr;
+    }
+    
+    // Create backend strip
+    LedStrip* backendStrip = new LedStrip(pixelCount, m_circuit);
+    backendStrip->setName(QString("STRIP%1").arg(m_nextComponentId++));
+    
+    // Create graphics item
+    LedStripGraphicsItem* stripGraphics = new LedStripGraphicsItem(backendStrip);
+    stripGraphics->setPos(snapToGrid(position));
+    
+    // Connect signals
+    connectComponentSignals(stripGraphics);
+    
+    // Add to circuit and scene
+    m_undoStack->push(new AddComponentCommand(this, stripGraphics));
+    
+    qDebug() << "Added LED strip with" << pixelCount << "pixels at position" << position;
+    return stripGraphics;
+}
+
+ComponentGraphicsItem* CircuitCanvas::addLedMatrix(const QPointF& position, int rows, int columns, const QColor& color)
+{
+    if (!m_circuit) {
+        qWarning() << "Cannot add LED matrix: no circuit set";
+        return nullptr;
+    }
+    
+    // Create backend matrix
+    LedMatrix* backendMatrix = new LedMatrix(rows, columns, color, m_circuit);
+    backendMatrix->setName(QString("MATRIX%1").arg(m_nextComponentId++));
+    
+    // Create graphics item
+    LedMatrixGraphicsItem* matrixGraphics = new LedMatrixGraphicsItem(backendMatrix);
+    matrixGraphics->setPos(snapToGrid(position));
+    
+    // Connect signals
+    connectComponentSignals(matrixGraphics);
+    
+    // Add to circuit and scene
+    m_undoStack->push(new AddComponentCommand(this, matrixGraphics));
+    
+    qDebug() << "Added" << rows << "x" << columns << "LED matrix at position" << position;
+    return matrixGraphics;
+}
+
+ComponentGraphicsItem* CircuitCanvas::addBreadboard(const QPointF& position, bool fullSize)
+{
+    if (!m_circuit) {
+        qWarning() << "Cannot add breadboard: no circuit set";
+        return nullptr;
+    }
+    
+    // Create backend board
+    Breadboard* backendBoard = new Breadboard(fullSize ? Breadboard::FullSize : Breadboard::HalfSize, m_circuit);
+    backendBoard->setName(QString("BB%1").arg(m_nextComponentId++));
+    
+    // Create graphics item
+    BreadboardGraphicsItem* boardGraphics = new BreadboardGraphicsItem(backendBoard);
+    boardGraphics->setPos(snapToGrid(position));
+    
+    // Connect signals
+    connectComponentSignals(boardGraphics);
+    
+    // Add to circuit and scene
+    m_undoStack->push(new AddComponentCommand(this, boardGraphics));
+    
+    qDebug() << "Added" << (fullSize ? "full-size" : "half-size") << "breadboard at position" << position;
+    return boardGraphics;
+}
+
+ComponentGraphicsItem* CircuitCanvas::addSampledSource(const QPointF& position, const QString& fileName,
+                                                       SampledSource::Mode mode)
+{
+    if (!m_circuit) {
+        qWarning() << "Cannot add sampled source: no circuit set";
+        return nullptr;
+    }
+    
+    // Create backend source; a file that fails to load is reported and
+    // the source is not added
+    SampledSource* backendSource = new SampledSource(mode, m_circuit);
+    if (!fileName.isEmpty() && !backendSource->load(fileName)) {
+        delete backendSource;
+        return nullptr;
+    }
+    backendSource->setName(QString("SRC%1").arg(m_nextComponentId++));
+    
+    // Create graphics item
+    SampledSourceGraphicsItem* sourceGraphics = new SampledSourceGraphicsItem(backendSource);
+    sourceGraphics->setPos(snapToGrid(position));
+    
+    // Connect signals
+    connectComponentSignals(sourceGraphics);
+    
+    // Add to circuit and scene
+    m_undoStack->push(new AddComponentCommand(this, sourceGraphics));
+    
+    qDebug() << "Added sampled source" << fileName << "at position" << position;
+    return sourceGraphics;
+}
+
 ComponentGraphicsItem* CircuitCanvas::addResistor(const QPointF& position, double resistance)
 {
     if (!m_circuit) {
@@ -128,9 +248,6 @@ ComponentGraphicsItem* CircuitCanvas::addArduino(const QPointF& position, Arduin
     // Create backend Arduino
     Arduino* backendArduino = new Arduino(boardType, m_circuit);
     
-    // Set circuit for Arduino (this adds all pins as components)
-    backendArduino->setCircuit(m_circuit);
-    
     // Create graphics item
     ArduinoGraphicsItem* arduinoGraphics = new ArduinoGraphicsItem(backendArduino);
     arduinoGraphics->setPos(snapToGrid(position));
@@ -138,9 +255,8 @@ ComponentGraphicsItem* CircuitCanvas::addArduino(const QPointF& position, Arduin
     // Connect signals
     connectComponentSignals(arduinoGraphics);
     
-    // Add to scene
-    addItem(arduinoGraphics);
-    m_componentItems.append(arduinoGraphics);
+    // Add to circuit (this adds all pins as components) and scene
+    m_undoStack->push(new AddComponentCommand(this, arduinoGraphics));
     
     qDebug() << "Added Arduino at position" << position;
     return arduinoGraphics;
@@ -152,21 +268,90 @@ void CircuitCanvas::removeComponent(ComponentGraphicsItem* component)
         return;
     }
     
-    // Remove any connected wires first
-    removeWiresConnectedTo(component);
+    // Connected wires are removed (and restored on undo) with the component
+    m_undoStack->push(new RemoveComponentCommand(this, component));
     
-    // Remove from backend circuit
-    Component* backendComponent = component->getBackendComponent();
-    if (backendComponent) {
-        m_circuit->removeComponent(backendComponent);
+    qDebug() << "Removed component";
+}
+
+void CircuitCanvas::removeWire(WireGraphicsItem* wire)
+{
+    if (!wire || !m_circuit || !m_wireItems.contains(wire)) {
+        return;
     }
     
-    // Remove from scene and tracking
-    m_componentItems.removeOne(component);
-    removeItem(component);
-    component->deleteLater();
+    m_undoStack->push(new RemoveWireCommand(this, wire));
     
-    qDebug() << "Removed component";
+    qDebug() << "Removed wire";
+}
+
+WireGraphicsItem* CircuitCanvas::addBus(ComponentGraphicsItem* start, int startTerminal,
+                                        ComponentGraphicsItem* end, int endTerminal, int width)
+{
+    if (!m_circuit || !start || !end || width < 1) {
+        qWarning() << "Cannot add bus: missing circuit or components";
+        return nullptr;
+    }
+    
+    if (!canConnectLines(start, startTerminal, width) || !canConnectLines(end, endTerminal, width)) {
+        qWarning() << "Cannot add" << width << "line bus: connection points missing or occupied";
+        return nullptr;
+    }
+    
+    WireGraphicsItem* bus = new WireGraphicsItem();
+    bus->setRoutingStyle(WireGraphicsItem::ORTHOGONAL);
+    bus->setBusWidth(width);
+    bus->connectToComponents(start, startTerminal, end, endTerminal);
+    connect(bus, &WireGraphicsItem::wireDoubleClicked,
+            this, &CircuitCanvas::onWireDoubleClicked);
+    
+    m_undoStack->push(new ConnectCommand(this, bus));
+    
+    qDebug() << "Added" << width << "line bus";
+    emit wireCreated(bus);
+    return bus;
+}
+
+void CircuitCanvas::setResistance(Resistor* resistor, double resistance)
+{
+    if (!resistor || resistance == resistor->getResistance()) {
+        return;
+    }
+    
+    m_undoStack->push(new SetResistanceCommand(resistor, resistance, m_stimulusRecorder));
+}
+
+UiDiagnostics* CircuitCanvas::getDiagnostics() const
+{
+    return m_diagnostics;
+}
+
+void CircuitCanvas::setDiagnostics(UiDiagnostics* diagnostics)
+{
+    m_diagnostics = diagnostics;
+}
+
+StimulusRecorder* CircuitCanvas::getStimulusRecorder() const
+{
+    return m_stimulusRecorder;
+}
+
+void CircuitCanvas::setStimulusRecorder(StimulusRecorder* recorder)
+{
+    m_stimulusRecorder = recorder;
+}
+
+void CircuitCanvas::undo()
+{
+    // Finish with any wire being drawn before touching the history
+    cancelWireDrawing();
+    m_undoStack->undo();
+}
+
+void CircuitCanvas::redo()
+{
+    cancelWireDrawing();
+    m_undoStack->redo();
 }
 
 // Wire drawing implementation
@@ -182,8 +367,8 @@ void CircuitCanvas::startWireDrawing(ComponentGraphicsItem* component, int termi
         return;
     }
     
-    // Check if connection point is already occupied
-    if (component->isConnectionPointOccupied(terminal)) {
+    // Check if connection points are already occupied
+    if (!canConnectLines(component, terminal, m_busWidth)) {
         qDebug() << "Connection point already occupied";
         return;
     }
@@ -197,6 +382,7 @@ void CircuitCanvas::startWireDrawing(ComponentGraphicsItem* component, int termi
     QPointF startPos = component->getConnectionPointPosition(terminal);
     m_currentWire = new WireGraphicsItem(startPos, startPos);
     m_currentWire->setRoutingStyle(WireGraphicsItem::ORTHOGONAL);
+    m_currentWire->setBusWidth(m_busWidth);
     addItem(m_currentWire);
     
     // Highlight the starting component
@@ -258,12 +444,14 @@ void CircuitCanvas::completeWireDrawing(ComponentGraphicsItem* endComponent, int
         // Validate connection
         if (endComponent == m_startComponent && endTerminal == m_startTerminal) {
             qDebug() << "Cannot connect component to itself";
-        } else if (endComponent->isConnectionPointOccupied(endTerminal)) {
+        } else if (!canConnectLines(endComponent, endTerminal, m_busWidth)) {
             qDebug() << "End connection point already occupied";
         } else {
-            // Create the electrical connection in backend
-            success = createBackendConnection(m_startComponent, m_startTerminal,
-                                            endComponent, endTerminal);
+            // Both ends need a backend terminal for every line
+            success = m_circuit && canConnectLines(m_startComponent, m_startTerminal, m_busWidth);
+            if (!success) {
+                qWarning() << "Cannot create backend connection: missing circuit or components";
+            }
         }
     }
     
@@ -277,9 +465,11 @@ void CircuitCanvas::completeWireDrawing(ComponentGraphicsItem* endComponent, int
         connect(permanentWire, &WireGraphicsItem::wireDoubleClicked,
                 this, &CircuitCanvas::onWireDoubleClicked);
         
-        m_wireItems.append(permanentWire);
         m_currentWire = nullptr;
         
+        // Create the electrical connection in backend
+        m_undoStack->push(new ConnectCommand(this, permanentWire));
+        
         qDebug() << "Wire drawing completed successfully";
         emit wireCreated(permanentWire);
     } else {
@@ -324,107 +514,133 @@ void CircuitCanvas::cancelWireDrawing()
     emit wireDrawingCancelled();
 }
 
-bool CircuitCanvas::createBackendConnection(ComponentGraphicsItem* comp1, int terminal1,
-                                          ComponentGraphicsItem* comp2, int terminal2)
+bool CircuitCanvas::resolveTerminal(ComponentGraphicsItem* item, int terminal,
+                                    Component*& component, int& backendTerminal) const
 {
-    if (!m_circuit || !comp1 || !comp2) {
-        qWarning() << "Cannot create backend connection: missing circuit or components";
+    component = nullptr;
+    backendTerminal = -1;
+    
+    if (!item || terminal < 0) {
         return false;
     }
     
-    Component* backendComp1 = nullptr;
-    Component* backendComp2 = nullptr;
-
-    ArduinoGraphicsItem* arduino1 = qobject_cast<ArduinoGraphicsItem*>(comp1);
-    if (arduino1) {
-        backendComp1 = arduino1->getBackendPin(terminal1);
-    } else {
-        backendComp1 = comp1->getBackendComponent();
-    }
-
-    // Get backend component for comp2  
-    ArduinoGraphicsItem* arduino2 = qobject_cast<ArduinoGraphicsItem*>(comp2);
-    if (arduino2) {
-        backendComp2 = arduino2->getBackendPin(terminal2);
+    // Each Arduino connection point is a separate single-terminal pin
+    ArduinoGraphicsItem* arduino = qobject_cast<ArduinoGraphicsItem*>(item);
+    BreadboardGraphicsItem* board = qobject_cast<BreadboardGraphicsItem*>(item);
+    if (arduino) {
+        component = arduino->getBackendPin(terminal);
+        backendTerminal = 0;
+    } else if (board) {
+        // Breadboard connection points are holes; the net is the hole's strip
+        component = board->getBackendBoard();
+        backendTerminal = board->getBackendBoard() ? board->getBackendBoard()->netTerminal(terminal) : -1;
+        if (backendTerminal < 0) {
+            return false;
+        }
     } else {
-        backendComp2 = comp2->getBackendComponent();
+        component = item->getBackendComponent();
+        backendTerminal = terminal;
     }
     
-    if (!backendComp1 || !backendComp2) {
-        qWarning() << "Cannot create backend connection: components have no backend";
+    return component && backendTerminal < component->getTerminalCount();
+}
+
+bool CircuitCanvas::resolveWireLines(WireGraphicsItem* wire, QVector<WireLine>& lines) const
+{
+    lines.clear();
+    if (!wire) {
         return false;
     }
     
-    // Get existing nodes if components are already connected
-    Node* node1 = backendComp1->getNode(terminal1);
-    Node* node2 = backendComp2->getNode(terminal2);
-    
-    Node* connectionNode = nullptr;
-    
-    if (!node1 && !node2) {
-        // Case 1: Neither component connected - create new node
-        connectionNode = m_circuit->createNode();
-        backendComp1->connectToNode(connectionNode, terminal1);
-        backendComp2->connectToNode(connectionNode, terminal2);
-        
-        qDebug() << "Created new node" << connectionNode->getId() 
-                 << "connecting" << backendComp1->getName() 
-                 << "to" << backendComp2->getName();
-        
-    } else if (node1 && !node2) {
-        // Case 2: First component already connected - use its node
-        connectionNode = node1;
-        backendComp2->connectToNode(connectionNode, terminal2);
-        
-        qDebug() << "Connected" << backendComp2->getName() 
-                 << "to existing node" << connectionNode->getId();
-        
-    } else if (!node1 && node2) {
-        // Case 3: Second component already connected - use its node
-        connectionNode = node2;
-        backendComp1->connectToNode(connectionNode, terminal1);
-        
-        qDebug() << "Connected" << backendComp1->getName() 
-                 << "to existing node" << connectionNode->getId();
-        
-    } else if (node1 == node2) {
-        // Case 4: Both connected to same node - already connected
-        qDebug() << "Components already connected via node" << node1->getId();
-        connectionNode = node1;
-        
-    } else {
-        // Case 5: Both connected to different nodes - merge nodes
-        connectionNode = node1;
-        
-        // Move all connections from node2 to node1
-        QVector<QPair<Component*, int>> connections = node2->getConnections();
-        for (const auto& conn : connections) {
-            conn.first->disconnectFromNode(conn.second);
-            conn.first->connectToNode(connectionNode, conn.second);
+    lines.reserve(wire->getBusWidth());
+    for (int line = 0; line < wire->getBusWidth(); ++line) {
+        WireLine wireLine;
+        if (!resolveTerminal(wire->getStartComponent(), wire->getStartTerminal(line),
+                             wireLine.start, wireLine.startTerminal)
+            || !resolveTerminal(wire->getEndComponent(), wire->getEndTerminal(line),
+                                wireLine.end, wireLine.endTerminal)) {
+            lines.clear();
+            return false;
         }
-        
-        // Remove the now-empty node2
-        m_circuit->removeNode(node2);
-        
-        qDebug() << "Merged nodes - now using node" << connectionNode->getId();
+        lines.append(wireLine);
     }
     
-    // Create backend wire component
-    Wire* backendWire = m_circuit->addWire(connectionNode, connectionNode);
-    if (backendWire && m_currentWire) {
-        m_currentWire->setBackendWire(backendWire);
+    return true;
+}
+
+bool CircuitCanvas::canConnectLines(ComponentGraphicsItem* item, int terminal, int width) const
+{
+    for (int line = 0; line < width; ++line) {
+        Component* component = nullptr;
+        int backendTerminal = -1;
+        if (!resolveTerminal(item, terminal + line, component, backendTerminal)
+            || item->isConnectionPointOccupied(terminal + line)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CircuitCanvas::attachComponentItem(ComponentGraphicsItem* item)
+{
+    if (item->scene() != this) {
+        addItem(item);
+    }
+    if (!m_componentItems.contains(item)) {
+        m_componentItems.append(item);
+    }
+}
+
+void CircuitCanvas::detachComponentItem(ComponentGraphicsItem* item)
+{
+    item->setHighlighted(false);
+    m_componentItems.removeOne(item);
+    if (item->scene() == this) {
+        removeItem(item);
+    }
+}
+
+void CircuitCanvas::attachWireItem(WireGraphicsItem* wire)
+{
+    if (wire->scene() != this) {
+        addItem(wire);
+    }
+    if (!m_wireItems.contains(wire)) {
+        m_wireItems.append(wire);
     }
     
-    // Update connection point states
-    comp1->setConnectionPointOccupied(terminal1, true);
-    comp2->setConnectionPointOccupied(terminal2, true);
+    wire->setEndsOccupied(true);
+}
+
+void CircuitCanvas::detachWireItem(WireGraphicsItem* wire)
+{
+    m_wireItems.removeOne(wire);
+    if (wire->scene() == this) {
+        removeItem(wire);
+    }
     
-    return true;
+    // The wire keeps its component references so it can be put back
+    wire->setEndsOccupied(false);
+}
+
+QVector<WireGraphicsItem*> CircuitCanvas::getWiresConnectedTo(ComponentGraphicsItem* component) const
+{
+    QVector<WireGraphicsItem*> wires;
+    for (WireGraphicsItem* wire : m_wireItems) {
+        if (wire->getStartComponent() == component || wire->getEndComponent() == component) {
+            wires.append(wire);
+        }
+    }
+    return wires;
 }
 
 // Mouse event handling
 void CircuitCanvas::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
+    if (m_diagnostics) {
+        m_diagnostics->markInput();
+    }
+
     if (event->button() == Qt::LeftButton) {
         if (m_drawingState == DRAWING_WIRE) {
             // Check if clicking on a valid connection point
@@ -473,6 +689,22 @@ void CircuitCanvas::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
 
 void CircuitCanvas::keyPressEvent(QKeyEvent* event)
 {
+    if (m_diagnostics) {
+        m_diagnostics->markInput();
+    }
+
+    if (event->matches(QKeySequence::Undo)) {
+        undo();
+        event->accept();
+        return;
+    }
+    
+    if (event->matches(QKeySequence::Redo)) {
+        redo();
+        event->accept();
+        return;
+    }
+    
     switch (event->key()) {
         case Qt::Key_Escape:
             if (m_drawingState == DRAWING_WIRE) {
@@ -499,6 +731,22 @@ void CircuitCanvas::keyPressEvent(QKeyEvent* event)
     QGraphicsScene::keyPressEvent(event);
 }
 
+void CircuitCanvas::drawBackground(QPainter* painter, const QRectF& rect)
+{
+    if (m_diagnostics) {
+        m_diagnostics->beginFrame();
+    }
+    QGraphicsScene::drawBackground(painter, rect);
+}
+
+void CircuitCanvas::drawForeground(QPainter* painter, const QRectF& rect)
+{
+    QGraphicsScene::drawForeground(painter, rect);
+    if (m_diagnostics) {
+        m_diagnostics->endFrame();
+    }
+}
+
 // Helper methods
 void CircuitCanvas::findSnapTarget(const QPointF& pos, ComponentGraphicsItem*& component, int& terminal)
 {
@@ -511,17 +759,12 @@ void CircuitCanvas::findSnapTarget(const QPointF& pos, ComponentGraphicsItem*& c
     for (ComponentGraphicsItem* comp : m_componentItems) {
         if (comp == m_startComponent) continue; // Skip starting component
         
-        for (int i = 0; i < comp->getConnectionPointCount(); ++i) {
-            if (comp->isConnectionPointOccupied(i)) continue; // Skip occupied points
-            
-            QPointF pointPos = comp->getConnectionPointPosition(i);
-            qreal distance = QLineF(pos, pointPos).length();
-            
-            if (distance < minDistance) {
-                minDistance = distance;
-                component = comp;
-                terminal = i;
-            }
+        qreal distance = minDistance;
+        int point = comp->findFreeConnectionPoint(pos, minDistance, &distance);
+        if (point >= 0) {
+            minDistance = distance;
+            component = comp;
+            terminal = point;
         }
     }
 }
@@ -573,38 +816,32 @@ void CircuitCanvas::connectComponentSignals(ComponentGraphicsItem* component)
             this, &CircuitCanvas::onComponentMoved);
 }
 
-void CircuitCanvas::removeWiresConnectedTo(ComponentGraphicsItem* component)
-{
-    // Find and remove all wires connected to this component
-    for (int i = m_wireItems.size() - 1; i >= 0; --i) {
-        WireGraphicsItem* wire = m_wireItems[i];
-        if (wire->getStartComponent() == component || wire->getEndComponent() == component) {
-            m_wireItems.removeAt(i);
-            removeItem(wire);
-            wire->deleteLater();
-        }
-    }
-}
-
 void CircuitCanvas::deleteSelectedItems()
 {
     QList<QGraphicsItem*> selected = selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
+    
+    // One undo step for the whole selection. Wires go first so that a wire
+    // removed together with its component is only recorded once.
+    m_undoStack->beginMacro("Delete");
     
     for (QGraphicsItem* item : selected) {
-        ComponentGraphicsItem* comp = qgraphicsitem_cast<ComponentGraphicsItem*>(item);
-        if (comp) {
-            removeComponent(comp);
-            continue;
-        }
-        
         WireGraphicsItem* wire = qgraphicsitem_cast<WireGraphicsItem*>(item);
         if (wire) {
-            m_wireItems.removeOne(wire);
-            removeItem(wire);
-            wire->deleteLater();
-            continue;
+            removeWire(wire);
+        }
+    }
+    
+    for (QGraphicsItem* item : selected) {
+        ComponentGraphicsItem* comp = qgraphicsitem_cast<ComponentGraphicsItem*>(item);
+        if (comp && m_componentItems.contains(comp)) {
+            removeComponent(comp);
         }
     }
+    
+    m_undoStack->endMacro();
 }
 
 void CircuitCanvas::showContextMenu(const QPointF& scenePos, const QPoint& screenPos)
@@ -616,13 +853,51 @@ void CircuitCanvas::showContextMenu(const QPointF& scenePos, const QPoint& scree
     addMenu->addAction("LED", [this, scenePos]() {
         addLED(scenePos, Qt::red);
     });
+    addMenu->addAction("LED Strip (WS2812)", [this, scenePos]() {
+        addLedStrip(scenePos, 60);
+    });
+    addMenu->addAction("LED Matrix (8x8)", [this, scenePos]() {
+        addLedMatrix(scenePos, 8, 8, Qt::red);
+    });
+    addMenu->addAction("Breadboard (Full Size)", [this, scenePos]() {
+        addBreadboard(scenePos, true);
+    });
+    addMenu->addAction("Breadboard (Half Size)", [this, scenePos]() {
+        addBreadboard(scenePos, false);
+    });
     addMenu->addAction("Resistor", [this, scenePos]() {
         addResistor(scenePos, 1000.0);
     });
+    addMenu->addAction("Sensor Recording (Voltage)...", [this, scenePos]() {
+        QString fileName = QFileDialog::getOpenFileName(nullptr, "Open Sensor Recording", QString(),
+                                                        "Sample files (*.csv *.txt *.bin *.dat *.raw)");
+        if (!fileName.isEmpty()) {
+            addSampledSource(scenePos, fileName, SampledSource::VoltageSource);
+        }
+    });
+    addMenu->addAction("Sensor Recording (Resistance)...", [this, scenePos]() {
+        QString fileName = QFileDialog::getOpenFileName(nullptr, "Open Sensor Recording", QString(),
+                                                        "Sample files (*.csv *.txt *.bin *.dat *.raw)");
+        if (!fileName.isEmpty()) {
+            addSampledSource(scenePos, fileName, SampledSource::VariableResistor);
+        }
+    });
     addMenu->addAction("Arduino Uno", [this, scenePos]() {
         addArduino(scenePos, Arduino::UNO);
     });
     
+    // Lines per drawn wire
+    QMenu* busMenu = contextMenu.addMenu("Wire Width");
+    for (int width : {1, 4, 8, 16}) {
+        QAction* widthAction = busMenu->addAction(width == 1 ? QString("Single Wire")
+                                                             : QString("%1-Line Bus").arg(width));
+        widthAction->setCheckable(true);
+        widthAction->setChecked(m_busWidth == width);
+        connect(widthAction, &QAction::triggered, this, [this, width]() {
+            setBusWidth(width);
+        });
+    }
+    
     // View options
     contextMenu.addSeparator();
     QAction* gridAction = contextMenu.addAction("Show Grid");
@@ -0,0 +1,497 @@
+#include "ui/CircuitCommands.h"
+#include "ui/CircuitCanvas.h"
+#include "ui/ComponentGraphicsItem.h"
+#include "ui/ArduinoGraphicsItem.h"
+#include "ui/WireGraphicsItem.h"
+#include "simulation/Circuit.h"
+#include "simulation/Node.h"
+#include "simulation/StimulusRecorder.h"
+#include "core/Component.h"
+#include "core/Resistor.h"
+#include "core/Arduino.h"
+#include "core/ArduinoPin.h"
+#include <QSet>
+#include <QHash>
+#include <QQueue>
+#include <QDebug>
+
+namespace {
+
+// Backend components behind a graphics item
+QVector<Component*> backendComponents(ComponentGraphicsItem* item)
+{
+    QVector<Component*> components;
+
+    ArduinoGraphicsItem* arduinoItem = qobject_cast<ArduinoGraphicsItem*>(item);
+    if (arduinoItem) {
+        if (arduinoItem->getBackendArduino()) {
+            for (ArduinoPin* pin : arduinoItem->getBackendArduino()->getAllPins()) {
+                components.append(pin);
+            }
+        }
+    } else if (item->getBackendComponent()) {
+        components.append(item->getBackendComponent());
+    }
+
+    return components;
+}
+
+// Object that owns the backend of a graphics item (the Arduino owns its pins)
+QObject* backendOwner(ComponentGraphicsItem* item)
+{
+    ArduinoGraphicsItem* arduinoItem = qobject_cast<ArduinoGraphicsItem*>(item);
+    if (arduinoItem) {
+        return arduinoItem->getBackendArduino();
+    }
+    return item->getBackendComponent();
+}
+
+void attachBackend(Circuit* circuit, ComponentGraphicsItem* item)
+{
+    ArduinoGraphicsItem* arduinoItem = qobject_cast<ArduinoGraphicsItem*>(item);
+    if (arduinoItem && arduinoItem->getBackendArduino()) {
+        arduinoItem->getBackendArduino()->setCircuit(circuit);
+        return;
+    }
+
+    if (item->getBackendComponent()) {
+        circuit->addComponent(item->getBackendComponent());
+    }
+}
+
+void detachBackend(Circuit* circuit, ComponentGraphicsItem* item)
+{
+    for (Component* component : backendComponents(item)) {
+        circuit->detachComponent(component);
+    }
+}
+
+QVector<QPair<Component*, int>> connectionsOf(Component* component, int terminal)
+{
+    Node* node = component->getNode(terminal);
+    return node ? node->getConnections() : QVector<QPair<Component*, int>>();
+}
+
+// Node that a captured terminal should go back to
+Node* findLinkNode(Circuit* circuit, const TerminalLink& link)
+{
+    if (link.ground) {
+        return circuit->getGroundNode();
+    }
+
+    for (const auto& peer : link.peers) {
+        Node* node = peer.first->getNode(peer.second);
+        if (node) {
+            return node;
+        }
+    }
+
+    return circuit->createNode();
+}
+
+template <typename T>
+void deleteOwned(QPointer<T>& object)
+{
+    if (object) {
+        delete object.data();
+    }
+}
+
+}
+
+// AddComponentCommand
+
+AddComponentCommand::AddComponentCommand(CircuitCanvas* canvas, ComponentGraphicsItem* item,
+                                         QUndoCommand* parent)
+    : QUndoCommand(parent)
+    , m_canvas(canvas)
+    , m_item(item)
+    , m_attached(false)
+{
+    m_backend.append(backendOwner(item));
+    setText(QString("Add %1").arg(item->getComponentType()));
+}
+
+AddComponentCommand::~AddComponentCommand()
+{
+    if (!m_attached) {
+        deleteOwned(m_item);
+        for (QPointer<QObject>& object : m_backend) {
+            deleteOwned(object);
+        }
+    }
+}
+
+void AddComponentCommand::redo()
+{
+    if (!m_item) {
+        return;
+    }
+
+    attachBackend(m_canvas->getCircuit(), m_item);
+    m_canvas->attachComponentItem(m_item);
+    m_attached = true;
+}
+
+void AddComponentCommand::undo()
+{
+    if (!m_item) {
+        return;
+    }
+
+    m_canvas->detachComponentItem(m_item);
+    detachBackend(m_canvas->getCircuit(), m_item);
+    m_attached = false;
+}
+
+// RemoveComponentCommand
+
+RemoveComponentCommand::RemoveComponentCommand(CircuitCanvas* canvas, ComponentGraphicsItem* item,
+                                               QUndoCommand* parent)
+    : QUndoCommand(parent)
+    , m_canvas(canvas)
+    , m_item(item)
+    , m_removed(false)
+{
+    m_backend.append(backendOwner(item));
+    setText(QString("Remove %1").arg(item->getComponentName()));
+}
+
+RemoveComponentCommand::~RemoveComponentCommand()
+{
+    if (m_removed) {
+        // Wires reference the component, so they go first
+        for (QPointer<WireGraphicsItem>& wire : m_wires) {
+            deleteOwned(wire);
+        }
+        deleteOwned(m_item);
+        for (QPointer<QObject>& object : m_backend) {
+            deleteOwned(object);
+        }
+    }
+}
+
+void RemoveComponentCommand::redo()
+{
+    if (!m_item) {
+        return;
+    }
+
+    Circuit* circuit = m_canvas->getCircuit();
+
+    // Capture how every terminal is connected so undo can rebuild it
+    m_links.clear();
+    for (Component* component : backendComponents(m_item)) {
+        for (int i = 0; i < component->getTerminalCount(); ++i) {
+            Node* node = component->getNode(i);
+            if (!node) {
+                continue;
+            }
+
+            TerminalLink link;
+            link.component = component;
+            link.terminal = i;
+            link.ground = (node == circuit->getGroundNode());
+            for (const auto& connection : node->getConnections()) {
+                if (connection.first != component || connection.second != i) {
+                    link.peers.append(connection);
+                }
+            }
+            m_links.append(link);
+        }
+    }
+
+    m_wires.clear();
+    for (WireGraphicsItem* wire : m_canvas->getWiresConnectedTo(m_item)) {
+        m_wires.append(wire);
+        m_canvas->detachWireItem(wire);
+    }
+
+    m_canvas->detachComponentItem(m_item);
+    detachBackend(circuit, m_item);
+    m_removed = true;
+}
+
+void RemoveComponentCommand::undo()
+{
+    if (!m_item) {
+        return;
+    }
+
+    Circuit* circuit = m_canvas->getCircuit();
+
+    attachBackend(circuit, m_item);
+    for (const TerminalLink& link : m_links) {
+        circuit->connectComponentToNode(link.component, link.terminal, findLinkNode(circuit, link));
+    }
+
+    m_canvas->attachComponentItem(m_item);
+    for (QPointer<WireGraphicsItem>& wire : m_wires) {
+        if (wire) {
+            m_canvas->attachWireItem(wire);
+        }
+    }
+    m_removed = false;
+}
+
+// ConnectCommand
+
+ConnectCommand::ConnectCommand(CircuitCanvas* canvas, WireGraphicsItem* wire,
+                               QUndoCommand* parent)
+    : QUndoCommand(parent)
+    , m_canvas(canvas)
+    , m_wire(wire)
+    , m_connected(false)
+{
+    setText(wire->isBus() ? QString("Connect %1-Line Bus").arg(wire->getBusWidth()) : QString("Connect"));
+}
+
+ConnectCommand::~ConnectCommand()
+{
+    if (!m_connected) {
+        deleteOwned(m_wire);
+    }
+}
+
+void ConnectCommand::redo()
+{
+    QVector<CircuitCanvas::WireLine> lines;
+    if (!m_wire || !m_canvas->resolveWireLines(m_wire, lines)) {
+        return;
+    }
+
+    Circuit* circuit = m_canvas->getCircuit();
+
+    // All lines of a bus are one topology change
+    circuit->beginUpdate();
+    m_lines.clear();
+    for (const CircuitCanvas::WireLine& line : lines) {
+        // Record both sides so undo can split a merged node again
+        Node* startNode = line.start->getNode(line.startTerminal);
+        Node* endNode = line.end->getNode(line.endTerminal);
+
+        LineState state;
+        state.alreadyConnected = startNode && startNode == endNode;
+        state.endWasGround = endNode && endNode == circuit->getGroundNode();
+        state.startPeers = connectionsOf(line.start, line.startTerminal);
+        state.endPeers = connectionsOf(line.end, line.endTerminal);
+        m_lines.append(state);
+
+        if (!state.alreadyConnected) {
+            circuit->connectComponents(line.start, line.startTerminal, line.end, line.endTerminal);
+        }
+    }
+    circuit->endUpdate();
+
+    m_canvas->attachWireItem(m_wire);
+    m_connected = true;
+}
+
+void ConnectCommand::undo()
+{
+    QVector<CircuitCanvas::WireLine> lines;
+    if (!m_wire || !m_canvas->resolveWireLines(m_wire, lines) || lines.size() != m_lines.size()) {
+        return;
+    }
+
+    Circuit* circuit = m_canvas->getCircuit();
+
+    // Lines are taken apart in the reverse order they were joined
+    circuit->beginUpdate();
+    for (int index = lines.size() - 1; index >= 0; --index) {
+        const CircuitCanvas::WireLine& line = lines[index];
+        const LineState& state = m_lines[index];
+        if (state.alreadyConnected) {
+            continue;
+        }
+
+        if (!state.startPeers.isEmpty() && !state.endPeers.isEmpty()) {
+            // Two nodes were merged: move the side whose node was dropped
+            // (never the ground side) onto a fresh node
+            const QVector<QPair<Component*, int>>& split = state.endWasGround ? state.startPeers : state.endPeers;
+            Node* node = circuit->createNode();
+            for (const auto& peer : split) {
+                circuit->disconnectComponent(peer.first, peer.second);
+                circuit->connectComponentToNode(peer.first, peer.second, node);
+            }
+        }
+
+        // Terminals that were unconnected before go back to unconnected
+        if (state.startPeers.isEmpty()) {
+            circuit->disconnectComponent(line.start, line.startTerminal);
+        }
+        if (state.endPeers.isEmpty()) {
+            circuit->disconnectComponent(line.end, line.endTerminal);
+        }
+    }
+    circuit->endUpdate();
+
+    m_canvas->detachWireItem(m_wire);
+    m_connected = false;
+}
+
+// RemoveWireCommand
+
+RemoveWireCommand::RemoveWireCommand(CircuitCanvas* canvas, WireGraphicsItem* wire,
+                                     QUndoCommand* parent)
+    : QUndoCommand(parent)
+    , m_canvas(canvas)
+    , m_wire(wire)
+    , m_removed(false)
+{
+    setText(wire->isBus() ? QString("Remove %1-Line Bus").arg(wire->getBusWidth()) : QString("Remove Wire"));
+}
+
+RemoveWireCommand::~RemoveWireCommand()
+{
+    if (m_removed) {
+        deleteOwned(m_wire);
+    }
+}
+
+void RemoveWireCommand::redo()
+{
+    if (!m_wire) {
+        return;
+    }
+
+    m_canvas->detachWireItem(m_wire);
+    m_removed = true;
+    m_splitLines.clear();
+
+    QVector<CircuitCanvas::WireLine> lines;
+    if (!m_canvas->resolveWireLines(m_wire, lines)) {
+        return;
+    }
+    m_splitLines.fill(false, lines.size());
+
+    // Every line of the remaining wires and buses is an edge, indexed by
+    // both of its terminals so each walk step only visits its own edges
+    typedef QPair<Component*, int> Terminal;
+    QHash<Terminal, QVector<Terminal>> adjacency;
+    QVector<CircuitCanvas::WireLine> wireLines;
+    for (WireGraphicsItem* wire : m_canvas->getWires()) {
+        if (m_canvas->resolveWireLines(wire, wireLines)) {
+            for (const CircuitCanvas::WireLine& line : wireLines) {
+                Terminal start(line.start, line.startTerminal);
+                Terminal end(line.end, line.endTerminal);
+                adjacency[start].append(end);
+                adjacency[end].append(start);
+            }
+        }
+    }
+
+    Circuit* circuit = m_canvas->getCircuit();
+    circuit->beginUpdate();
+
+    for (int index = 0; index < lines.size(); ++index) {
+        const CircuitCanvas::WireLine& line = lines[index];
+        Node* node = line.start->getNode(line.startTerminal);
+        if (!node || node != line.end->getNode(line.endTerminal)) {
+            continue;
+        }
+
+        // Walk the remaining wires from the end terminal; if they don't lead
+        // back to the start terminal, the terminals they reach get their own node
+        QSet<Terminal> reached;
+        QQueue<Terminal> queue;
+        reached.insert(Terminal(line.end, line.endTerminal));
+        queue.enqueue(Terminal(line.end, line.endTerminal));
+
+        while (!queue.isEmpty()) {
+            const QVector<Terminal> neighbours = adjacency.value(queue.dequeue());
+            for (const Terminal& other : neighbours) {
+                if (!reached.contains(other)) {
+                    reached.insert(other);
+                    queue.enqueue(other);
+                }
+            }
+        }
+
+        if (reached.contains(Terminal(line.start, line.startTerminal))) {
+            continue;
+        }
+
+        Node* splitNode = circuit->createNode();
+        for (const Terminal& terminal : reached) {
+            if (terminal.first->getNode(terminal.second) == node) {
+                circuit->disconnectComponent(terminal.first, terminal.second);
+                circuit->connectComponentToNode(terminal.first, terminal.second, splitNode);
+            }
+        }
+        m_splitLines[index] = true;
+    }
+
+    circuit->endUpdate();
+}
+
+void RemoveWireCommand::undo()
+{
+    if (!m_wire) {
+        return;
+    }
+
+    QVector<CircuitCanvas::WireLine> lines;
+    if (m_splitLines.contains(true) && m_canvas->resolveWireLines(m_wire, lines)) {
+        Circuit* circuit = m_canvas->getCircuit();
+        circuit->beginUpdate();
+        for (int index = 0; index < lines.size() && index < m_splitLines.size(); ++index) {
+            if (m_splitLines[index]) {
+                const CircuitCanvas::WireLine& line = lines[index];
+                circuit->connectComponents(line.start, line.startTerminal, line.end, line.endTerminal);
+            }
+        }
+        circuit->endUpdate();
+    }
+
+    m_canvas->attachWireItem(m_wire);
+    m_removed = false;
+}
+
+// SetResistanceCommand
+
+SetResistanceCommand::SetResistanceCommand(Resistor* resistor, double resistance,
+                                           StimulusRecorder* recorder, QUndoCommand* parent)
+    : QUndoCommand(parent)
+    , m_resistor(resistor)
+    , m_recorder(recorder)
+    , m_oldResistance(resistor->getResistance())
+    , m_newResistance(resistance)
+{
+    setText(QString("Set %1 resistance").arg(resistor->getName()));
+}
+
+void SetResistanceCommand::redo()
+{
+    apply(m_newResistance);
+}
+
+void SetResistanceCommand::undo()
+{
+    apply(m_oldResistance);
+}
+
+void SetResistanceCommand::apply(double resistance)
+{
+    if (!m_resistor) {
+        return;
+    }
+    
+    // Undo and redo change the circuit too, so they are recorded as well
+    if (m_recorder) {
+        m_recorder->setResistance(m_resistor, resistance);
+    } else {
+        m_resistor->setResistance(resistance);
+    }
+}
+
+bool SetResistanceCommand::mergeWith(const QUndoCommand* other)
+{
+    const SetResistanceCommand* edit = static_cast<const SetResistanceCommand*>(other);
+    if (edit->m_resistor != m_resistor) {
+        return false;
+    }
+
+    m_newResistance = edit->m_newResistance;
+    return true;
+}
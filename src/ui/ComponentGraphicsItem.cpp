@@ -41,6 +41,27 @@ ComponentGraphicsItem::ConnectionPoint& ComponentGraphicsItem::getConnectionPoin
     return invalidPoint;
 }
 
+int ComponentGraphicsItem::findFreeConnectionPoint(const QPointF& scenePos, qreal radius, qreal* distance) const
+{
+    int nearest = -1;
+    qreal nearestDistance = radius;
+
+    for (int i = 0; i < getConnectionPointCount(); ++i) {
+        if (isConnectionPointOccupied(i)) continue;
+
+        qreal pointDistance = QLineF(scenePos, getConnectionPointPosition(i)).length();
+        if (pointDistance < nearestDistance) {
+            nearestDistance = pointDistance;
+            nearest = i;
+        }
+    }
+
+    if (distance) {
+        *distance = nearestDistance;
+    }
+    return nearest;
+}
+
 QString ComponentGraphicsItem::getComponentId() const
 {
     Component* component = getBackendComponent();
@@ -1,5 +1,6 @@
 #include "ui/LEDGraphicsItem.h"
 #include "core/LED.h"
+#include "ui/UiDiagnostics.h"
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
 #include <QFont>
@@ -15,6 +16,8 @@ LEDGraphicsItem::LEDGraphicsItem(LED* backendLED, QGraphicsItem* parent)
     , m_isOn(false)
     , m_brightness(0.0)
     , m_currentColor(Qt::gray)
+    , m_overloadIndicator(false)
+    , m_stateDirty(false)
 {
     if (!m_backendLED) {
         qWarning() << "LEDGraphicsItem created with null backend LED";
@@ -64,6 +67,14 @@ void LEDGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* o
     Q_UNUSED(option)
     Q_UNUSED(widget)
     
+    PaintTimer paintTimer(this, UiDiagnostics::LedItem);
+    if (m_stateDirty) {
+        m_stateDirty = false;
+        if (UiDiagnostics* diagnostics = UiDiagnostics::forItem(this)) {
+            diagnostics->ledRepainted();
+        }
+    }
+    
     painter->setRenderHint(QPainter::Antialiasing);
     
     // LED body dimensions
@@ -249,6 +260,7 @@ void LEDGraphicsItem::onLEDStateChanged(bool isOn, double brightness)
     m_brightness = brightness;
     
     if (needsUpdate) {
+        m_stateDirty = true;
         updateVisualState();
     }
 }
@@ -0,0 +1,207 @@
+#include "ui/LedMatrixGraphicsItem.h"
+#include "ui/UiDiagnostics.h"
+#include "core/LedMatrix.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QFont>
+#include <QPen>
+#include <QBrush>
+#include <QtMath>
+#include <QDebug>
+
+LedMatrixGraphicsItem::LedMatrixGraphicsItem(LedMatrix* backendMatrix, QGraphicsItem* parent)
+    : ComponentGraphicsItem(parent)
+    , m_backendMatrix(backendMatrix)
+    , m_imageDirty(true)
+{
+    if (!m_backendMatrix) {
+        qWarning() << "LedMatrixGraphicsItem created with null backend matrix";
+        return;
+    }
+
+    setFlag(QGraphicsItem::ItemIsMovable, true);
+    setFlag(QGraphicsItem::ItemIsSelectable, true);
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+
+    m_image = QImage(m_backendMatrix->getColumns(), m_backendMatrix->getRows(), QImage::Format_RGB32);
+    m_image.fill(Qt::black);
+
+    setupConnectionPoints();
+
+    connect(m_backendMatrix, &LedMatrix::matrixChanged,
+            this, &LedMatrixGraphicsItem::onMatrixChanged);
+
+    qDebug() << "Created LedMatrixGraphicsItem for" << m_backendMatrix->getName()
+             << m_backendMatrix->getRows() << "x" << m_backendMatrix->getColumns();
+}
+
+QRectF LedMatrixGraphicsItem::diodeArea() const
+{
+    return QRectF(0, 0, m_image.width() * CellSize, m_image.height() * CellSize);
+}
+
+QRectF LedMatrixGraphicsItem::boundingRect() const
+{
+    // Diode area plus frame, row terminals on the left, column terminals
+    // on top and the label below
+    return diodeArea().adjusted(-16, -16, 4, 20);
+}
+
+void LedMatrixGraphicsItem::refreshImage()
+{
+    // Unlit diodes show a dim version of the color, like the LED item
+    const QColor color = m_backendMatrix->getColor();
+    const int offRed = color.red() / 6;
+    const int offGreen = color.green() / 6;
+    const int offBlue = color.blue() / 6;
+
+    const double* brightness = m_backendMatrix->getBrightness().constData();
+    for (int row = 0; row < m_image.height(); ++row) {
+        QRgb* line = reinterpret_cast<QRgb*>(m_image.scanLine(row));
+        for (int column = 0; column < m_image.width(); ++column) {
+            double b = brightness[row * m_image.width() + column];
+            line[column] = qRgb(offRed + qRound((color.red() - offRed) * b),
+                                offGreen + qRound((color.green() - offGreen) * b),
+                                offBlue + qRound((color.blue() - offBlue) * b));
+        }
+    }
+    m_imageDirty = false;
+}
+
+void LedMatrixGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    PaintTimer paintTimer(this, UiDiagnostics::LedItem);
+    if (m_imageDirty) {
+        refreshImage();
+        if (UiDiagnostics* diagnostics = UiDiagnostics::forItem(this)) {
+            diagnostics->ledRepainted();
+        }
+    }
+
+    const QRectF area = diodeArea();
+
+    // Module body
+    painter->setPen(QPen(Qt::black, 2));
+    painter->setBrush(QBrush(QColor(30, 30, 30)));
+    painter->drawRect(area.adjusted(-2, -2, 2, 2));
+
+    // All diodes in one call; each image pixel scales to one cell
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(area, m_image);
+
+    // Terminals
+    painter->setRenderHint(QPainter::Antialiasing);
+    for (const ConnectionPoint& point : m_connectionPoints) {
+        drawConnectionPoint(painter, point, point.isOccupied);
+    }
+
+    // Label
+    painter->setPen(QPen(Qt::black, 1));
+    QFont labelFont("Arial", 7);
+    painter->setFont(labelFont);
+    QString label = QString("%1 (%2x%3)").arg(m_backendMatrix->getName())
+                                         .arg(m_backendMatrix->getRows())
+                                         .arg(m_backendMatrix->getColumns());
+    painter->drawText(QRectF(area.left(), area.bottom() + 4, area.width(), 14), Qt::AlignCenter, label);
+
+    if (isSelected()) {
+        drawSelectionIndicator(painter, boundingRect());
+    }
+}
+
+void LedMatrixGraphicsItem::setupConnectionPoints()
+{
+    m_connectionPoints.clear();
+
+    const QRectF area = diodeArea();
+    const qreal half = CellSize / 2.0;
+
+    // Rows (anodes) on the left edge, columns (cathodes) along the top
+    for (int row = 0; row < m_backendMatrix->getRows(); ++row) {
+        ConnectionPoint point;
+        point.position = QPointF(area.left() - 10, area.top() + row * CellSize + half);
+        point.terminalIndex = m_backendMatrix->rowTerminal(row);
+        point.isOccupied = false;
+        point.connectedNode = nullptr;
+        point.direction = ConnectionDirection::LEFT;
+        m_connectionPoints.append(point);
+    }
+    for (int column = 0; column < m_backendMatrix->getColumns(); ++column) {
+        ConnectionPoint point;
+        point.position = QPointF(area.left() + column * CellSize + half, area.top() - 10);
+        point.terminalIndex = m_backendMatrix->columnTerminal(column);
+        point.isOccupied = false;
+        point.connectedNode = nullptr;
+        point.direction = ConnectionDirection::UP;
+        m_connectionPoints.append(point);
+    }
+}
+
+Component* LedMatrixGraphicsItem::getBackendComponent() const
+{
+    return m_backendMatrix;
+}
+
+QString LedMatrixGraphicsItem::getComponentType() const
+{
+    return "LedMatrix";
+}
+
+QPointF LedMatrixGraphicsItem::getConnectionPointPosition(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return mapToScene(m_connectionPoints[index].position);
+    }
+    return QPointF();
+}
+
+bool LedMatrixGraphicsItem::isConnectionPointOccupied(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return m_connectionPoints[index].isOccupied;
+    }
+    return false;
+}
+
+void LedMatrixGraphicsItem::setConnectionPointOccupied(int index, bool occupied)
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        m_connectionPoints[index].isOccupied = occupied;
+        update();
+    }
+}
+
+int LedMatrixGraphicsItem::getConnectionPointAt(const QPointF& scenePos) const
+{
+    // Terminals sit one cell apart, so the capture radius is smaller than
+    // for discrete parts
+    const qreal connectionRadius = CellSize / 2.0;
+
+    for (int i = 0; i < m_connectionPoints.size(); ++i) {
+        QPointF pointPos = mapToScene(m_connectionPoints[i].position);
+        if (QLineF(pointPos, scenePos).length() <= connectionRadius) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void LedMatrixGraphicsItem::onMatrixChanged()
+{
+    // Several solver steps between two paints collapse into one refresh
+    m_imageDirty = true;
+    update(diodeArea());
+}
+
+QVariant LedMatrixGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemPositionChange) {
+        emit componentMoved(this);
+    }
+
+    return ComponentGraphicsItem::itemChange(change, value);
+}
@@ -0,0 +1,201 @@
+#include "ui/LedStripGraphicsItem.h"
+#include "ui/UiDiagnostics.h"
+#include "core/LedStrip.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QFont>
+#include <QPen>
+#include <QBrush>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+LedStripGraphicsItem::LedStripGraphicsItem(LedStrip* backendStrip, QGraphicsItem* parent)
+    : ComponentGraphicsItem(parent)
+    , m_backendStrip(backendStrip)
+    , m_imageDirty(true)
+{
+    if (!m_backendStrip) {
+        qWarning() << "LedStripGraphicsItem created with null backend strip";
+        return;
+    }
+
+    setFlag(QGraphicsItem::ItemIsMovable, true);
+    setFlag(QGraphicsItem::ItemIsSelectable, true);
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+
+    int columns = qMin(Columns, m_backendStrip->getPixelCount());
+    int rows = (m_backendStrip->getPixelCount() + Columns - 1) / Columns;
+    m_image = QImage(columns, rows, QImage::Format_RGB32);
+    m_image.fill(Qt::black);
+
+    setupConnectionPoints();
+
+    connect(m_backendStrip, &LedStrip::pixelsChanged,
+            this, &LedStripGraphicsItem::onPixelsChanged);
+
+    qDebug() << "Created LedStripGraphicsItem for" << m_backendStrip->getName()
+             << "with" << m_backendStrip->getPixelCount() << "pixels";
+}
+
+QRectF LedStripGraphicsItem::pixelArea() const
+{
+    return QRectF(0, 0, m_image.width() * CellSize, m_image.height() * CellSize);
+}
+
+QRectF LedStripGraphicsItem::boundingRect() const
+{
+    // Pixel area plus frame, terminals on all four sides and the label
+    return pixelArea().adjusted(-16, -16, 16, 28);
+}
+
+void LedStripGraphicsItem::refreshImage()
+{
+    // Packed 0xffRRGGBB is the RGB32 layout; copy whole rows
+    const QVector<QRgb> &pixels = m_backendStrip->getPixels();
+    int remaining = pixels.size();
+    for (int row = 0; row < m_image.height(); ++row) {
+        int count = qMin(remaining, m_image.width());
+        QRgb *line = reinterpret_cast<QRgb*>(m_image.scanLine(row));
+        std::memcpy(line, pixels.constData() + row * m_image.width(), count * sizeof(QRgb));
+        std::fill(line + count, line + m_image.width(), qRgb(0, 0, 0));
+        remaining -= count;
+    }
+    m_imageDirty = false;
+}
+
+void LedStripGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    PaintTimer paintTimer(this, UiDiagnostics::LedItem);
+    if (m_imageDirty) {
+        refreshImage();
+        if (UiDiagnostics* diagnostics = UiDiagnostics::forItem(this)) {
+            diagnostics->ledRepainted();
+        }
+    }
+
+    const QRectF area = pixelArea();
+
+    // Strip body
+    painter->setPen(QPen(Qt::black, 2));
+    painter->setBrush(QBrush(QColor(30, 30, 30)));
+    painter->drawRect(area.adjusted(-4, -4, 4, 4));
+
+    // All pixels in one call; each image pixel scales to one cell
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(area, m_image);
+
+    // Terminals
+    painter->setRenderHint(QPainter::Antialiasing);
+    for (const ConnectionPoint& point : m_connectionPoints) {
+        drawConnectionPoint(painter, point, point.isOccupied);
+    }
+
+    // Label
+    painter->setPen(QPen(Qt::black, 1));
+    QFont labelFont("Arial", 7);
+    painter->setFont(labelFont);
+    QString label = QString("%1 (%2)").arg(m_backendStrip->getName())
+                                      .arg(m_backendStrip->getPixelCount());
+    painter->drawText(QRectF(area.left(), area.bottom() + 12, area.width(), 14), Qt::AlignCenter, label);
+
+    if (isSelected()) {
+        drawSelectionIndicator(painter, boundingRect());
+    }
+}
+
+void LedStripGraphicsItem::setupConnectionPoints()
+{
+    m_connectionPoints.clear();
+
+    const QRectF area = pixelArea();
+    const qreal middleY = area.center().y();
+    const qreal middleX = area.center().x();
+
+    struct Placement { QPointF position; ConnectionDirection direction; };
+    const Placement placements[] = {
+        { QPointF(area.left() - 12, middleY), ConnectionDirection::LEFT },   // DIN
+        { QPointF(area.right() + 12, middleY), ConnectionDirection::RIGHT }, // DOUT
+        { QPointF(middleX, area.top() - 12), ConnectionDirection::UP },      // VDD
+        { QPointF(middleX, area.bottom() + 12), ConnectionDirection::DOWN }  // GND
+    };
+
+    for (int terminal = 0; terminal < 4; ++terminal) {
+        ConnectionPoint point;
+        point.position = placements[terminal].position;
+        point.terminalIndex = terminal;
+        point.isOccupied = false;
+        point.connectedNode = nullptr;
+        point.direction = placements[terminal].direction;
+        m_connectionPoints.append(point);
+    }
+}
+
+Component* LedStripGraphicsItem::getBackendComponent() const
+{
+    return m_backendStrip;
+}
+
+QString LedStripGraphicsItem::getComponentType() const
+{
+    return "LedStrip";
+}
+
+QPointF LedStripGraphicsItem::getConnectionPointPosition(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return mapToScene(m_connectionPoints[index].position);
+    }
+    return QPointF();
+}
+
+bool LedStripGraphicsItem::isConnectionPointOccupied(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return m_connectionPoints[index].isOccupied;
+    }
+    return false;
+}
+
+void LedStripGraphicsItem::setConnectionPointOccupied(int index, bool occupied)
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        m_connectionPoints[index].isOccupied = occupied;
+        update();
+    }
+}
+
+int LedStripGraphicsItem::getConnectionPointAt(const QPointF& scenePos) const
+{
+    const qreal connectionRadius = 8.0;
+
+    for (int i = 0; i < m_connectionPoints.size(); ++i) {
+        QPointF pointPos = mapToScene(m_connectionPoints[i].position);
+        if (QLineF(pointPos, scenePos).length() <= connectionRadius) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void LedStripGraphicsItem::onPixelsChanged()
+{
+    // Frames arriving faster than the display refresh collapse into one
+    // image copy at the next paint
+    m_imageDirty = true;
+    update(pixelArea());
+}
+
+QVariant LedStripGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemPositionChange) {
+        emit componentMoved(this);
+    }
+
+    return ComponentGraphicsItem::itemChange(change, value);
+}
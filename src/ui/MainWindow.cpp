@@ -1,10 +1,19 @@
 #include "ui/MainWindow.h"
+#include "ui/CircuitCanvas.h"
+#include "ui/UiDiagnostics.h"
+#include "ui/UiDiagnosticsWidget.h"
+#include "simulation/Circuit.h"
+#include <QDockWidget>
+#include <QGraphicsView>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_circuitCanvas(nullptr)
     , m_componentLibrary(nullptr)
     , m_circuit(nullptr)
+    , m_diagnostics(nullptr)
+    , m_diagnosticsDock(nullptr)
+    , m_diagnosticsAction(nullptr)
 {
     setupUi();
 }
@@ -16,7 +25,40 @@ void MainWindow::setupUi()
     setWindowTitle("Arduino Simulator");
     resize(1200, 800);
     
-    // TODO: Implement UI setup
+    m_circuit = new Circuit(this);
+    m_circuitCanvas = new CircuitCanvas(this);
+    m_circuitCanvas->setCircuit(m_circuit);
+    
+    QGraphicsView *view = new QGraphicsView(m_circuitCanvas, this);
+    view->setDragMode(QGraphicsView::RubberBandDrag);
+    view->setRenderHint(QPainter::Antialiasing);
+    setCentralWidget(view);
+    
+    // TODO: Component library, menus and toolbars
+
+    createDiagnostics();
+}
+
+void MainWindow::createDiagnostics()
+{
+    m_diagnostics = new UiDiagnostics(this);
+    if (m_circuitCanvas) {
+        m_circuitCanvas->setDiagnostics(m_diagnostics);
+    }
+
+    m_diagnosticsDock = new QDockWidget("Diagnostics", this);
+    m_diagnosticsDock->setObjectName("diagnosticsDock");
+    m_diagnosticsDock->setWidget(new UiDiagnosticsWidget(m_diagnostics, m_diagnosticsDock));
+    addDockWidget(Qt::RightDockWidgetArea, m_diagnosticsDock);
+    m_diagnosticsDock->hide();
+
+    // Measuring costs a little, so only while someone is looking
+    connect(m_diagnosticsDock, &QDockWidget::visibilityChanged,
+            m_diagnostics, &UiDiagnostics::setEnabled);
+
+    m_diagnosticsAction = m_diagnosticsDock->toggleViewAction();
+    m_diagnosticsAction->setShortcut(Qt::Key_F12);
+    addAction(m_diagnosticsAction);
 }
 
 void MainWindow::newCircuit() { /* TODO */ }
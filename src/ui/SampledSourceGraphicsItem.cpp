@@ -0,0 +1,169 @@
+#include "ui/SampledSourceGraphicsItem.h"
+#include "core/SampledSource.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QFileInfo>
+#include <QFont>
+#include <QPen>
+#include <QBrush>
+#include <QDebug>
+
+SampledSourceGraphicsItem::SampledSourceGraphicsItem(SampledSource* backendSource, QGraphicsItem* parent)
+    : ComponentGraphicsItem(parent)
+    , m_backendSource(backendSource)
+{
+    if (!m_backendSource) {
+        qWarning() << "SampledSourceGraphicsItem created with null backend source";
+        return;
+    }
+
+    setFlag(QGraphicsItem::ItemIsMovable, true);
+    setFlag(QGraphicsItem::ItemIsSelectable, true);
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+
+    setupConnectionPoints();
+
+    // The value moves with playback; every solve reports a new state
+    connect(m_backendSource, &SampledSource::stateChanged,
+            this, &SampledSourceGraphicsItem::onStateChanged);
+    connect(m_backendSource, &SampledSource::componentChanged,
+            this, &SampledSourceGraphicsItem::onStateChanged);
+}
+
+QRectF SampledSourceGraphicsItem::bodyRect() const
+{
+    return QRectF(0, 0, BodyWidth, BodyHeight);
+}
+
+QRectF SampledSourceGraphicsItem::boundingRect() const
+{
+    // Body plus the terminals on both sides and the label below
+    return bodyRect().adjusted(-16, -4, 16, 18);
+}
+
+void SampledSourceGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option)
+    Q_UNUSED(widget)
+
+    const QRectF body = bodyRect();
+    const bool source = m_backendSource->getMode() == SampledSource::VoltageSource;
+
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(QPen(Qt::black, 2));
+    painter->setBrush(QBrush(QColor(230, 240, 255)));
+    painter->drawRoundedRect(body, 4, 4);
+
+    // Leads from the body to the terminals
+    painter->drawLine(QPointF(body.left() - 12, body.center().y()), QPointF(body.left(), body.center().y()));
+    painter->drawLine(QPointF(body.right(), body.center().y()), QPointF(body.right() + 12, body.center().y()));
+
+    // Present value, then the recording it comes from
+    painter->setPen(QPen(Qt::black, 1));
+    painter->setFont(QFont("Arial", 8, QFont::Bold));
+    QString value = source ? QString("%1 V").arg(m_backendSource->getValue(), 0, 'f', 3)
+                           : QString("%1 Ω").arg(m_backendSource->getValue(), 0, 'g', 4);
+    painter->drawText(body.adjusted(2, 2, -2, -body.height() / 2), Qt::AlignCenter, value);
+
+    painter->setFont(QFont("Arial", 7));
+    QString file = m_backendSource->isLoaded() ? QFileInfo(m_backendSource->getFileName()).fileName()
+                                                : QString("(no file)");
+    painter->drawText(body.adjusted(2, body.height() / 2, -2, -2), Qt::AlignCenter,
+                      painter->fontMetrics().elidedText(file, Qt::ElideMiddle, int(body.width()) - 4));
+
+    painter->drawText(QRectF(body.left(), body.bottom() + 2, body.width(), 14), Qt::AlignCenter,
+                      m_backendSource->getName());
+
+    for (const ConnectionPoint& point : m_connectionPoints) {
+        drawConnectionPoint(painter, point, point.isOccupied);
+    }
+
+    if (isSelected()) {
+        drawSelectionIndicator(painter, boundingRect());
+    }
+}
+
+void SampledSourceGraphicsItem::setupConnectionPoints()
+{
+    m_connectionPoints.clear();
+
+    const QRectF body = bodyRect();
+
+    ConnectionPoint positive;
+    positive.position = QPointF(body.left() - 12, body.center().y());
+    positive.terminalIndex = SampledSource::Positive;
+    positive.isOccupied = false;
+    positive.connectedNode = nullptr;
+    positive.direction = ConnectionDirection::LEFT;
+    m_connectionPoints.append(positive);
+
+    ConnectionPoint negative;
+    negative.position = QPointF(body.right() + 12, body.center().y());
+    negative.terminalIndex = SampledSource::Negative;
+    negative.isOccupied = false;
+    negative.connectedNode = nullptr;
+    negative.direction = ConnectionDirection::RIGHT;
+    m_connectionPoints.append(negative);
+}
+
+Component* SampledSourceGraphicsItem::getBackendComponent() const
+{
+    return m_backendSource;
+}
+
+QString SampledSourceGraphicsItem::getComponentType() const
+{
+    return "SampledSource";
+}
+
+QPointF SampledSourceGraphicsItem::getConnectionPointPosition(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return mapToScene(m_connectionPoints[index].position);
+    }
+    return QPointF();
+}
+
+bool SampledSourceGraphicsItem::isConnectionPointOccupied(int index) const
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        return m_connectionPoints[index].isOccupied;
+    }
+    return false;
+}
+
+void SampledSourceGraphicsItem::setConnectionPointOccupied(int index, bool occupied)
+{
+    if (index >= 0 && index < m_connectionPoints.size()) {
+        m_connectionPoints[index].isOccupied = occupied;
+        update();
+    }
+}
+
+int SampledSourceGraphicsItem::getConnectionPointAt(const QPointF& scenePos) const
+{
+    const qreal connectionRadius = 8.0;
+
+    for (int i = 0; i < m_connectionPoints.size(); ++i) {
+        QPointF pointPos = mapToScene(m_connectionPoints[i].position);
+        if (QLineF(pointPos, scenePos).length() <= connectionRadius) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void SampledSourceGraphicsItem::onStateChanged()
+{
+    update(bodyRect());
+}
+
+QVariant SampledSourceGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if (change == ItemPositionChange) {
+        emit componentMoved(this);
+    }
+
+    return ComponentGraphicsItem::itemChange(change, value);
+}
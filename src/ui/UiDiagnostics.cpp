@@ -0,0 +1,160 @@
+#include "ui/UiDiagnostics.h"
+#include "ui/CircuitCanvas.h"
+#include <QGraphicsItem>
+#include <QTimer>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDebug>
+
+namespace {
+const char *const ItemTypeNames[UiDiagnostics::ItemTypeCount] = {
+    "LED", "Wire", "Arduino"
+};
+}
+
+UiDiagnostics::UiDiagnostics(QObject* parent)
+    : QObject(parent)
+    , m_enabled(false)
+    , m_probeTimer(new QTimer(this))
+    , m_probeIntervalMs(5)
+    , m_lastProbeNs(0)
+    , m_frameStartNs(-1)
+    , m_pendingInputNs(-1)
+{
+    m_clock.start();
+
+    m_probeTimer->setTimerType(Qt::PreciseTimer);
+    m_probeTimer->setInterval(m_probeIntervalMs);
+    connect(m_probeTimer, &QTimer::timeout, this, &UiDiagnostics::probeEventLoop);
+}
+
+const char* UiDiagnostics::itemTypeName(ItemType type)
+{
+    return ItemTypeNames[type];
+}
+
+void UiDiagnostics::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+
+    m_enabled = enabled;
+    m_frameStartNs = -1;
+    m_pendingInputNs = -1;
+
+    if (enabled) {
+        m_lastProbeNs = now();
+        m_probeTimer->start();
+    } else {
+        m_probeTimer->stop();
+    }
+}
+
+void UiDiagnostics::setProbeInterval(int intervalMs)
+{
+    m_probeIntervalMs = qMax(1, intervalMs);
+    m_probeTimer->setInterval(m_probeIntervalMs);
+    m_lastProbeNs = now();
+}
+
+void UiDiagnostics::reset()
+{
+    m_eventLoopLatency.reset();
+    m_frameTime.reset();
+    for (LatencyHistogram& histogram : m_paintTime) {
+        histogram.reset();
+    }
+    m_inputToLed.reset();
+
+    m_lastProbeNs = now();
+    m_pendingInputNs = -1;
+}
+
+void UiDiagnostics::probeEventLoop()
+{
+    // Anything beyond the interval is time the event loop could not get to us
+    qint64 timestamp = now();
+    qint64 drift = timestamp - m_lastProbeNs - qint64(m_probeIntervalMs) * 1000000;
+    m_lastProbeNs = timestamp;
+    m_eventLoopLatency.record(qMax<qint64>(0, drift));
+}
+
+void UiDiagnostics::markInput()
+{
+    if (m_enabled) {
+        m_pendingInputNs = now();
+    }
+}
+
+void UiDiagnostics::beginFrame()
+{
+    if (m_enabled) {
+        m_frameStartNs = now();
+    }
+}
+
+void UiDiagnostics::endFrame()
+{
+    if (m_enabled && m_frameStartNs >= 0) {
+        m_frameTime.record(now() - m_frameStartNs);
+        m_frameStartNs = -1;
+    }
+}
+
+void UiDiagnostics::recordPaint(ItemType type, qint64 ns)
+{
+    if (m_enabled) {
+        m_paintTime[type].record(ns);
+    }
+}
+
+void UiDiagnostics::ledRepainted()
+{
+    if (!m_enabled || m_pendingInputNs < 0) {
+        return;
+    }
+
+    qint64 latency = now() - m_pendingInputNs;
+    if (latency <= qint64(InputTimeoutMs) * 1000000) {
+        m_inputToLed.record(latency);
+    }
+    m_pendingInputNs = -1;
+}
+
+UiDiagnostics* UiDiagnostics::forItem(const QGraphicsItem* item)
+{
+    CircuitCanvas* canvas = item ? qobject_cast<CircuitCanvas*>(item->scene()) : nullptr;
+    UiDiagnostics* diagnostics = canvas ? canvas->getDiagnostics() : nullptr;
+    return diagnostics && diagnostics->isEnabled() ? diagnostics : nullptr;
+}
+
+QJsonObject UiDiagnostics::toJson() const
+{
+    QJsonObject paint;
+    for (int i = 0; i < ItemTypeCount; ++i) {
+        paint[ItemTypeNames[i]] = m_paintTime[i].toJson();
+    }
+
+    QJsonObject json;
+    json["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    json["probeIntervalMs"] = m_probeIntervalMs;
+    json["eventLoopLatency"] = m_eventLoopLatency.toJson();
+    json["frameTime"] = m_frameTime.toJson();
+    json["paintTime"] = paint;
+    json["inputToLed"] = m_inputToLed.toJson();
+    return json;
+}
+
+bool UiDiagnostics::exportJson(const QString& fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write UI diagnostics to" << fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
@@ -0,0 +1,139 @@
+#include "ui/UiDiagnosticsWidget.h"
+#include "ui/UiDiagnostics.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QPainter>
+#include <QTimer>
+
+namespace {
+
+QString formatNs(qint64 ns)
+{
+    if (ns >= 1000000) {
+        return QString("%1 ms").arg(ns / 1e6, 0, 'f', 1);
+    }
+    return QString("%1 us").arg(ns / 1e3, 0, 'f', 0);
+}
+
+// Bar chart of one histogram over its occupied bucket range
+class HistogramView : public QWidget
+{
+public:
+    HistogramView(const QString& title, const LatencyHistogram* histogram, QWidget* parent)
+        : QWidget(parent)
+        , m_title(title)
+        , m_histogram(histogram)
+    {
+        setMinimumSize(240, 90);
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), palette().base());
+
+        const LatencyHistogram& histogram = *m_histogram;
+        QString summary = histogram.getCount() == 0
+            ? QString("%1: no samples").arg(m_title)
+            : QString("%1: n=%2  p50 %3  p99 %4  max %5")
+                  .arg(m_title)
+                  .arg(histogram.getCount())
+                  .arg(formatNs(histogram.percentile(0.50)))
+                  .arg(formatNs(histogram.percentile(0.99)))
+                  .arg(formatNs(histogram.getMax()));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(rect().adjusted(4, 2, -4, -2), Qt::AlignTop | Qt::AlignLeft, summary);
+
+        if (histogram.getCount() == 0) {
+            return;
+        }
+
+        int first = LatencyHistogram::bucketFor(histogram.getMin());
+        int last = LatencyHistogram::bucketFor(histogram.getMax());
+        quint64 tallest = 1;
+        for (int i = first; i <= last; ++i) {
+            tallest = qMax(tallest, histogram.getBucketCount(i));
+        }
+
+        QRectF plot = QRectF(rect()).adjusted(4, 20, -4, -4);
+        qreal barWidth = plot.width() / (last - first + 1);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(palette().color(QPalette::Highlight));
+        for (int i = first; i <= last; ++i) {
+            qreal height = plot.height() * histogram.getBucketCount(i) / tallest;
+            painter.drawRect(QRectF(plot.left() + (i - first) * barWidth, plot.bottom() - height,
+                                    qMax<qreal>(1.0, barWidth - 1.0), height));
+        }
+    }
+
+private:
+    QString m_title;
+    const LatencyHistogram* m_histogram;
+};
+
+}
+
+UiDiagnosticsWidget::UiDiagnosticsWidget(UiDiagnostics* diagnostics, QWidget* parent)
+    : QWidget(parent)
+    , m_diagnostics(diagnostics)
+    , m_refreshTimer(new QTimer(this))
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    addHistogram("Event-loop latency", &diagnostics->getEventLoopLatency());
+    addHistogram("Frame time", &diagnostics->getFrameTime());
+    addHistogram("Input to LED", &diagnostics->getInputToLed());
+    for (int i = 0; i < UiDiagnostics::ItemTypeCount; ++i) {
+        UiDiagnostics::ItemType type = static_cast<UiDiagnostics::ItemType>(i);
+        addHistogram(QString("Paint %1").arg(UiDiagnostics::itemTypeName(type)),
+                     &diagnostics->getPaintTime(type));
+    }
+
+    QHBoxLayout* buttons = new QHBoxLayout();
+    QPushButton* resetButton = new QPushButton("Reset", this);
+    QPushButton* exportButton = new QPushButton("Export...", this);
+    buttons->addStretch();
+    buttons->addWidget(resetButton);
+    buttons->addWidget(exportButton);
+    layout->addLayout(buttons);
+
+    connect(resetButton, &QPushButton::clicked, this, [this]() {
+        m_diagnostics->reset();
+        refresh();
+    });
+    connect(exportButton, &QPushButton::clicked, this, &UiDiagnosticsWidget::exportResults);
+
+    m_refreshTimer->setInterval(250);
+    connect(m_refreshTimer, &QTimer::timeout, this, &UiDiagnosticsWidget::refresh);
+    m_refreshTimer->start();
+}
+
+void UiDiagnosticsWidget::addHistogram(const QString& title, const LatencyHistogram* histogram)
+{
+    HistogramView* view = new HistogramView(title, histogram, this);
+    static_cast<QVBoxLayout*>(layout())->addWidget(view);
+    m_views.append(view);
+}
+
+void UiDiagnosticsWidget::refresh()
+{
+    if (!isVisible()) {
+        return;
+    }
+    for (QWidget* view : m_views) {
+        view->update();
+    }
+}
+
+void UiDiagnosticsWidget::exportResults()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Export UI Diagnostics",
+                                                    "ui_diagnostics.json",
+                                                    "JSON files (*.json)");
+    if (!fileName.isEmpty()) {
+        m_diagnostics->exportJson(fileName);
+    }
+}
@@ -1,5 +1,6 @@
 #include "ui/WireGraphicsItem.h"
 #include "ui/ComponentGraphicsItem.h"
+#include "ui/UiDiagnostics.h"
 #include "core/Wire.h"
 #include <QPainter>
 #include <QPen>
@@ -15,6 +16,7 @@ WireGraphicsItem::WireGraphicsItem(QGraphicsItem* parent)
     , m_endComponent(nullptr)
     , m_startTerminal(-1)
     , m_endTerminal(-1)
+    , m_busWidth(1)
     , m_routingStyle(ORTHOGONAL)
     , m_wireWidth(2.0)
     , m_isHighlighted(false)
@@ -51,8 +53,9 @@ QRectF WireGraphicsItem::boundingRect() const
     // Calculate bounding rectangle from wire path
     QRectF bounds = m_wirePath.boundingRect();
     
-    // Add padding for wire width and selection indicators
-    qreal padding = qMax(m_wireWidth, 5.0) + 2.0;
+    // Add padding for wire width and selection indicators, and for the
+    // width label of a bus
+    qreal padding = qMax(m_wireWidth, 5.0) + (isBus() ? 16.0 : 2.0);
     return bounds.adjusted(-padding, -padding, padding, padding);
 }
 
@@ -61,6 +64,8 @@ void WireGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
     Q_UNUSED(option)
     Q_UNUSED(widget)
     
+    PaintTimer paintTimer(this, UiDiagnostics::WireItem);
+    
     if (m_wirePath.isEmpty()) {
         return;
     }
@@ -83,11 +88,16 @@ void WireGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
         }
     }
     
-    // Draw main wire path
-    QPen wirePen(wireColor, m_wireWidth, penStyle, Qt::RoundCap, Qt::RoundJoin);
+    // Draw main wire path; a bus is one thicker stroke for all its lines
+    qreal width = isBus() ? m_wireWidth * 2 : m_wireWidth;
+    QPen wirePen(wireColor, width, penStyle, Qt::RoundCap, Qt::RoundJoin);
     painter->setPen(wirePen);
     painter->drawPath(m_wirePath);
     
+    if (isBus()) {
+        drawBusMarker(painter);
+    }
+    
     // Draw current flow indication
     if (m_showCurrentFlow && m_currentMagnitude > 0.001) {
         drawCurrentFlow(painter);
@@ -161,6 +171,16 @@ void WireGraphicsItem::setBackendWire(Wire* wire)
     }
 }
 
+void WireGraphicsItem::setBusWidth(int width)
+{
+    width = qMax(1, width);
+    if (m_busWidth != width) {
+        prepareGeometryChange();
+        m_busWidth = width;
+        update();
+    }
+}
+
 void WireGraphicsItem::connectToComponents(ComponentGraphicsItem* startComp, int startTerm,
                                          ComponentGraphicsItem* endComp, int endTerm)
 {
@@ -180,15 +200,15 @@ void WireGraphicsItem::connectToComponents(ComponentGraphicsItem* startComp, int
                 this, &WireGraphicsItem::updateFromComponents);
         
         // Mark connection points as occupied
-        m_startComponent->setConnectionPointOccupied(m_startTerminal, true);
-        m_endComponent->setConnectionPointOccupied(m_endTerminal, true);
+        setLinesOccupied(m_startComponent, m_startTerminal, true);
+        setLinesOccupied(m_endComponent, m_endTerminal, true);
         
         // Update wire endpoints from components
         updateFromComponents();
         
         qDebug() << "Wire connected between" << m_startComponent->getComponentName() 
                  << "terminal" << m_startTerminal << "and" << m_endComponent->getComponentName()
-                 << "terminal" << m_endTerminal;
+                 << "terminal" << m_endTerminal << "with" << m_busWidth << "lines";
     }
 }
 
@@ -405,11 +425,54 @@ void WireGraphicsItem::drawElectricalInfo(QPainter* painter)
     painter->drawText(textRect, Qt::AlignLeft, info);
 }
 
+void WireGraphicsItem::drawBusMarker(QPainter* painter)
+{
+    // Slash across the bus with the line count next to it
+    QPointF midPoint = m_wirePath.pointAtPercent(0.5);
+    qreal angle = m_wirePath.angleAtPercent(0.5);
+
+    painter->save();
+    painter->translate(midPoint);
+    painter->rotate(-angle);
+    painter->drawLine(QPointF(-4, 6), QPointF(4, -6));
+    painter->restore();
+
+    painter->setFont(QFont("Arial", 7));
+    painter->drawText(midPoint + QPointF(6, -6), QString::number(m_busWidth));
+}
+
+QPointF WireGraphicsItem::groupPosition(ComponentGraphicsItem* component, int firstTerminal) const
+{
+    QPointF first = component->getConnectionPointPosition(firstTerminal);
+    if (!isBus()) {
+        return first;
+    }
+    QPointF last = component->getConnectionPointPosition(firstTerminal + m_busWidth - 1);
+    return (first + last) / 2;
+}
+
+void WireGraphicsItem::setEndsOccupied(bool occupied)
+{
+    if (m_startComponent) {
+        setLinesOccupied(m_startComponent, m_startTerminal, occupied);
+    }
+    if (m_endComponent) {
+        setLinesOccupied(m_endComponent, m_endTerminal, occupied);
+    }
+}
+
+void WireGraphicsItem::setLinesOccupied(ComponentGraphicsItem* component, int firstTerminal, bool occupied)
+{
+    for (int line = 0; line < m_busWidth; ++line) {
+        component->setConnectionPointOccupied(firstTerminal + line, occupied);
+    }
+}
+
 void WireGraphicsItem::updateFromComponents()
 {
     if (m_startComponent && m_endComponent) {
-        QPointF newStartPoint = m_startComponent->getConnectionPointPosition(m_startTerminal);
-        QPointF newEndPoint = m_endComponent->getConnectionPointPosition(m_endTerminal);
+        QPointF newStartPoint = groupPosition(m_startComponent, m_startTerminal);
+        QPointF newEndPoint = groupPosition(m_endComponent, m_endTerminal);
         
         setPoints(newStartPoint, newEndPoint);
         
@@ -447,13 +510,13 @@ void WireGraphicsItem::disconnectFromComponents()
 {
     if (m_startComponent) {
         disconnect(m_startComponent, nullptr, this, nullptr);
-        m_startComponent->setConnectionPointOccupied(m_startTerminal, false);
+        setLinesOccupied(m_startComponent, m_startTerminal, false);
         m_startComponent = nullptr;
     }
     
     if (m_endComponent) {
         disconnect(m_endComponent, nullptr, this, nullptr);
-        m_endComponent->setConnectionPointOccupied(m_endTerminal, false);
+        setLinesOccupied(m_endComponent, m_endTerminal, false);
         m_endComponent = nullptr;
     }
     